@@ -0,0 +1,395 @@
+//------------------------------------------------------------------------------
+//! @file Benchmark.cpp
+//! @brief Definition file of the CBenchmark class
+//! @author Fabrice Cochet
+//! @version 1.0
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Include(s) :
+
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+
+#include "Benchmark.h"
+#include "EdgeDetection.h"
+#include "OpMorphoMaths.h"
+#include "RegionDetection.h"
+#include "qmath.h"
+
+
+//------------------------------------------------------------------------------
+// Public Method(s):
+
+//------------------------------------------------------------------------------
+//! Run the benchmark
+//!
+//! @param filename The image file (empty for the synthetic image)
+//!
+//! @return 0 if OK
+//! @return <>0 otherwise (the image can not be read)
+//------------------------------------------------------------------------------
+int CBenchmark::run(const QString &filename)
+{
+    QImage image;
+
+    if (filename.isEmpty())
+        createImage(&image);
+    else
+        image = QImage(filename).convertToFormat(QImage::Format_RGB32);
+
+    if (image.isNull())
+    {
+        std::fprintf(stderr, "Can not read the image %s\n", filename.toLocal8Bit().constData());
+        return 1;
+    }
+
+    std::printf("Image %dx%d, best of %d runs, %d cores\n", image.width(), image.height(), BENCHMARK_REPETITIONS, CParallel::getIdealThreadCount());
+    checkOpMorphoMaths(&image);
+    benchmarkOpMorphoMaths(&image);
+    benchmarkHoughLine(&image);
+    benchmarkHoughMultiresolution(&image);
+
+    return 0;
+}
+
+
+//------------------------------------------------------------------------------
+// Private Method(s):
+
+//------------------------------------------------------------------------------
+//! Create the synthetic image: a noisy gradient crossed by a few bright lines
+//! and circles, the noise coming from a fixed linear congruential generator
+//! so that the image is identical on every machine
+//!
+//! @param imageOut The created image
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CBenchmark::createImage(QImage *imageOut)
+{
+    quint32 seed = 1;
+    int     level;
+    int     dx;
+    int     dy;
+
+    *imageOut = QImage(BENCHMARK_IMAGE_WIDTH, BENCHMARK_IMAGE_HEIGHT, QImage::Format_RGB32);
+    for (int y = 0; y < BENCHMARK_IMAGE_HEIGHT; y++)
+    {
+        for (int x = 0; x < BENCHMARK_IMAGE_WIDTH; x++)
+        {
+            seed  = seed * 1664525u + 1013904223u;
+            level = 64 * (x + y) / (BENCHMARK_IMAGE_WIDTH + BENCHMARK_IMAGE_HEIGHT) + static_cast<int>(seed >> 27);
+
+            // Lines x + 2y = c, 3x - y = c and y = c
+            if ((((x + 2 * y) % 512) < 2) || (((3 * x - y + 4096) % 768) < 2) || ((y % 640) == 320))
+                level = 255;
+
+            // Circles of radius 100 on a grid of step 400
+            dx = (x % 400) - 200;
+            dy = (y % 400) - 200;
+            if (qAbs(dx * dx + dy * dy - 100 * 100) < 200)
+                level = 255;
+
+            imageOut->setPixel(x, y, qRgb(level, level, level));
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Create the edge map of an image: the BENCHMARK_EDGE_PERCENT % of the
+//! pixels with the highest Sobel gradient magnitude are white, the others are
+//! black
+//!
+//! @param image The image
+//! @param imageOut The created edge map
+//!
+//! @return The percentage of white pixels
+//------------------------------------------------------------------------------
+qreal CBenchmark::createEdgeImage(QImage *image, QImage *imageOut)
+{
+    CEdgeDetection   edgeDetection(image);
+    std::vector<int> gradientX;
+    std::vector<int> gradientY;
+    std::vector<int> magnitude;
+    std::vector<int> magnitudeSorted;
+    int              threshold;
+    int              nEdges = 0;
+
+    edgeDetection.computeGradientSobel(CParallel::getIdealThreadCount(), gradientX, gradientY, magnitude);
+    magnitudeSorted = magnitude;
+    std::nth_element(magnitudeSorted.begin(), magnitudeSorted.begin() + magnitudeSorted.size() * (100 - BENCHMARK_EDGE_PERCENT) / 100, magnitudeSorted.end());
+    threshold = qMax(magnitudeSorted[magnitudeSorted.size() * (100 - BENCHMARK_EDGE_PERCENT) / 100], 1);
+
+    *imageOut = QImage(image->size(), QImage::Format_RGB32);
+    for (int y = 0; y < image->height(); y++)
+    {
+        for (int x = 0; x < image->width(); x++)
+        {
+            if (magnitude[y * image->width() + x] >= threshold)
+            {
+                imageOut->setPixel(x, y, qRgb(255, 255, 255));
+                nEdges++;
+            }
+            else
+            {
+                imageOut->setPixel(x, y, qRgb(0, 0, 0));
+            }
+        }
+    }
+
+    return 100.0 * nEdges / qMax(image->width() * image->height(), 1);
+}
+
+
+//------------------------------------------------------------------------------
+//! Time a task: best of BENCHMARK_REPETITIONS runs
+//!
+//! @param task The task
+//!
+//! @return The time (ms)
+//------------------------------------------------------------------------------
+qreal CBenchmark::measure(const std::function<void(void)> &task)
+{
+    QElapsedTimer timer;
+    qreal         time = std::numeric_limits<qreal>::max();
+
+    for (int noRepetition = 0; noRepetition < BENCHMARK_REPETITIONS; noRepetition++)
+    {
+        timer.start();
+        task();
+        time = qMin(time, timer.nsecsElapsed() / 1000000.0);
+    }
+
+    return time;
+}
+
+
+//------------------------------------------------------------------------------
+//! Time a treatment with 1, 2, 4 ... BENCHMARK_MAX_THREADS threads and print
+//! the times and the speed-ups relative to 1 thread
+//!
+//! @param name The name of the treatment
+//! @param task The task, called with the number of threads and returning the
+//!        time (ms) of the treatment
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CBenchmark::runScaling(const char *name, const std::function<qreal(int)> &task)
+{
+    qreal timeReference = 0.0;
+    qreal time;
+
+    std::printf("\n%s\n%8s %12s %8s\n", name, "threads", "time (ms)", "speed-up");
+    for (int nThreads = 1; nThreads <= BENCHMARK_MAX_THREADS; nThreads *= 2)
+    {
+        time = task(nThreads);
+        if (nThreads == 1)
+            timeReference = time;
+        std::printf("%8d %12.1f %8.2f\n", nThreads, time, (time > 0.0) ? timeReference / time : 0.0);
+        std::fflush(stdout);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Check the tiled dilation and erosion of COpMorphoMaths
+//! (BENCHMARK_MAX_THREADS threads, tiles of BENCHMARK_CHECK_TILE pixels so
+//! that the seams are crossed)
+//! against CImageInt::opDilation and CImageInt::opErosion, on the binarized
+//! and on the grayscale top left corner of the image, with a 5x5 square: the
+//! number of differing pixels is printed
+//!
+//! @param image The image
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CBenchmark::checkOpMorphoMaths(QImage *image)
+{
+    const OPMORPHOMATHS_TYPE operationTypes[] = {OPMORPHOMATHS_DILATION, OPMORPHOMATHS_EROSION};
+    QImage                   imageCheck       = image->copy(0, 0, qMin(image->width(), BENCHMARK_CHECK_SIZE), qMin(image->height(), BENCHMARK_CHECK_SIZE));
+    int                      width            = imageCheck.width();
+    int                      height           = imageCheck.height();
+    CImageInt                imageGray(width, height);
+    CImageInt                neighborhood(5, 5);
+    CImageInt *              imageReference;
+    int                      level;
+    int                      nDifferences;
+
+    for (int x = 0; x < neighborhood.getWidth(); x++)
+    {
+        for (int y = 0; y < neighborhood.getHeight(); y++)
+            neighborhood(x, y) = CIMAGEINT_MAX;
+    }
+
+    std::printf("\nTiled operations against CImageInt (%dx%d, 5x5 square, tiles of %d)\n", width, height, BENCHMARK_CHECK_TILE);
+    for (bool isGrayscale : {false, true})
+    {
+        for (int x = 0; x < width; x++)
+        {
+            for (int y = 0; y < height; y++)
+            {
+                level = (299 * qRed(imageCheck.pixel(x, y)) + 587 * qGreen(imageCheck.pixel(x, y)) + 114 * qBlue(imageCheck.pixel(x, y))) / 1000;
+                if (!isGrayscale)
+                    level = (level < 128) ? 0 : CIMAGEINT_MAX;
+                imageGray(x, y) = level;
+            }
+        }
+
+        for (OPMORPHOMATHS_TYPE operationType : operationTypes)
+        {
+            COpMorphoMaths opMorphoMaths(&imageCheck);
+
+            opMorphoMaths.setGrayscale(isGrayscale);
+            opMorphoMaths.setTiling(BENCHMARK_MAX_THREADS, BENCHMARK_CHECK_TILE);
+            opMorphoMaths.computeOpMorphoMaths(operationType, 2, OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_8);
+
+            if (operationType == OPMORPHOMATHS_DILATION)
+                imageReference = imageGray.opDilation(&neighborhood);
+            else
+                imageReference = imageGray.opErosion(&neighborhood);
+
+            nDifferences = 0;
+            for (int x = 0; x < width; x++)
+            {
+                for (int y = 0; y < height; y++)
+                {
+                    if (qRed(opMorphoMaths.getImageTreated()->pixel(x, y)) != imageReference->get(x, y))
+                        nDifferences++;
+                }
+            }
+            delete imageReference;
+
+            std::printf("%-9s %-9s %8d differing pixels\n", isGrayscale ? "grayscale" : "binary", (operationType == OPMORPHOMATHS_DILATION) ? "dilation" : "erosion", nDifferences);
+            std::fflush(stdout);
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Benchmark of the tiled operations of COpMorphoMaths: grayscale opening by
+//! a 11x11 square, with the default tile size
+//!
+//! @param image The image
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CBenchmark::benchmarkOpMorphoMaths(QImage *image)
+{
+    runScaling("Tiled opening (grayscale, 11x11 square)", [image](int nThreads) {
+        COpMorphoMaths opMorphoMaths(image);
+
+        opMorphoMaths.setGrayscale(true);
+        opMorphoMaths.setTiling(nThreads, OPMORPHOMATHS_DEFAULT_TILE_SIZE);
+
+        return measure([&opMorphoMaths]() {
+            opMorphoMaths.computeOpMorphoMaths(OPMORPHOMATHS_OPENING, 5, OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_8);
+        });
+    });
+}
+
+
+//------------------------------------------------------------------------------
+//! Benchmark of the Hough transform of CRegionDetection: exhaustive line
+//! detection (accumulator partitioned by angles, parallel peak search) on the
+//! edge map of the image (see createEdgeImage). Only the votes and the peak
+//! search are timed: the foreground pixels are indexed by a first call, and
+//! the lines are not drawn.
+//!
+//! @param image The image
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CBenchmark::benchmarkHoughLine(QImage *image)
+{
+    QImage edgeImage;
+    qreal  edgePercent = createEdgeImage(image, &edgeImage);
+    char   name[128];
+
+    std::snprintf(name, sizeof(name), "Hough lines (exhaustive, votes and peaks, edge map with %.1f %% of edges)", edgePercent);
+    runScaling(name, [&edgeImage](int nThreads) {
+        CRegionDetection regionDetection(&edgeImage);
+
+        regionDetection.setNumberThreads(nThreads);
+        regionDetection.computeLines();
+
+        return measure([&regionDetection]() {
+            regionDetection.computeLines();
+        });
+    });
+}
+
+
+//------------------------------------------------------------------------------
+//! Benchmark of the multiresolution Hough transform of CRegionDetection
+//! against the exhaustive one (all the threads), for a few and for many
+//! lines: times of the votes and of the peak search (as in
+//! benchmarkHoughLine), number of exhaustive lines found by the
+//! multiresolution mode within BENCHMARK_LINE_ANGLE_TOLERANCE and
+//! BENCHMARK_LINE_DISTANCE_TOLERANCE, and number of exhaustive lines found
+//! exactly (same cell, same votes)
+//!
+//! @param image The image
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CBenchmark::benchmarkHoughMultiresolution(QImage *image)
+{
+    const int        nLinesList[] = {REGIONDETECTION_DEFAULT_NUMBER_LINES, 20, 100};
+    CRegionDetection exhaustive(image);
+    CRegionDetection multiresolution(image);
+    qreal            timeExhaustive;
+    qreal            timeMultiresolution;
+    qreal            angle;
+    int              nMatched;
+    int              nExact;
+
+    exhaustive.setMultiresolution(false);
+    multiresolution.setMultiresolution(true);
+
+    std::printf("\nHough lines, multiresolution against exhaustive (%d threads)\n%8s %14s %14s %8s %8s %8s\n", exhaustive.getNumberThreads(),
+                "lines", "exhaustive", "multires.", "speed-up", "matched", "exact");
+    for (int nLines : nLinesList)
+    {
+        exhaustive.setHough(REGIONDETECTION_DEFAULT_NUMBER_ANGLES, nLines);
+        multiresolution.setHough(REGIONDETECTION_DEFAULT_NUMBER_ANGLES, nLines);
+        exhaustive.computeLines();
+        multiresolution.computeLines();
+        timeExhaustive      = measure([&exhaustive]() { exhaustive.computeLines(); });
+        timeMultiresolution = measure([&multiresolution]() { multiresolution.computeLines(); });
+
+        // theta + pi being the line of angle theta and of distance -rho
+        nMatched = 0;
+        nExact   = 0;
+        for (const SRegionDetectionLine &line : exhaustive.getLines())
+        {
+            for (const SRegionDetectionLine &lineMultiresolution : multiresolution.getLines())
+            {
+                if ((line.rho == lineMultiresolution.rho) && (line.theta == lineMultiresolution.theta) && (line.votes == lineMultiresolution.votes))
+                {
+                    nExact++;
+                    break;
+                }
+            }
+            for (const SRegionDetectionLine &lineMultiresolution : multiresolution.getLines())
+            {
+                angle = qAbs(line.theta - lineMultiresolution.theta) * 180.0 / M_PI;
+                if (((angle <= BENCHMARK_LINE_ANGLE_TOLERANCE) && (qAbs(line.rho - lineMultiresolution.rho) <= BENCHMARK_LINE_DISTANCE_TOLERANCE)) ||
+                    ((qAbs(angle - 180.0) <= BENCHMARK_LINE_ANGLE_TOLERANCE) && (qAbs(line.rho + lineMultiresolution.rho) <= BENCHMARK_LINE_DISTANCE_TOLERANCE)))
+                {
+                    nMatched++;
+                    break;
+                }
+            }
+        }
+
+        std::printf("%8d %11.1f ms %11.1f ms %8.2f %4d/%-3d %4d/%-3d\n", nLines, timeExhaustive, timeMultiresolution,
+                    (timeMultiresolution > 0.0) ? timeExhaustive / timeMultiresolution : 0.0, nMatched, static_cast<int>(exhaustive.getLines().size()),
+                    nExact, static_cast<int>(exhaustive.getLines().size()));
+        std::fflush(stdout);
+    }
+}
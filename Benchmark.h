@@ -0,0 +1,56 @@
+//------------------------------------------------------------------------------
+//! @file Benchmark.h
+//! @brief Header file of the CBenchmark class
+//! @author Fabrice Cochet
+//! @version 1.0
+//------------------------------------------------------------------------------
+
+#ifndef BENCHMARK_HEADER
+#define BENCHMARK_HEADER
+
+//------------------------------------------------------------------------------
+// Include(s) :
+
+#include <QImage>
+#include <QString>
+#include <functional>
+
+
+//------------------------------------------------------------------------------
+// Constant(s) :
+
+const int BENCHMARK_MAX_THREADS  = 32;
+const int BENCHMARK_REPETITIONS  = 3;
+const int BENCHMARK_IMAGE_WIDTH  = 2048;
+const int BENCHMARK_IMAGE_HEIGHT = 2048;
+const int BENCHMARK_CHECK_SIZE   = 256;
+const int BENCHMARK_CHECK_TILE   = 48;
+const int BENCHMARK_EDGE_PERCENT = 10;
+
+const qreal BENCHMARK_LINE_ANGLE_TOLERANCE    = 1.0; // degrees
+const int   BENCHMARK_LINE_DISTANCE_TOLERANCE = 2;
+
+
+//------------------------------------------------------------------------------
+// Classe(s) :
+
+//! Command line benchmark ("--benchmark [image]"): the parallel treatments are
+//! timed with 1, 2, 4 ... BENCHMARK_MAX_THREADS threads, on the given image or
+//! on a synthetic one, and the times and speed-ups are printed
+class CBenchmark
+{
+public:
+    static int run(const QString &filename);
+
+private:
+    static void  createImage(QImage *imageOut);
+    static qreal createEdgeImage(QImage *image, QImage *imageOut);
+    static qreal measure(const std::function<void(void)> &task);
+    static void  runScaling(const char *name, const std::function<qreal(int)> &task);
+    static void  checkOpMorphoMaths(QImage *image);
+    static void  benchmarkOpMorphoMaths(QImage *image);
+    static void  benchmarkHoughLine(QImage *image);
+    static void  benchmarkHoughMultiresolution(QImage *image);
+};
+
+#endif // BENCHMARK_HEADER
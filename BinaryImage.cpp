@@ -0,0 +1,226 @@
+//------------------------------------------------------------------------------
+//! @file BinaryImage.cpp
+//! @brief Definition file of the CBinaryImage class
+//! @author Fabrice Cochet
+//! @version 1.0
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Include(s) :
+
+#include "BinaryImage.h"
+
+
+//------------------------------------------------------------------------------
+// Public Method(s):
+
+//------------------------------------------------------------------------------
+//! CBinaryImage constructor for a given size (all the pixels are set to 0)
+//!
+//! @param width The image width
+//! @param height The image height
+//!
+//! @return The created object
+//------------------------------------------------------------------------------
+CBinaryImage::CBinaryImage(int width, int height)
+{
+    m_width       = qMax(width, 0);
+    m_height      = qMax(height, 0);
+    m_wordsPerRow = (m_width + BINARYIMAGE_WORD_BITS - 1) / BINARYIMAGE_WORD_BITS;
+
+    m_words.assign(static_cast<size_t>(m_wordsPerRow) * m_height, 0);
+}
+
+
+//------------------------------------------------------------------------------
+//! CBinaryImage constructor for a given image (a pixel is set if its value is
+//! not 0)
+//!
+//! @param imageIn The input image
+//!
+//! @return The created object
+//------------------------------------------------------------------------------
+CBinaryImage::CBinaryImage(CImageInt *imageIn)
+    : CBinaryImage(imageIn ? imageIn->getWidth() : 0, imageIn ? imageIn->getHeight() : 0)
+{
+    quint64 *row;
+
+    for (int y = 0; y < m_height; y++)
+    {
+        row = getRow(y);
+        for (int x = 0; x < m_width; x++)
+        {
+            if (imageIn->get(x, y) != 0)
+                row[x / BINARYIMAGE_WORD_BITS] |= static_cast<quint64>(1) << (x % BINARYIMAGE_WORD_BITS);
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Destructor
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+CBinaryImage::~CBinaryImage(void)
+{
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the image width
+//!
+//! @param _
+//!
+//! @return The width
+//------------------------------------------------------------------------------
+int CBinaryImage::getWidth(void)
+{
+    return m_width;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the image height
+//!
+//! @param _
+//!
+//! @return The height
+//------------------------------------------------------------------------------
+int CBinaryImage::getHeight(void)
+{
+    return m_height;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the number of 64 bits words of a row
+//!
+//! @param _
+//!
+//! @return The number of words
+//------------------------------------------------------------------------------
+int CBinaryImage::getWordsPerRow(void)
+{
+    return m_wordsPerRow;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the mask of the valid bits of the last word of a row
+//!
+//! @param _
+//!
+//! @return The mask
+//------------------------------------------------------------------------------
+quint64 CBinaryImage::getLastWordMask(void)
+{
+    int nBits = m_width % BINARYIMAGE_WORD_BITS;
+
+    if (nBits == 0)
+        return ~static_cast<quint64>(0);
+
+    return (static_cast<quint64>(1) << nBits) - 1;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the words of a row
+//!
+//! @param y The row index
+//!
+//! @return A pointer on the first word of the row
+//! @return nullptr if the row is outside the image
+//------------------------------------------------------------------------------
+quint64 *CBinaryImage::getRow(int y)
+{
+    if ((y < 0) || (y >= m_height) || (m_wordsPerRow == 0))
+        return nullptr;
+
+    return &m_words[static_cast<size_t>(y) * m_wordsPerRow];
+}
+
+
+//------------------------------------------------------------------------------
+//! Get a pixel value
+//!
+//! @param x The X coordinate
+//! @param y The Y coordinate
+//!
+//! @return The pixel value (false outside the image)
+//------------------------------------------------------------------------------
+bool CBinaryImage::get(int x, int y)
+{
+    if ((x < 0) || (x >= m_width) || (y < 0) || (y >= m_height))
+        return false;
+
+    return (getRow(y)[x / BINARYIMAGE_WORD_BITS] >> (x % BINARYIMAGE_WORD_BITS)) & 1;
+}
+
+
+//------------------------------------------------------------------------------
+//! Set a pixel value
+//!
+//! @param x The X coordinate
+//! @param y The Y coordinate
+//! @param value The value to set
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CBinaryImage::set(int x, int y, bool value)
+{
+    quint64 bit;
+
+    if ((x >= 0) && (x < m_width) && (y >= 0) && (y < m_height))
+    {
+        bit = static_cast<quint64>(1) << (x % BINARYIMAGE_WORD_BITS);
+
+        if (value)
+            getRow(y)[x / BINARYIMAGE_WORD_BITS] |= bit;
+        else
+            getRow(y)[x / BINARYIMAGE_WORD_BITS] &= ~bit;
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Set all the pixels to 0
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CBinaryImage::reset(void)
+{
+    std::fill(m_words.begin(), m_words.end(), 0);
+}
+
+
+//------------------------------------------------------------------------------
+//! Unpack the image into a CImageInt (0 or CIMAGEINT_MAX)
+//!
+//! @param imageOut The output image
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CBinaryImage::toCImage(CImageInt *imageOut)
+{
+    quint64 *row;
+
+    if (imageOut)
+    {
+        for (int y = 0; y < qMin(m_height, imageOut->getHeight()); y++)
+        {
+            row = getRow(y);
+            for (int x = 0; x < qMin(m_width, imageOut->getWidth()); x++)
+            {
+                if ((row[x / BINARYIMAGE_WORD_BITS] >> (x % BINARYIMAGE_WORD_BITS)) & 1)
+                    (*imageOut)(x, y) = CIMAGEINT_MAX;
+                else
+                    (*imageOut)(x, y) = 0;
+            }
+        }
+    }
+}
@@ -0,0 +1,56 @@
+//------------------------------------------------------------------------------
+//! @file BinaryImage.h
+//! @brief Header file of the CBinaryImage class
+//! @author Fabrice Cochet
+//! @version 1.0
+//------------------------------------------------------------------------------
+
+#ifndef BINARY_IMAGE_HEADER
+#define BINARY_IMAGE_HEADER
+
+//------------------------------------------------------------------------------
+// Include(s) :
+
+#include <QtGlobal>
+#include <vector>
+
+#include "../../Commun/Image/cimage.h"
+
+
+//------------------------------------------------------------------------------
+// Constant(s) :
+
+const int BINARYIMAGE_WORD_BITS = 64;
+
+
+//------------------------------------------------------------------------------
+// Classe(s) :
+
+//! Binary image packed 64 pixels per word along X (bit i of the word w of a
+//! row is the pixel x = 64 * w + i). The padding bits of the last word of a
+//! row are always kept to 0.
+class CBinaryImage
+{
+public:
+    CBinaryImage(int width, int height);
+    CBinaryImage(CImageInt *imageIn);
+    ~CBinaryImage(void);
+
+    int      getWidth(void);
+    int      getHeight(void);
+    int      getWordsPerRow(void);
+    quint64  getLastWordMask(void);
+    quint64 *getRow(int y);
+    bool     get(int x, int y);
+    void     set(int x, int y, bool value);
+    void     reset(void);
+    void     toCImage(CImageInt *imageOut);
+
+private:
+    int                  m_width;
+    int                  m_height;
+    int                  m_wordsPerRow;
+    std::vector<quint64> m_words;
+};
+
+#endif // BINARY_IMAGE_HEADER
@@ -76,10 +76,7 @@ void CColorModel::computeComponentY(void)
             {
                 for (int y = 0; y < m_imageOrigin->height(); y++)
                 {
-                    Y = (299 * qRed(m_imageOrigin->pixel(x, y)) +
-                         587 * qGreen(m_imageOrigin->pixel(x, y)) +
-                         114 * qBlue(m_imageOrigin->pixel(x, y))) /
-                        1000;
+                    Y = computeY(m_imageOrigin->pixel(x, y));
                     m_imageTreated->setPixel(x, y, qRgb(Y, Y, Y));
                 }
             }
@@ -110,17 +107,7 @@ void CColorModel::computeComponentU(void)
             {
                 for (int y = 0; y < m_imageOrigin->height(); y++)
                 {
-                    U = (436 * qBlue(m_imageOrigin->pixel(x, y)) -
-                         147 * qRed(m_imageOrigin->pixel(x, y)) -
-                         289 * qGreen(m_imageOrigin->pixel(x, y))) /
-                        1000;
-                    U = (U + 111) * 115 / 100;
-
-                    if (U > 255)
-                        U = 255;
-                    if (U < 0)
-                        U = 0;
-
+                    U = computeU(m_imageOrigin->pixel(x, y));
                     m_imageTreated->setPixel(x, y, qRgb(U, U, U));
                 }
             }
@@ -150,21 +137,67 @@ void CColorModel::computeComponentV(void)
             {
                 for (int y = 0; y < m_imageOrigin->height(); y++)
                 {
-                    V = (615 * qRed(m_imageOrigin->pixel(x, y)) -
-                         515 * qGreen(m_imageOrigin->pixel(x, y)) -
-                         100 * qBlue(m_imageOrigin->pixel(x, y))) /
-                        1000;
-
-                    V = (V + 157) * 81 / 100;
-
-                    if (V > 255)
-                        V = 255;
-                    if (V < 0)
-                        V = 0;
-
+                    V = computeV(m_imageOrigin->pixel(x, y));
                     m_imageTreated->setPixel(x, y, qRgb(V, V, V));
                 }
             }
         }
     }
 }
+
+
+//------------------------------------------------------------------------------
+//! Compute the Y part (luminance) of a color
+//!
+//! @param rgb The color
+//!
+//! @return Y in [0, 255]
+//------------------------------------------------------------------------------
+int CColorModel::computeY(QRgb rgb)
+{
+    return (299 * qRed(rgb) + 587 * qGreen(rgb) + 114 * qBlue(rgb)) / 1000;
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the U part (blue difference) of a color, scaled to [0, 255]
+//!
+//! @param rgb The color
+//!
+//! @return U in [0, 255]
+//------------------------------------------------------------------------------
+int CColorModel::computeU(QRgb rgb)
+{
+    int U = (436 * qBlue(rgb) - 147 * qRed(rgb) - 289 * qGreen(rgb)) / 1000;
+
+    U = (U + 111) * 115 / 100;
+
+    if (U > 255)
+        U = 255;
+    if (U < 0)
+        U = 0;
+
+    return U;
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the V part (red difference) of a color, scaled to [0, 255]
+//!
+//! @param rgb The color
+//!
+//! @return V in [0, 255]
+//------------------------------------------------------------------------------
+int CColorModel::computeV(QRgb rgb)
+{
+    int V = (615 * qRed(rgb) - 515 * qGreen(rgb) - 100 * qBlue(rgb)) / 1000;
+
+    V = (V + 157) * 81 / 100;
+
+    if (V > 255)
+        V = 255;
+    if (V < 0)
+        V = 0;
+
+    return V;
+}
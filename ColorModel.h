@@ -28,6 +28,10 @@ public:
     void    computeComponentU(void);
     void    computeComponentV(void);
 
+    static int computeY(QRgb rgb);
+    static int computeU(QRgb rgb);
+    static int computeV(QRgb rgb);
+
 private:
     QImage *m_imageOrigin;
     QImage *m_imageTreated;
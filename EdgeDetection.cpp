@@ -11,6 +11,7 @@
 #include <qmath.h>
 
 #include "EdgeDetection.h"
+#include "Parallel.h"
 
 
 //------------------------------------------------------------------------------
@@ -268,6 +269,47 @@ void CEdgeDetection::computeEdgeDetection(int detectionType, int thresholdMin, i
 }
 
 
+//------------------------------------------------------------------------------
+//! Compute the Sobel gradient of the grayscale image (the masks of the Sobel
+//! edge detection, divided by 4), the rows being split between the threads.
+//! The border pixels have a null gradient.
+//!
+//! @param nThreads The number of threads
+//! @param gradientXOut The horizontal derivative (y * width + x), positive
+//!                     towards the right
+//! @param gradientYOut The vertical derivative (y * width + x), positive
+//!                     downwards
+//! @param magnitudeOut The magnitude of the gradient (y * width + x)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CEdgeDetection::computeGradientSobel(int nThreads, std::vector<int> &gradientXOut, std::vector<int> &gradientYOut, std::vector<int> &magnitudeOut)
+{
+    int width  = m_isValid ? m_imageOrigin->width() : 0;
+    int height = m_isValid ? m_imageOrigin->height() : 0;
+
+    gradientXOut.assign(static_cast<size_t>(width) * height, 0);
+    gradientYOut.assign(static_cast<size_t>(width) * height, 0);
+    magnitudeOut.assign(static_cast<size_t>(width) * height, 0);
+    CParallel::run(qMax(height - 2, 0), nThreads, [&](int noRow) {
+        int y = noRow + 1;
+        int gX;
+        int gY;
+
+        for (int x = 1; x < width - 1; x++)
+        {
+            // The first mask derives from right to left
+            gX = -convolution(m_imageGray, x, y, sobelMatrix1, 4);
+            gY = convolution(m_imageGray, x, y, sobelMatrix2, 4);
+
+            gradientXOut[y * width + x] = gX;
+            gradientYOut[y * width + x] = gY;
+            magnitudeOut[y * width + x] = static_cast<int>(qSqrt(gX * gX + gY * gY));
+        }
+    });
+}
+
+
 //------------------------------------------------------------------------------
 // Private Method(s):
 
@@ -12,6 +12,7 @@
 // Include(s) :
 
 #include <QImage>
+#include <vector>
 
 #include "../../Commun/Image/cimage.h"
 
@@ -54,6 +55,7 @@ public:
     void    setThresholdMax(int threshold);
     void    setAlphaDeriche(float alpha);
     void    computeEdgeDetection(int detectionType, int thresholdMin, int thresholdMax, int isMonochrom);
+    void    computeGradientSobel(int nThreads, std::vector<int> &gradientXOut, std::vector<int> &gradientYOut, std::vector<int> &magnitudeOut);
 
 private:
     QImage *   m_imageOrigin;
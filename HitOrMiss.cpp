@@ -0,0 +1,380 @@
+//------------------------------------------------------------------------------
+//! @file HitOrMiss.cpp
+//! @brief Definition file of the CHitOrMiss class
+//! @author Fabrice Cochet
+//! @version 1.0
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Include(s) :
+
+#include "HitOrMiss.h"
+
+
+//------------------------------------------------------------------------------
+// Local Function(s):
+
+//------------------------------------------------------------------------------
+//! Extract n consecutive pixels of a packed row, starting at x0 (the pixels
+//! outside the row are read as 0)
+//!
+//! @param row The packed row (nullptr for a row outside the image)
+//! @param nWords The number of words of the row
+//! @param x0 The first pixel to extract (may be negative)
+//! @param n The number of pixels to extract (< 64)
+//!
+//! @return The pixels, x0 being the bit 0
+//------------------------------------------------------------------------------
+static inline quint64 extractBits(const quint64 *row, int nWords, int x0, int n)
+{
+    quint64 bits = 0;
+    int     shift = 0;
+    int     word;
+    int     offset;
+
+    if (!row)
+        return 0;
+
+    if (x0 < 0)
+    {
+        shift = -x0;
+        x0    = 0;
+    }
+
+    word   = x0 / BINARYIMAGE_WORD_BITS;
+    offset = x0 % BINARYIMAGE_WORD_BITS;
+    if (word < nWords)
+    {
+        bits = row[word] >> offset;
+        if (offset && (word + 1 < nWords))
+            bits |= row[word + 1] << (BINARYIMAGE_WORD_BITS - offset);
+    }
+
+    return (bits << shift) & ((static_cast<quint64>(1) << n) - 1);
+}
+
+
+//------------------------------------------------------------------------------
+//! Read one pixel of a packed row (the pixels outside the row are read as 0)
+//!
+//! @param row The packed row (nullptr for a row outside the image)
+//! @param width The row width
+//! @param x The pixel to read
+//!
+//! @return The pixel (0 or 1)
+//------------------------------------------------------------------------------
+static inline quint32 readBit(const quint64 *row, int width, int x)
+{
+    if (!row || (x < 0) || (x >= width))
+        return 0;
+
+    return (row[x / BINARYIMAGE_WORD_BITS] >> (x % BINARYIMAGE_WORD_BITS)) & 1;
+}
+
+
+//------------------------------------------------------------------------------
+// Public Method(s):
+
+//------------------------------------------------------------------------------
+//! CHitOrMiss constructor (no template)
+//!
+//! @param _
+//!
+//! @return The created object
+//------------------------------------------------------------------------------
+CHitOrMiss::CHitOrMiss(void)
+{
+    m_lut.assign(HITORMISS_LUT_SIZE, 0);
+    m_lutTemplates = 0;
+    m_isLutValid   = false;
+}
+
+
+//------------------------------------------------------------------------------
+//! Destructor
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+CHitOrMiss::~CHitOrMiss(void)
+{
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the number of templates
+//!
+//! @param _
+//!
+//! @return The number of templates
+//------------------------------------------------------------------------------
+int CHitOrMiss::getNumberTemplates(void)
+{
+    return static_cast<int>(m_templates.size());
+}
+
+
+//------------------------------------------------------------------------------
+//! Add a template built from a neighborhood: the set pixels of the
+//! neighborhood must be hit and the other ones must be missed (same template
+//! as the erosion / local complementary erosion version)
+//!
+//! @param neighborhood The neighborhood (square with an odd size)
+//!
+//! @return true if OK
+//! @return false otherwise
+//------------------------------------------------------------------------------
+bool CHitOrMiss::addTemplate(CImageInt *neighborhood)
+{
+    bool ret = false;
+
+    if (neighborhood)
+    {
+        CImageInt missMask(neighborhood->getWidth(), neighborhood->getHeight());
+
+        for (int x = 0; x < neighborhood->getWidth(); x++)
+        {
+            for (int y = 0; y < neighborhood->getHeight(); y++)
+                missMask(x, y) = (neighborhood->get(x, y) == 0) ? CIMAGEINT_MAX : 0;
+        }
+
+        ret = addTemplate(neighborhood, &missMask);
+    }
+
+    return ret;
+}
+
+
+//------------------------------------------------------------------------------
+//! Add a template defined by its hit and miss masks
+//!
+//! @param hitMask The pixels which must be set (square with an odd size)
+//! @param missMask The pixels which must not be set (same size, may be nullptr)
+//!
+//! @return true if OK
+//! @return false otherwise (invalid size or too many templates)
+//------------------------------------------------------------------------------
+bool CHitOrMiss::addTemplate(CImageInt *hitMask, CImageInt *missMask)
+{
+    SHitOrMissTemplate hitOrMissTemplate;
+    int                size;
+    bool               ret = false;
+
+    if (hitMask && (getNumberTemplates() < HITORMISS_MAX_TEMPLATES))
+    {
+        size = hitMask->getWidth();
+
+        if ((size == hitMask->getHeight()) &&
+            (size % 2 == 1) &&
+            (size / 2 <= HITORMISS_MAX_RADIUS) &&
+            (!missMask || ((missMask->getWidth() == size) && (missMask->getHeight() == size))))
+        {
+            ret                      = true;
+            hitOrMissTemplate.radius = size / 2;
+            hitOrMissTemplate.hitRows.assign(size, 0);
+            hitOrMissTemplate.missRows.assign(size, 0);
+
+            for (int y = 0; y < size; y++)
+            {
+                for (int x = 0; x < size; x++)
+                {
+                    if (hitMask->get(x, y) != 0)
+                        hitOrMissTemplate.hitRows[y] |= static_cast<quint64>(1) << x;
+                    else if (missMask && (missMask->get(x, y) != 0))
+                        hitOrMissTemplate.missRows[y] |= static_cast<quint64>(1) << x;
+                }
+            }
+
+            m_templates.push_back(hitOrMissTemplate);
+            m_isLutValid = false;
+        }
+    }
+
+    return ret;
+}
+
+
+//------------------------------------------------------------------------------
+//! Remove all the templates
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CHitOrMiss::clear(void)
+{
+    m_templates.clear();
+    m_isLutValid = false;
+}
+
+
+//------------------------------------------------------------------------------
+//! Apply all the templates in one sweep
+//!
+//! @param imageIn The input image
+//! @param imageOut The output image (set where at least one template matches)
+//! @param matches If not nullptr, receive for each pixel (index y * width + x)
+//!        the mask of the matching templates (bit t for the template t)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CHitOrMiss::compute(CBinaryImage *imageIn, CBinaryImage *imageOut, std::vector<quint32> *matches)
+{
+    int            width;
+    int            height;
+    int            nWords;
+    int            maxRadius = 0;
+    bool           hasBitmaskTemplates;
+    const quint64 *rows[2 * HITORMISS_MAX_RADIUS + 1];
+    const quint64 *rowUp;
+    const quint64 *rowMiddle;
+    const quint64 *rowDown;
+    quint64 *      rowOut;
+    quint32        code;
+    quint32        match;
+
+    if (imageIn && imageOut &&
+        (imageIn->getWidth() == imageOut->getWidth()) &&
+        (imageIn->getHeight() == imageOut->getHeight()))
+    {
+        width  = imageIn->getWidth();
+        height = imageIn->getHeight();
+        nWords = imageIn->getWordsPerRow();
+
+        if (!m_isLutValid)
+            compileLut();
+
+        for (size_t t = 0; t < m_templates.size(); t++)
+            maxRadius = qMax(maxRadius, m_templates[t].radius);
+        hasBitmaskTemplates = (maxRadius > HITORMISS_LUT_RADIUS);
+
+        imageOut->reset();
+        if (matches)
+            matches->assign(static_cast<size_t>(width) * height, 0);
+
+        for (int y = 0; y < height; y++)
+        {
+            for (int dy = -maxRadius; dy <= maxRadius; dy++)
+                rows[dy + maxRadius] = imageIn->getRow(y + dy);
+            rowOut    = imageOut->getRow(y);
+            rowUp     = imageIn->getRow(y - 1);
+            rowMiddle = imageIn->getRow(y);
+            rowDown   = imageIn->getRow(y + 1);
+
+            // 3x3 code of the pixel (-1, y): bit (dy + 1) * 3 + (dx + 1)
+            code = readBit(rowUp, width, 0) << 2 |
+                   readBit(rowMiddle, width, 0) << 5 |
+                   readBit(rowDown, width, 0) << 8;
+
+            for (int x = 0; x < width; x++)
+            {
+                // Slide the window: the columns dx = 0 and dx = 1 become the
+                // columns dx = -1 and dx = 0, then the column x + 1 is read
+                code = ((code >> 1) & 0x0DB) |
+                       readBit(rowUp, width, x + 1) << 2 |
+                       readBit(rowMiddle, width, x + 1) << 5 |
+                       readBit(rowDown, width, x + 1) << 8;
+
+                match = m_lut[code];
+                if (hasBitmaskTemplates)
+                    match |= matchBitmask(rows, maxRadius, nWords, x);
+
+                if (match)
+                {
+                    rowOut[x / BINARYIMAGE_WORD_BITS] |= static_cast<quint64>(1) << (x % BINARYIMAGE_WORD_BITS);
+                    if (matches)
+                        (*matches)[static_cast<size_t>(y) * width + x] = match;
+                }
+            }
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+// Private Method(s):
+
+//------------------------------------------------------------------------------
+//! Compile the templates of radius <= 1 into the lookup table of the 3x3
+//! neighborhood code
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CHitOrMiss::compileLut(void)
+{
+    quint32 hit;
+    quint32 miss;
+    int     offset;
+
+    m_lut.assign(HITORMISS_LUT_SIZE, 0);
+    m_lutTemplates = 0;
+
+    for (size_t t = 0; t < m_templates.size(); t++)
+    {
+        if (m_templates[t].radius <= HITORMISS_LUT_RADIUS)
+        {
+            // Re-center the template in the 3x3 code
+            hit    = 0;
+            miss   = 0;
+            offset = HITORMISS_LUT_RADIUS - m_templates[t].radius;
+            for (int row = 0; row < 2 * m_templates[t].radius + 1; row++)
+            {
+                hit |= static_cast<quint32>(m_templates[t].hitRows[row] << offset) << ((row + offset) * 3);
+                miss |= static_cast<quint32>(m_templates[t].missRows[row] << offset) << ((row + offset) * 3);
+            }
+
+            for (quint32 code = 0; code < HITORMISS_LUT_SIZE; code++)
+            {
+                if (((code & hit) == hit) && ((code & miss) == 0))
+                    m_lut[code] |= static_cast<quint32>(1) << t;
+            }
+
+            m_lutTemplates |= static_cast<quint32>(1) << t;
+        }
+    }
+
+    m_isLutValid = true;
+}
+
+
+//------------------------------------------------------------------------------
+//! Test the templates which are not in the lookup table on a pixel
+//!
+//! @param rows The rows y - rowsRadius ... y + rowsRadius
+//! @param rowsRadius The radius of the rows (at least the templates radius)
+//! @param nWords The number of words of a row
+//! @param x The X coordinate of the pixel
+//!
+//! @return The mask of the matching templates
+//------------------------------------------------------------------------------
+quint32 CHitOrMiss::matchBitmask(const quint64 **rows, int rowsRadius, int nWords, int x)
+{
+    quint32 ret = 0;
+    quint64 bits;
+    int     radius;
+    bool    isMatching;
+
+    for (size_t t = 0; t < m_templates.size(); t++)
+    {
+        if (!(m_lutTemplates & (static_cast<quint32>(1) << t)))
+        {
+            radius     = m_templates[t].radius;
+            isMatching = true;
+
+            for (int dy = -radius; (dy <= radius) && isMatching; dy++)
+            {
+                bits       = extractBits(rows[rowsRadius + dy], nWords, x - radius, 2 * radius + 1);
+                isMatching = ((bits & m_templates[t].hitRows[dy + radius]) == m_templates[t].hitRows[dy + radius]) &&
+                             ((bits & m_templates[t].missRows[dy + radius]) == 0);
+            }
+
+            if (isMatching)
+                ret |= static_cast<quint32>(1) << t;
+        }
+    }
+
+    return ret;
+}
@@ -0,0 +1,74 @@
+//------------------------------------------------------------------------------
+//! @file HitOrMiss.h
+//! @brief Header file of the CHitOrMiss class
+//! @author Fabrice Cochet
+//! @version 1.0
+//------------------------------------------------------------------------------
+
+#ifndef HIT_OR_MISS_HEADER
+#define HIT_OR_MISS_HEADER
+
+//------------------------------------------------------------------------------
+// Include(s) :
+
+#include <QtGlobal>
+#include <vector>
+
+#include "../../Commun/Image/cimage.h"
+#include "BinaryImage.h"
+
+
+//------------------------------------------------------------------------------
+// Constant(s) :
+
+const int HITORMISS_MAX_TEMPLATES = 32;
+const int HITORMISS_MAX_RADIUS    = (BINARYIMAGE_WORD_BITS - 2) / 2;
+const int HITORMISS_LUT_RADIUS    = 1;
+const int HITORMISS_LUT_SIZE      = 512;
+
+
+//------------------------------------------------------------------------------
+// Structure(s) :
+
+//! A hit-or-miss template compiled as one hit mask and one miss mask per row of
+//! its (2 * radius + 1) x (2 * radius + 1) window (bit i is the column
+//! dx = i - radius)
+struct SHitOrMissTemplate
+{
+    int                  radius;
+    std::vector<quint64> hitRows;
+    std::vector<quint64> missRows;
+};
+
+
+//------------------------------------------------------------------------------
+// Classe(s) :
+
+//! Hit-or-miss engine: the templates are compiled once into a 512 entries
+//! lookup table of the 3x3 neighborhood code (radius <= 1) or into row
+//! bitmasks (larger templates), then all of them are evaluated in a single
+//! sweep over a packed binary image. The pixels outside the image are
+//! considered as background.
+class CHitOrMiss
+{
+public:
+    CHitOrMiss(void);
+    ~CHitOrMiss(void);
+
+    int  getNumberTemplates(void);
+    bool addTemplate(CImageInt *neighborhood);
+    bool addTemplate(CImageInt *hitMask, CImageInt *missMask);
+    void clear(void);
+    void compute(CBinaryImage *imageIn, CBinaryImage *imageOut, std::vector<quint32> *matches = nullptr);
+
+private:
+    std::vector<SHitOrMissTemplate> m_templates;
+    std::vector<quint32>            m_lut;
+    quint32                         m_lutTemplates;
+    bool                            m_isLutValid;
+
+    void    compileLut(void);
+    quint32 matchBitmask(const quint64 **rows, int rowsRadius, int nWords, int x);
+};
+
+#endif // HIT_OR_MISS_HEADER
@@ -81,7 +81,28 @@ MainWindow::MainWindow(QWidget *parent)
     QAction *    actionOpMorphoMathsHitOrMiss               = new QAction(tr("&Hit or miss"), this);
     QAction *    actionOpMorphoMathsThinning                = new QAction(tr("&Thinning"), this);
     QAction *    actionOpMorphoMathsSkeletonizing           = new QAction(tr("&Skeletonization"), this);
+    QAction *    actionOpMorphoMathsOpeningByReconstruction = new QAction(tr("&Opening by reconstruction"), this);
+    QAction *    actionOpMorphoMathsHoleFilling             = new QAction(tr("&Hole filling"), this);
+    QAction *    actionOpMorphoMathsRegionalMaxima          = new QAction(tr("&Regional maxima"), this);
+    QAction *    actionOpMorphoMathsAreaOpening             = new QAction(tr("A&rea opening"), this);
+    QAction *    actionOpMorphoMathsAreaClosing             = new QAction(tr("Area c&losing"), this);
+    QAction *    actionOpMorphoMathsAttributeOpening        = new QAction(tr("A&ttribute opening"), this);
+    QAction *    actionOpMorphoMathsAttributeClosing        = new QAction(tr("Attri&bute closing"), this);
+    QAction *    actionOpMorphoMathsGranulometry            = new QAction(tr("Gra&nulometry"), this);
+    QAction *    actionOpMorphoMathsTopHat                  = new QAction(tr("To&p-hat"), this);
+    QAction *    actionOpMorphoMathsBottomHat               = new QAction(tr("Bott&om-hat"), this);
+    QAction *    actionOpMorphoMathsLineOpening             = new QAction(tr("&Line opening"), this);
+    QAction *    actionOpMorphoMathsLineOpeningBank         = new QAction(tr("Line openings (&all orientations)"), this);
+    QAction *    actionOpMorphoMathsRankFilter              = new QAction(tr("Ran&k filter"), this);
     QAction *    actionRegionDetectionLine                  = new QAction(tr("&Line"), this);
+    QAction *    actionRegionDetectionSegment               = new QAction(tr("&Segments"), this);
+    QAction *    actionRegionDetectionCircle                = new QAction(tr("&Circles"), this);
+    QAction *    actionRegionDetectionComponent             = new QAction(tr("C&omponents"), this);
+    QAction *    actionRegionDetectionWatershedMinima       = new QAction(tr("&Watershed (minima)"), this);
+    QAction *    actionRegionDetectionWatershedMarkers      = new QAction(tr("Watershed (&markers)"), this);
+    QAction *    actionRegionDetectionSegmentLSD            = new QAction(tr("Segments (&LSD)"), this);
+    QAction *    actionRegionDetectionContour               = new QAction(tr("Con&tours"), this);
+    QAction *    actionRegionDetectionSuperpixel            = new QAction(tr("S&uperpixels"), this);
     QVBoxLayout *layout                                     = new QVBoxLayout;
 
     menuFile->addAction(actionOpen);
@@ -124,8 +145,29 @@ MainWindow::MainWindow(QWidget *parent)
     menuOpMorphoMaths->addAction(actionOpMorphoMathsHitOrMiss);
     menuOpMorphoMaths->addAction(actionOpMorphoMathsThinning);
     menuOpMorphoMaths->addAction(actionOpMorphoMathsSkeletonizing);
+    menuOpMorphoMaths->addAction(actionOpMorphoMathsOpeningByReconstruction);
+    menuOpMorphoMaths->addAction(actionOpMorphoMathsHoleFilling);
+    menuOpMorphoMaths->addAction(actionOpMorphoMathsRegionalMaxima);
+    menuOpMorphoMaths->addAction(actionOpMorphoMathsAreaOpening);
+    menuOpMorphoMaths->addAction(actionOpMorphoMathsAreaClosing);
+    menuOpMorphoMaths->addAction(actionOpMorphoMathsAttributeOpening);
+    menuOpMorphoMaths->addAction(actionOpMorphoMathsAttributeClosing);
+    menuOpMorphoMaths->addAction(actionOpMorphoMathsGranulometry);
+    menuOpMorphoMaths->addAction(actionOpMorphoMathsTopHat);
+    menuOpMorphoMaths->addAction(actionOpMorphoMathsBottomHat);
+    menuOpMorphoMaths->addAction(actionOpMorphoMathsLineOpening);
+    menuOpMorphoMaths->addAction(actionOpMorphoMathsLineOpeningBank);
+    menuOpMorphoMaths->addAction(actionOpMorphoMathsRankFilter);
 
     menuDetectionRegion->addAction(actionRegionDetectionLine);
+    menuDetectionRegion->addAction(actionRegionDetectionSegment);
+    menuDetectionRegion->addAction(actionRegionDetectionCircle);
+    menuDetectionRegion->addAction(actionRegionDetectionComponent);
+    menuDetectionRegion->addAction(actionRegionDetectionWatershedMinima);
+    menuDetectionRegion->addAction(actionRegionDetectionWatershedMarkers);
+    menuDetectionRegion->addAction(actionRegionDetectionSegmentLSD);
+    menuDetectionRegion->addAction(actionRegionDetectionContour);
+    menuDetectionRegion->addAction(actionRegionDetectionSuperpixel);
 
     connect(actionOpen, SIGNAL(triggered()), this, SLOT(openImage()));
     connect(actionQuit, SIGNAL(triggered()), qApp, SLOT(quit()));
@@ -165,8 +207,29 @@ MainWindow::MainWindow(QWidget *parent)
     connect(actionOpMorphoMathsHitOrMiss, SIGNAL(triggered()), this, SLOT(displayOpMorphoMathsHitOrMiss()));
     connect(actionOpMorphoMathsThinning, SIGNAL(triggered()), this, SLOT(displayOpMorphoMathsThinning()));
     connect(actionOpMorphoMathsSkeletonizing, SIGNAL(triggered()), this, SLOT(displayOpMorphoMathsSkeletonizing()));
+    connect(actionOpMorphoMathsOpeningByReconstruction, SIGNAL(triggered()), this, SLOT(displayOpMorphoMathsOpeningByReconstruction()));
+    connect(actionOpMorphoMathsHoleFilling, SIGNAL(triggered()), this, SLOT(displayOpMorphoMathsHoleFilling()));
+    connect(actionOpMorphoMathsRegionalMaxima, SIGNAL(triggered()), this, SLOT(displayOpMorphoMathsRegionalMaxima()));
+    connect(actionOpMorphoMathsAreaOpening, SIGNAL(triggered()), this, SLOT(displayOpMorphoMathsAreaOpening()));
+    connect(actionOpMorphoMathsAreaClosing, SIGNAL(triggered()), this, SLOT(displayOpMorphoMathsAreaClosing()));
+    connect(actionOpMorphoMathsAttributeOpening, SIGNAL(triggered()), this, SLOT(displayOpMorphoMathsAttributeOpening()));
+    connect(actionOpMorphoMathsAttributeClosing, SIGNAL(triggered()), this, SLOT(displayOpMorphoMathsAttributeClosing()));
+    connect(actionOpMorphoMathsGranulometry, SIGNAL(triggered()), this, SLOT(displayOpMorphoMathsGranulometry()));
+    connect(actionOpMorphoMathsTopHat, SIGNAL(triggered()), this, SLOT(displayOpMorphoMathsTopHat()));
+    connect(actionOpMorphoMathsBottomHat, SIGNAL(triggered()), this, SLOT(displayOpMorphoMathsBottomHat()));
+    connect(actionOpMorphoMathsLineOpening, SIGNAL(triggered()), this, SLOT(displayOpMorphoMathsLineOpening()));
+    connect(actionOpMorphoMathsLineOpeningBank, SIGNAL(triggered()), this, SLOT(displayOpMorphoMathsLineOpeningBank()));
+    connect(actionOpMorphoMathsRankFilter, SIGNAL(triggered()), this, SLOT(displayOpMorphoMathsRankFilter()));
 
     connect(actionRegionDetectionLine, SIGNAL(triggered()), this, SLOT(displayRegionDetectionLine()));
+    connect(actionRegionDetectionSegment, SIGNAL(triggered()), this, SLOT(displayRegionDetectionSegment()));
+    connect(actionRegionDetectionCircle, SIGNAL(triggered()), this, SLOT(displayRegionDetectionCircle()));
+    connect(actionRegionDetectionComponent, SIGNAL(triggered()), this, SLOT(displayRegionDetectionComponent()));
+    connect(actionRegionDetectionWatershedMinima, SIGNAL(triggered()), this, SLOT(displayRegionDetectionWatershedMinima()));
+    connect(actionRegionDetectionWatershedMarkers, SIGNAL(triggered()), this, SLOT(displayRegionDetectionWatershedMarkers()));
+    connect(actionRegionDetectionSegmentLSD, SIGNAL(triggered()), this, SLOT(displayRegionDetectionSegmentLSD()));
+    connect(actionRegionDetectionContour, SIGNAL(triggered()), this, SLOT(displayRegionDetectionContour()));
+    connect(actionRegionDetectionSuperpixel, SIGNAL(triggered()), this, SLOT(displayRegionDetectionSuperpixel()));
 
     layout->addWidget(&m_labelImage);
     centralArea->setLayout(layout);
@@ -659,6 +722,201 @@ void MainWindow::displayOpMorphoMathsSkeletonizing(void)
 }
 
 
+//------------------------------------------------------------------------------
+//! Display the resulted image after an opening by reconstruction
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void MainWindow::displayOpMorphoMathsOpeningByReconstruction(void)
+{
+    CTreatedImageWindow *treatedImageWindow = new CTreatedImageWindow(PROCESSING_OP_MORPHO_MATHS_OPENING_BY_RECONSTRUCTION, &m_imageOrigin);
+
+    treatedImageWindow->displayOpMorphoMathsOpeningByReconstruction();
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the resulted image after a hole filling
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void MainWindow::displayOpMorphoMathsHoleFilling(void)
+{
+    CTreatedImageWindow *treatedImageWindow = new CTreatedImageWindow(PROCESSING_OP_MORPHO_MATHS_HOLE_FILLING, &m_imageOrigin);
+
+    treatedImageWindow->displayOpMorphoMathsHoleFilling();
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the resulted regional maxima
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void MainWindow::displayOpMorphoMathsRegionalMaxima(void)
+{
+    CTreatedImageWindow *treatedImageWindow = new CTreatedImageWindow(PROCESSING_OP_MORPHO_MATHS_REGIONAL_MAXIMA, &m_imageOrigin);
+
+    treatedImageWindow->displayOpMorphoMathsRegionalMaxima();
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the resulted area opening
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void MainWindow::displayOpMorphoMathsAreaOpening(void)
+{
+    CTreatedImageWindow *treatedImageWindow = new CTreatedImageWindow(PROCESSING_OP_MORPHO_MATHS_AREA_OPENING, &m_imageOrigin);
+
+    treatedImageWindow->displayOpMorphoMathsAreaOpening();
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the resulted area closing
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void MainWindow::displayOpMorphoMathsAreaClosing(void)
+{
+    CTreatedImageWindow *treatedImageWindow = new CTreatedImageWindow(PROCESSING_OP_MORPHO_MATHS_AREA_CLOSING, &m_imageOrigin);
+
+    treatedImageWindow->displayOpMorphoMathsAreaClosing();
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the resulted attribute opening
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void MainWindow::displayOpMorphoMathsAttributeOpening(void)
+{
+    CTreatedImageWindow *treatedImageWindow = new CTreatedImageWindow(PROCESSING_OP_MORPHO_MATHS_ATTRIBUTE_OPENING, &m_imageOrigin);
+
+    treatedImageWindow->displayOpMorphoMathsAttributeOpening();
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the resulted attribute closing
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void MainWindow::displayOpMorphoMathsAttributeClosing(void)
+{
+    CTreatedImageWindow *treatedImageWindow = new CTreatedImageWindow(PROCESSING_OP_MORPHO_MATHS_ATTRIBUTE_CLOSING, &m_imageOrigin);
+
+    treatedImageWindow->displayOpMorphoMathsAttributeClosing();
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the pattern spectrum of the image
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void MainWindow::displayOpMorphoMathsGranulometry(void)
+{
+    CTreatedImageWindow *treatedImageWindow = new CTreatedImageWindow(PROCESSING_OP_MORPHO_MATHS_GRANULOMETRY, &m_imageOrigin);
+
+    treatedImageWindow->displayOpMorphoMathsGranulometry();
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the white top-hat of the image
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void MainWindow::displayOpMorphoMathsTopHat(void)
+{
+    CTreatedImageWindow *treatedImageWindow = new CTreatedImageWindow(PROCESSING_OP_MORPHO_MATHS_TOP_HAT, &m_imageOrigin);
+
+    treatedImageWindow->displayOpMorphoMathsTopHat();
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the black top-hat of the image
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void MainWindow::displayOpMorphoMathsBottomHat(void)
+{
+    CTreatedImageWindow *treatedImageWindow = new CTreatedImageWindow(PROCESSING_OP_MORPHO_MATHS_BOTTOM_HAT, &m_imageOrigin);
+
+    treatedImageWindow->displayOpMorphoMathsBottomHat();
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the opening of the image by an oriented line
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void MainWindow::displayOpMorphoMathsLineOpening(void)
+{
+    CTreatedImageWindow *treatedImageWindow = new CTreatedImageWindow(PROCESSING_OP_MORPHO_MATHS_LINE_OPENING, &m_imageOrigin);
+
+    treatedImageWindow->displayOpMorphoMathsLineOpening();
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the supremum of the line openings of the image
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void MainWindow::displayOpMorphoMathsLineOpeningBank(void)
+{
+    CTreatedImageWindow *treatedImageWindow = new CTreatedImageWindow(PROCESSING_OP_MORPHO_MATHS_LINE_OPENING_BANK, &m_imageOrigin);
+
+    treatedImageWindow->displayOpMorphoMathsLineOpeningBank();
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the image after a rank filter
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void MainWindow::displayOpMorphoMathsRankFilter(void)
+{
+    CTreatedImageWindow *treatedImageWindow = new CTreatedImageWindow(PROCESSING_OP_MORPHO_MATHS_RANK_FILTER, &m_imageOrigin);
+
+    treatedImageWindow->displayOpMorphoMathsRankFilter();
+}
+
+
 //------------------------------------------------------------------------------
 //! Display the resulted image after a line detection
 //!
@@ -672,3 +930,123 @@ void MainWindow::displayRegionDetectionLine(void)
 
     treatedImageWindow->displayRegionDetectionLine();
 }
+
+
+//------------------------------------------------------------------------------
+//! Display the image after a segment detection
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void MainWindow::displayRegionDetectionSegment(void)
+{
+    CTreatedImageWindow *treatedImageWindow = new CTreatedImageWindow(PROCESSING_REGION_DETECTION_SEGMENT, &m_imageOrigin);
+
+    treatedImageWindow->displayRegionDetectionSegment();
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the image after a circle detection
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void MainWindow::displayRegionDetectionCircle(void)
+{
+    CTreatedImageWindow *treatedImageWindow = new CTreatedImageWindow(PROCESSING_REGION_DETECTION_CIRCLE, &m_imageOrigin);
+
+    treatedImageWindow->displayRegionDetectionCircle();
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the image after a connected component labeling
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void MainWindow::displayRegionDetectionComponent(void)
+{
+    CTreatedImageWindow *treatedImageWindow = new CTreatedImageWindow(PROCESSING_REGION_DETECTION_COMPONENT, &m_imageOrigin);
+
+    treatedImageWindow->displayRegionDetectionComponent();
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the image after a watershed from the regional minima
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void MainWindow::displayRegionDetectionWatershedMinima(void)
+{
+    CTreatedImageWindow *treatedImageWindow = new CTreatedImageWindow(PROCESSING_REGION_DETECTION_WATERSHED_MINIMA, &m_imageOrigin);
+
+    treatedImageWindow->displayRegionDetectionWatershedMinima();
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the image after a watershed from markers
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void MainWindow::displayRegionDetectionWatershedMarkers(void)
+{
+    CTreatedImageWindow *treatedImageWindow = new CTreatedImageWindow(PROCESSING_REGION_DETECTION_WATERSHED_MARKERS, &m_imageOrigin);
+
+    treatedImageWindow->displayRegionDetectionWatershedMarkers();
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the image after a line segment detection (LSD)
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void MainWindow::displayRegionDetectionSegmentLSD(void)
+{
+    CTreatedImageWindow *treatedImageWindow = new CTreatedImageWindow(PROCESSING_REGION_DETECTION_SEGMENT_LSD, &m_imageOrigin);
+
+    treatedImageWindow->displayRegionDetectionSegmentLSD();
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the image after a contour tracing
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void MainWindow::displayRegionDetectionContour(void)
+{
+    CTreatedImageWindow *treatedImageWindow = new CTreatedImageWindow(PROCESSING_REGION_DETECTION_CONTOUR, &m_imageOrigin);
+
+    treatedImageWindow->displayRegionDetectionContour();
+}
+
+
+//------------------------------------------------------------------------------
+//! Superpixels of the image (SLIC)
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void MainWindow::displayRegionDetectionSuperpixel(void)
+{
+    CTreatedImageWindow *treatedImageWindow = new CTreatedImageWindow(PROCESSING_REGION_DETECTION_SUPERPIXEL, &m_imageOrigin);
+
+    treatedImageWindow->displayRegionDetectionSuperpixel();
+}
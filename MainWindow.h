@@ -60,7 +60,28 @@ public slots:
     void displayOpMorphoMathsHitOrMiss(void);
     void displayOpMorphoMathsThinning(void);
     void displayOpMorphoMathsSkeletonizing(void);
+    void displayOpMorphoMathsOpeningByReconstruction(void);
+    void displayOpMorphoMathsHoleFilling(void);
+    void displayOpMorphoMathsRegionalMaxima(void);
+    void displayOpMorphoMathsAreaOpening(void);
+    void displayOpMorphoMathsAreaClosing(void);
+    void displayOpMorphoMathsAttributeOpening(void);
+    void displayOpMorphoMathsAttributeClosing(void);
+    void displayOpMorphoMathsGranulometry(void);
+    void displayOpMorphoMathsTopHat(void);
+    void displayOpMorphoMathsBottomHat(void);
+    void displayOpMorphoMathsLineOpening(void);
+    void displayOpMorphoMathsLineOpeningBank(void);
+    void displayOpMorphoMathsRankFilter(void);
     void displayRegionDetectionLine(void);
+    void displayRegionDetectionSegment(void);
+    void displayRegionDetectionCircle(void);
+    void displayRegionDetectionComponent(void);
+    void displayRegionDetectionWatershedMinima(void);
+    void displayRegionDetectionWatershedMarkers(void);
+    void displayRegionDetectionSegmentLSD(void);
+    void displayRegionDetectionContour(void);
+    void displayRegionDetectionSuperpixel(void);
 
 private:
     QString m_imageFilename;
@@ -0,0 +1,335 @@
+//------------------------------------------------------------------------------
+//! @file MaxTree.cpp
+//! @brief Definition file of the CMaxTree class
+//! @author Fabrice Cochet
+//! @version 1.0
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Include(s) :
+
+#include <algorithm>
+
+#include "MaxTree.h"
+
+
+//------------------------------------------------------------------------------
+// Local Function(s):
+
+//------------------------------------------------------------------------------
+//! Find the root of a pixel in a union-find forest (with path compression)
+//!
+//! @param zpar The parent of each pixel in the forest
+//! @param p The pixel
+//!
+//! @return The root
+//------------------------------------------------------------------------------
+static int findRoot(std::vector<int> &zpar, int p)
+{
+    int root = p;
+    int next;
+
+    while (zpar[root] != root)
+        root = zpar[root];
+
+    while (zpar[p] != root)
+    {
+        next    = zpar[p];
+        zpar[p] = root;
+        p       = next;
+    }
+
+    return root;
+}
+
+
+//------------------------------------------------------------------------------
+// Public Method(s):
+
+//------------------------------------------------------------------------------
+//! Constructor (empty tree)
+//!
+//! @param _
+//!
+//! @return The created object
+//------------------------------------------------------------------------------
+CMaxTree::CMaxTree(void)
+{
+    m_width  = 0;
+    m_height = 0;
+}
+
+
+//------------------------------------------------------------------------------
+//! Destructor
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+CMaxTree::~CMaxTree(void)
+{
+}
+
+
+//------------------------------------------------------------------------------
+//! Build the max-tree of a plane and compute the attributes of its nodes
+//!
+//! @param plane The plane (width * height values)
+//! @param width The plane width
+//! @param height The plane height
+//! @param connectedness The connectedness (4 or 8)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CMaxTree::build(const std::vector<uchar> &plane, int width, int height, int connectedness)
+{
+    const int        neighbors[8][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}, {-1, -1}, {1, -1}, {-1, 1}, {1, 1}};
+    int              nNeighbors      = (connectedness == 4) ? 4 : 8;
+    int              nPixels         = width * height;
+    int              histogram[256];
+    std::vector<int> sortedPixels;
+    std::vector<int> parent;
+    std::vector<int> zpar;
+    int              p;
+    int              q;
+    int              r;
+    int              xq;
+    int              yq;
+    SMaxTreeNode     node;
+
+    clear();
+    if ((width <= 0) || (height <= 0) || (plane.size() != static_cast<size_t>(nPixels)))
+        return;
+
+    m_width  = width;
+    m_height = height;
+    sortedPixels.resize(nPixels);
+    parent.assign(nPixels, -1);
+    zpar.resize(nPixels);
+
+    // Counting sort by decreasing level
+    std::fill(histogram, histogram + 256, 0);
+    for (int i = 0; i < nPixels; i++)
+        histogram[plane[i]]++;
+    for (int level = 255, position = 0; level >= 0; level--)
+    {
+        p                = histogram[level];
+        histogram[level] = position;
+        position += p;
+    }
+    for (int i = 0; i < nPixels; i++)
+        sortedPixels[histogram[plane[i]]++] = i;
+
+    // Union-find: the root of each merged component becomes a child of the
+    // current pixel
+    for (int i = 0; i < nPixels; i++)
+    {
+        p         = sortedPixels[i];
+        parent[p] = p;
+        zpar[p]   = p;
+
+        for (int k = 0; k < nNeighbors; k++)
+        {
+            xq = p % width + neighbors[k][0];
+            yq = p / width + neighbors[k][1];
+            if ((xq < 0) || (xq >= width) || (yq < 0) || (yq >= height))
+                continue;
+
+            q = yq * width + xq;
+            if (parent[q] < 0)
+                continue;
+
+            r = findRoot(zpar, q);
+            if (r != p)
+            {
+                parent[r] = p;
+                zpar[r]   = p;
+            }
+        }
+    }
+
+    // Canonization: the parent of a pixel is the canonical pixel of its node
+    // (same level) or of the parent node
+    for (int i = nPixels - 1; i >= 0; i--)
+    {
+        p = sortedPixels[i];
+        q = parent[p];
+        if (plane[parent[q]] == plane[q])
+            parent[p] = parent[q];
+    }
+
+    // Nodes numbered from the root, a parent before its children
+    m_pixelNodes.resize(nPixels);
+    for (int i = nPixels - 1; i >= 0; i--)
+    {
+        p = sortedPixels[i];
+        q = parent[p];
+        if ((q == p) || (plane[q] != plane[p]))
+        {
+            node.parent   = (q == p) ? static_cast<int>(m_nodes.size()) : m_pixelNodes[q];
+            node.level    = plane[p];
+            node.maxLevel = plane[p];
+            node.area     = 0;
+            node.xMin     = width;
+            node.xMax     = -1;
+            node.yMin     = height;
+            node.yMax     = -1;
+            m_pixelNodes[p] = static_cast<int>(m_nodes.size());
+            m_nodes.push_back(node);
+        }
+        else
+        {
+            m_pixelNodes[p] = m_pixelNodes[q];
+        }
+    }
+
+    // Attributes of the pixels of each node, then accumulated from the
+    // children to their parents
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            SMaxTreeNode &pixelNode = m_nodes[m_pixelNodes[y * width + x]];
+
+            pixelNode.area++;
+            pixelNode.xMin = qMin(pixelNode.xMin, x);
+            pixelNode.xMax = qMax(pixelNode.xMax, x);
+            pixelNode.yMin = qMin(pixelNode.yMin, y);
+            pixelNode.yMax = qMax(pixelNode.yMax, y);
+        }
+    }
+    for (int i = static_cast<int>(m_nodes.size()) - 1; i > 0; i--)
+    {
+        SMaxTreeNode &childNode  = m_nodes[i];
+        SMaxTreeNode &parentNode = m_nodes[childNode.parent];
+
+        parentNode.area += childNode.area;
+        parentNode.maxLevel = qMax(parentNode.maxLevel, childNode.maxLevel);
+        parentNode.xMin     = qMin(parentNode.xMin, childNode.xMin);
+        parentNode.xMax     = qMax(parentNode.xMax, childNode.xMax);
+        parentNode.yMin     = qMin(parentNode.yMin, childNode.yMin);
+        parentNode.yMax     = qMax(parentNode.yMax, childNode.yMax);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Empty the tree
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CMaxTree::clear(void)
+{
+    m_width  = 0;
+    m_height = 0;
+    m_nodes.clear();
+    m_pixelNodes.clear();
+}
+
+
+//------------------------------------------------------------------------------
+//! Check if the tree has been built
+//!
+//! @param _
+//!
+//! @return true if built
+//! @return false otherwise
+//------------------------------------------------------------------------------
+bool CMaxTree::isBuilt(void)
+{
+    return !m_nodes.empty();
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the number of nodes
+//!
+//! @param _
+//!
+//! @return The number of nodes
+//------------------------------------------------------------------------------
+int CMaxTree::getNumberNodes(void)
+{
+    return static_cast<int>(m_nodes.size());
+}
+
+
+//------------------------------------------------------------------------------
+//! Get an attribute of a node:
+//! - area: number of pixels
+//! - contrast: maximum level of the node minus the level of its parent
+//! - box size: largest side of the bounding box
+//! - elongation: largest side of the bounding box over its smallest side, in
+//!   percent (100 for a square box)
+//!
+//! @param noNode The node number
+//! @param attribute The attribute
+//!
+//! @return The attribute value
+//------------------------------------------------------------------------------
+int CMaxTree::getAttribute(int noNode, MAXTREE_ATTRIBUTE attribute)
+{
+    SMaxTreeNode &node      = m_nodes[noNode];
+    int           boxWidth  = node.xMax - node.xMin + 1;
+    int           boxHeight = node.yMax - node.yMin + 1;
+    int           value;
+
+    switch (attribute)
+    {
+        case MAXTREE_ATTRIBUTE_AREA:
+            value = node.area;
+            break;
+
+        case MAXTREE_ATTRIBUTE_CONTRAST:
+            value = node.maxLevel - m_nodes[node.parent].level;
+            break;
+
+        case MAXTREE_ATTRIBUTE_BOX_SIZE:
+            value = qMax(boxWidth, boxHeight);
+            break;
+
+        case MAXTREE_ATTRIBUTE_ELONGATION:
+            value = 100 * qMax(boxWidth, boxHeight) / qMin(boxWidth, boxHeight);
+            break;
+
+        // Include MAXTREE_ATTRIBUTE_UNKNOWN
+        default:
+            value = 0;
+            break;
+    }
+
+    return value;
+}
+
+
+//------------------------------------------------------------------------------
+//! Filter the plane with the direct rule: the nodes whose attribute is below
+//! the threshold are removed, their pixels taking the level of the closest
+//! kept ancestor (the root is always kept). With an increasing attribute
+//! (area, contrast, box size) this is an attribute opening.
+//!
+//! @param attribute The attribute
+//! @param threshold The minimal attribute value of the kept nodes
+//! @param planeOut The filtered plane
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CMaxTree::filter(MAXTREE_ATTRIBUTE attribute, int threshold, std::vector<uchar> &planeOut)
+{
+    std::vector<uchar> nodeLevels(m_nodes.size());
+
+    for (size_t i = 0; i < m_nodes.size(); i++)
+    {
+        if ((i == 0) || (getAttribute(static_cast<int>(i), attribute) >= threshold))
+            nodeLevels[i] = m_nodes[i].level;
+        else
+            nodeLevels[i] = nodeLevels[m_nodes[i].parent];
+    }
+
+    planeOut.resize(m_pixelNodes.size());
+    for (size_t i = 0; i < m_pixelNodes.size(); i++)
+        planeOut[i] = nodeLevels[m_pixelNodes[i]];
+}
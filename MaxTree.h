@@ -0,0 +1,77 @@
+//------------------------------------------------------------------------------
+//! @file MaxTree.h
+//! @brief Header file of the CMaxTree class
+//! @author Fabrice Cochet
+//! @version 1.0
+//------------------------------------------------------------------------------
+
+#ifndef MAX_TREE_HEADER
+#define MAX_TREE_HEADER
+
+//------------------------------------------------------------------------------
+// Include(s) :
+
+#include <QtGlobal>
+#include <vector>
+
+
+//------------------------------------------------------------------------------
+// Enumeration(s):
+
+enum MAXTREE_ATTRIBUTE
+{
+    MAXTREE_ATTRIBUTE_UNKNOWN,
+    MAXTREE_ATTRIBUTE_AREA,
+    MAXTREE_ATTRIBUTE_CONTRAST,
+    MAXTREE_ATTRIBUTE_BOX_SIZE,
+    MAXTREE_ATTRIBUTE_ELONGATION
+};
+
+
+//------------------------------------------------------------------------------
+// Structure(s):
+
+//! Node of the max-tree: a connected component of a threshold set of the
+//! plane which is not a component of the next threshold set
+struct SMaxTreeNode
+{
+    int   parent;
+    uchar level;
+    uchar maxLevel;
+    int   area;
+    int   xMin;
+    int   xMax;
+    int   yMin;
+    int   yMax;
+};
+
+
+//------------------------------------------------------------------------------
+// Classe(s) :
+
+//! Max-tree of an 8 bits plane, built once with a union-find algorithm on the
+//! pixels sorted by decreasing level (Berger et al.), then filtered as many
+//! times as needed: a filter only visits the nodes and the pixels once. The
+//! nodes are numbered so that a parent always comes before its children (the
+//! root is the node 0). The min-tree is the max-tree of the negative plane.
+class CMaxTree
+{
+public:
+    CMaxTree(void);
+    ~CMaxTree(void);
+
+    void build(const std::vector<uchar> &plane, int width, int height, int connectedness);
+    void clear(void);
+    bool isBuilt(void);
+    int  getNumberNodes(void);
+    int  getAttribute(int noNode, MAXTREE_ATTRIBUTE attribute);
+    void filter(MAXTREE_ATTRIBUTE attribute, int threshold, std::vector<uchar> &planeOut);
+
+private:
+    int                       m_width;
+    int                       m_height;
+    std::vector<SMaxTreeNode> m_nodes;
+    std::vector<int>          m_pixelNodes;
+};
+
+#endif // MAX_TREE_HEADER
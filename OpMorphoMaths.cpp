@@ -8,561 +8,3157 @@
 //------------------------------------------------------------------------------
 // Include(s) :
 
+#include <algorithm>
+#include <queue>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define OPMORPHOMATHS_SSE2
+#endif
+
 #include "OpMorphoMaths.h"
+#include "qmath.h"
 
 
 //------------------------------------------------------------------------------
-// Public Method(s):
+// Local Function(s):
 
 //------------------------------------------------------------------------------
-//! COpMorphoMaths constructor for a given image
+//! Get the word of the east neighbors (x + 1) of a packed row
 //!
-//! @param imageIn The input image
+//! @param row The packed row
+//! @param w The word index
+//! @param nWords The number of words of the row
 //!
-//! @return The created object
+//! @return The shifted word
 //------------------------------------------------------------------------------
-COpMorphoMaths::COpMorphoMaths(QImage *imageIn)
+static inline quint64 shiftEast(const quint64 *row, int w, int nWords)
 {
-    m_imageOrigin = imageIn;
-    if (m_imageOrigin)
-    {
-        m_imageTreated = new QImage(m_imageOrigin->size(), QImage::Format_RGB32);
-        m_imageGray    = new CImageInt(m_imageOrigin->width(), m_imageOrigin->height());
-    }
-
-    createImageGray(m_imageOrigin, m_imageGray);
+    return (row[w] >> 1) | ((w + 1 < nWords) ? (row[w + 1] << (BINARYIMAGE_WORD_BITS - 1)) : 0);
+}
 
-    if (m_imageOrigin && m_imageTreated && m_imageGray)
-        m_isValid = true;
-    else
-        m_isValid = false;
 
-    m_dimension = 0;
+//------------------------------------------------------------------------------
+//! Get the word of the west neighbors (x - 1) of a packed row
+//!
+//! @param row The packed row
+//! @param w The word index
+//!
+//! @return The shifted word
+//------------------------------------------------------------------------------
+static inline quint64 shiftWest(const quint64 *row, int w)
+{
+    return (row[w] << 1) | ((w > 0) ? (row[w - 1] >> (BINARYIMAGE_WORD_BITS - 1)) : 0);
 }
 
 
 //------------------------------------------------------------------------------
-//! Destructor
+//! Add a bit plane to a bit-sliced 4 bits counter (c0 is the lowest bit)
 //!
-//! @param _
+//! @param v The bit plane to add
+//! @param c0 The bit 0 of the counter
+//! @param c1 The bit 1 of the counter
+//! @param c2 The bit 2 of the counter
+//! @param c3 The bit 3 of the counter
 //!
 //! @return _
 //------------------------------------------------------------------------------
-COpMorphoMaths::~COpMorphoMaths()
+static inline void addBitPlane(quint64 v, quint64 &c0, quint64 &c1, quint64 &c2, quint64 &c3)
 {
-    delete m_imageTreated;
-    delete m_imageGray;
-    delete m_neighborhood;
+    quint64 carry;
+
+    carry = c0 & v;
+    c0 ^= v;
+    v = carry;
+    carry = c1 & v;
+    c1 ^= v;
+    v = carry;
+    carry = c2 & v;
+    c2 ^= v;
+    c3 |= carry;
 }
 
 
 //------------------------------------------------------------------------------
-//! Get the treated image
+//! Compute the pixel-wise minimum or maximum of two rows (16 pixels per
+//! instruction with SSE2)
 //!
-//! @param _
+//! @param rowIn1 The first input row
+//! @param rowIn2 The second input row
+//! @param n The row length
+//! @param isDilation true for the maximum, false for the minimum
+//! @param rowOut The output row (may be one of the input rows)
 //!
-//! @return A pointer on the treated image
+//! @return _
 //------------------------------------------------------------------------------
-QImage *COpMorphoMaths::getImageTreated(void)
+static inline void minMaxRows(const uchar *rowIn1, const uchar *rowIn2, int n, bool isDilation, uchar *rowOut)
 {
-    return m_imageTreated;
+    int x = 0;
+
+#ifdef OPMORPHOMATHS_SSE2
+    __m128i v1;
+    __m128i v2;
+
+    for (; x + 16 <= n; x += 16)
+    {
+        v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rowIn1 + x));
+        v2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rowIn2 + x));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(rowOut + x), isDilation ? _mm_max_epu8(v1, v2) : _mm_min_epu8(v1, v2));
+    }
+#endif
+
+    if (isDilation)
+    {
+        for (; x < n; x++)
+            rowOut[x] = qMax(rowIn1[x], rowIn2[x]);
+    }
+    else
+    {
+        for (; x < n; x++)
+            rowOut[x] = qMin(rowIn1[x], rowIn2[x]);
+    }
 }
 
 
 //------------------------------------------------------------------------------
-//! Get the dimension of the neighborhood
+//! Compute the running minimum or maximum of a row for a window length with
+//! the van Herk/Gil-Werman algorithm (3 comparisons per pixel whatever the
+//! length): rowOut[x] is the min/max of rowIn[x .. x + length - 1]
 //!
-//! @param _
+//! @param rowIn The input row
+//! @param n The row length
+//! @param length The window length (1 <= length <= n)
+//! @param isDilation true for the maximum, false for the minimum
+//! @param prefix A buffer of n values
+//! @param suffix A buffer of n values
+//! @param rowOut The output row (n - length + 1 values)
 //!
-//! @return The dimension
+//! @return _
 //------------------------------------------------------------------------------
-int COpMorphoMaths::getDimension(void)
+static void runningMinMax(const uchar *rowIn, int n, int length, bool isDilation, uchar *prefix, uchar *suffix, uchar *rowOut)
 {
-    return m_dimension;
+    if (length == 1)
+    {
+        std::copy(rowIn, rowIn + n, rowOut);
+    }
+    else
+    {
+        if (isDilation)
+        {
+            for (int x = 0; x < n; x++)
+                prefix[x] = (x % length == 0) ? rowIn[x] : qMax(prefix[x - 1], rowIn[x]);
+            for (int x = n - 1; x >= 0; x--)
+                suffix[x] = ((x == n - 1) || (x % length == length - 1)) ? rowIn[x] : qMax(suffix[x + 1], rowIn[x]);
+        }
+        else
+        {
+            for (int x = 0; x < n; x++)
+                prefix[x] = (x % length == 0) ? rowIn[x] : qMin(prefix[x - 1], rowIn[x]);
+            for (int x = n - 1; x >= 0; x--)
+                suffix[x] = ((x == n - 1) || (x % length == length - 1)) ? rowIn[x] : qMin(suffix[x + 1], rowIn[x]);
+        }
+        minMaxRows(suffix, prefix + length - 1, n - length + 1, isDilation, rowOut);
+    }
 }
 
 
 //------------------------------------------------------------------------------
-//! Start method for the MorphoMaths operations
+//! Fold the running minimum or maximum of a column window into the output
+//! rows with the van Herk/Gil-Werman algorithm applied to whole rows:
+//! rowsOut[y] = min/max(rowsOut[y], rowsIn[y .. y + height - 1])
 //!
-//! @param operationType The operation type
-//! @param dimension The neighborhood dimension
-//! @param neighborhoodType The neighborhood type
+//! @param rowsIn The first input row
+//! @param strideIn The distance between two input rows
+//! @param n The number of output rows
+//! @param width The row length
+//! @param height The window height (>= 1)
+//! @param isDilation true for the maximum, false for the minimum
+//! @param prefix A buffer of (n + height - 1) * width values
+//! @param suffix A buffer of (n + height - 1) * width values
+//! @param rowsOut The first output row
+//! @param strideOut The distance between two output rows
 //!
 //! @return _
 //------------------------------------------------------------------------------
-void COpMorphoMaths::computeOpMorphoMaths(OPMORPHOMATHS_TYPE operationType, int dimension, int neighborhoodType)
+static void foldColumnMinMax(const uchar *rowsIn, int strideIn, int n, int width, int height, bool isDilation, uchar *prefix, uchar *suffix, uchar *rowsOut, int strideOut)
 {
-    m_dimension        = dimension;
-    m_neighborhoodType = neighborhoodType;
+    int nIn = n + height - 1;
 
-    initNeighborhood();
+    if (height == 1)
+    {
+        for (int y = 0; y < n; y++)
+            minMaxRows(rowsOut + y * strideOut, rowsIn + y * strideIn, width, isDilation, rowsOut + y * strideOut);
+    }
+    else
+    {
+        for (int y = 0; y < nIn; y++)
+        {
+            if (y % height == 0)
+                std::copy(rowsIn + y * strideIn, rowsIn + y * strideIn + width, prefix + y * width);
+            else
+                minMaxRows(prefix + (y - 1) * width, rowsIn + y * strideIn, width, isDilation, prefix + y * width);
+        }
+        for (int y = nIn - 1; y >= 0; y--)
+        {
+            if ((y == nIn - 1) || (y % height == height - 1))
+                std::copy(rowsIn + y * strideIn, rowsIn + y * strideIn + width, suffix + y * width);
+            else
+                minMaxRows(suffix + (y + 1) * width, rowsIn + y * strideIn, width, isDilation, suffix + y * width);
+        }
+        for (int y = 0; y < n; y++)
+        {
+            minMaxRows(rowsOut + y * strideOut, suffix + y * width, width, isDilation, rowsOut + y * strideOut);
+            minMaxRows(rowsOut + y * strideOut, prefix + (y + height - 1) * width, width, isDilation, rowsOut + y * strideOut);
+        }
+    }
+}
 
-    if (m_isValid)
+
+//------------------------------------------------------------------------------
+//! Compute the erosion or the dilation of a tile by a small structuring
+//! element known at compile time (bit y * (2 * RADIUS + 1) + x of MASK): the
+//! loop on the neighbors is unrolled and 16 pixels are computed at a time
+//! with SSE2
+//!
+//! @param pixelsIn The tile and its halo of RADIUS pixels
+//! @param bufferWidth The width of the tile and its halo
+//! @param tileWidth The tile width
+//! @param tileHeight The tile height
+//! @param rowsOut The first output row
+//! @param strideOut The distance between two output rows
+//!
+//! @return _
+//------------------------------------------------------------------------------
+template <unsigned int MASK, int RADIUS, bool IS_DILATION>
+static void minMaxKernel(const uchar *pixelsIn, int bufferWidth, int tileWidth, int tileHeight, uchar *rowsOut, int strideOut)
+{
+    const int    SIZE = 2 * RADIUS + 1;
+    const uchar *centre;
+    uchar *      rowOut;
+    uchar        value;
+    int          x;
+
+    for (int y = 0; y < tileHeight; y++)
     {
-        switch (operationType)
+        centre = pixelsIn + (y + RADIUS) * bufferWidth + RADIUS;
+        rowOut = rowsOut + y * strideOut;
+        x      = 0;
+
+#ifdef OPMORPHOMATHS_SSE2
+        __m128i values;
+        __m128i neighbors;
+
+        for (; x + 16 <= tileWidth; x += 16)
         {
-            case OPMORPHOMATHS_DILATION:
-                computeDilation();
-                break;
+            values = IS_DILATION ? _mm_setzero_si128() : _mm_set1_epi8(static_cast<char>(CIMAGEINT_MAX));
+            for (int k = 0; k < SIZE * SIZE; k++)
+            {
+                if (MASK & (1u << k))
+                {
+                    neighbors = _mm_loadu_si128(reinterpret_cast<const __m128i *>(centre + (k / SIZE - RADIUS) * bufferWidth + (k % SIZE - RADIUS) + x));
+                    values    = IS_DILATION ? _mm_max_epu8(values, neighbors) : _mm_min_epu8(values, neighbors);
+                }
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(rowOut + x), values);
+        }
+#endif
 
-            case OPMORPHOMATHS_EROSION:
-                computeErosion();
-                break;
+        for (; x < tileWidth; x++)
+        {
+            value = IS_DILATION ? 0 : CIMAGEINT_MAX;
+            for (int k = 0; k < SIZE * SIZE; k++)
+            {
+                if (MASK & (1u << k))
+                {
+                    if (IS_DILATION)
+                        value = qMax(value, centre[(k / SIZE - RADIUS) * bufferWidth + (k % SIZE - RADIUS) + x]);
+                    else
+                        value = qMin(value, centre[(k / SIZE - RADIUS) * bufferWidth + (k % SIZE - RADIUS) + x]);
+                }
+            }
+            rowOut[x] = value;
+        }
+    }
+}
 
-            case OPMORPHOMATHS_OPENING:
-                computeOpening();
-                break;
 
-            case OPMORPHOMATHS_CLOSING:
-                computeClosing();
-                break;
+//------------------------------------------------------------------------------
+// Structure(s):
 
-            case OPMORPHOMATHS_INTERIOR_GRADIENT:
-                computeInteriorGradient();
-                break;
+typedef void (*TOpMorphoMathsKernel)(const uchar *pixelsIn, int bufferWidth, int tileWidth, int tileHeight, uchar *rowsOut, int strideOut);
 
-            case OPMORPHOMATHS_EXTERIOR_GRADIENT:
-                computeExteriorGradient();
-                break;
+//! Specialized kernels of a small structuring element
+struct SOpMorphoMathsKernel
+{
+    int                  radius;
+    unsigned int         mask;
+    TOpMorphoMathsKernel erosion;
+    TOpMorphoMathsKernel dilation;
+};
 
-            case OPMORPHOMATHS_MORPHOLOGICAL_GRADIENT:
-                computeMorphologicalGradient();
-                break;
 
-            case OPMORPHOMATHS_HIT_OR_MISS:
-                computeHitOrMiss();
-                break;
+//------------------------------------------------------------------------------
+// Constant(s):
+
+#define OPMORPHOMATHS_KERNEL(radius, mask) \
+    { radius, mask, &minMaxKernel<mask, radius, false>, &minMaxKernel<mask, radius, true> }
+
+//! The neighborhoods of dimension 1 and 2 (see initNeighborhood)
+static const SOpMorphoMathsKernel OPMORPHOMATHS_KERNELS[] = {
+    OPMORPHOMATHS_KERNEL(1, 0x000000BA), // Connectedness 4
+    OPMORPHOMATHS_KERNEL(1, 0x000001FF), // Connectedness 8
+    OPMORPHOMATHS_KERNEL(1, 0x00000092), // Vertical
+    OPMORPHOMATHS_KERNEL(1, 0x00000038), // Horizontal
+    OPMORPHOMATHS_KERNEL(1, 0x0000003A), // Connectedness 4 up
+    OPMORPHOMATHS_KERNEL(1, 0x000000B8), // Connectedness 4 down
+    OPMORPHOMATHS_KERNEL(1, 0x0000009A), // Connectedness 4 left
+    OPMORPHOMATHS_KERNEL(1, 0x000000B2), // Connectedness 4 right
+    OPMORPHOMATHS_KERNEL(2, 0x00427C84), // Connectedness 4
+    OPMORPHOMATHS_KERNEL(2, 0x01FFFFFF), // Connectedness 8
+    OPMORPHOMATHS_KERNEL(2, 0x00421084), // Vertical
+    OPMORPHOMATHS_KERNEL(2, 0x00007C00), // Horizontal
+    OPMORPHOMATHS_KERNEL(2, 0x00007C84), // Connectedness 4 up
+    OPMORPHOMATHS_KERNEL(2, 0x00427C00), // Connectedness 4 down
+    OPMORPHOMATHS_KERNEL(2, 0x00421C84), // Connectedness 4 left
+    OPMORPHOMATHS_KERNEL(2, 0x00427084)  // Connectedness 4 right
+};
 
-            case OPMORPHOMATHS_THINNING:
-                computeThinning();
-                break;
 
-            case OPMORPHOMATHS_SKELETONIZING:
-                computeSkeletonizing();
-                break;
+//------------------------------------------------------------------------------
+//! Find the specialized kernel of a structuring element
+//!
+//! @param structuringElement The compiled structuring element
+//! @param isDilation true for the dilation, false for the erosion
+//!
+//! @return The kernel (nullptr if the structuring element is not specialized)
+//------------------------------------------------------------------------------
+static TOpMorphoMathsKernel findKernel(CStructuringElement &structuringElement, bool isDilation)
+{
+    TOpMorphoMathsKernel kernel = nullptr;
 
-            // Include OPMORPHOMATHS_UNKNOWN
-            default:
-                break;
+    if (structuringElement.getMask() != 0)
+    {
+        for (size_t i = 0; (i < sizeof(OPMORPHOMATHS_KERNELS) / sizeof(OPMORPHOMATHS_KERNELS[0])) && !kernel; i++)
+        {
+            if ((OPMORPHOMATHS_KERNELS[i].radius == structuringElement.getRadiusX()) &&
+                (OPMORPHOMATHS_KERNELS[i].mask == structuringElement.getMask()))
+                kernel = isDilation ? OPMORPHOMATHS_KERNELS[i].dilation : OPMORPHOMATHS_KERNELS[i].erosion;
         }
     }
+
+    return kernel;
 }
 
 
 //------------------------------------------------------------------------------
-// Private Method(s):
+//! Find the root of a pixel in a union-find forest (with path compression)
+//!
+//! @param parent The parent of each pixel
+//! @param p The pixel
+//!
+//! @return The root
+//------------------------------------------------------------------------------
+static int findRoot(std::vector<int> &parent, int p)
+{
+    int root = p;
+    int next;
+
+    while (parent[root] != root)
+        root = parent[root];
+
+    while (parent[p] != root)
+    {
+        next      = parent[p];
+        parent[p] = root;
+        p         = next;
+    }
+
+    return root;
+}
+
 
 //------------------------------------------------------------------------------
-//! Create a grayscale image (binary) for a given image
+//! Compute, along a line of pixels, the largest radius of the segments
+//! covering each pixel: the pixel c is the centre of the segment
+//! [c - radii[c], c + radii[c]] (no segment if radii[c] < 0) and
+//! radiiOut[x] = max(radii[c], |x - c| <= radii[c]), -1 if not covered
 //!
-//! @param imageIn The input image
-//! @param imageOut The output image
+//! @param radii The first radius of the line
+//! @param n The number of pixels of the line
+//! @param stride The distance between two pixels of the line
+//! @param radiiOut The first output radius (same stride)
 //!
 //! @return _
 //------------------------------------------------------------------------------
-void COpMorphoMaths::createImageGray(QImage *imageIn, CImageInt *imageOut)
+static void coverMax(const int *radii, int n, int stride, int *radiiOut)
 {
-    int GOut;
+    // (radius, end) of the segments, the expired ones are removed when they
+    // reach the top
+    std::priority_queue<std::pair<int, int>> segments;
 
-    if (imageIn && imageOut)
+    // Centres before the pixel
+    for (int x = 0; x < n; x++)
     {
-        for (int x = 0; x < imageIn->width(); x++)
-        {
-            for (int y = 0; y < imageIn->height(); y++)
-            {
-                GOut = (299 * qRed(imageIn->pixel(x, y)) +
-                        587 * qGreen(imageIn->pixel(x, y)) +
-                        114 * qBlue(imageIn->pixel(x, y))) /
-                       1000;
+        if (radii[x * stride] >= 0)
+            segments.push(std::make_pair(radii[x * stride], x + radii[x * stride]));
+        while (!segments.empty() && (segments.top().second < x))
+            segments.pop();
+        radiiOut[x * stride] = segments.empty() ? -1 : segments.top().first;
+    }
 
-                if (GOut < 128)
-                    (*imageOut)(x, y) = 0;
-                else
-                    (*imageOut)(x, y) = CIMAGEINT_MAX;
-            }
-        }
+    // Centres after the pixel
+    segments = std::priority_queue<std::pair<int, int>>();
+    for (int x = n - 1; x >= 0; x--)
+    {
+        if (radii[x * stride] >= 0)
+            segments.push(std::make_pair(radii[x * stride], -(x - radii[x * stride])));
+        while (!segments.empty() && (-segments.top().second > x))
+            segments.pop();
+        if (!segments.empty())
+            radiiOut[x * stride] = qMax(radiiOut[x * stride], segments.top().first);
     }
 }
 
 
 //------------------------------------------------------------------------------
-//! Initialize the neighborhood depending on the type (see the
-//! computeOpMorphoMaths method)
+//! Compute, along a line of a binary plane, the radius of the largest segment
+//! centred on each pixel and included in the foreground: the distance to the
+//! background on the nearest side minus 1, up to maxRadius, -1 for the
+//! background. The pixels outside the line are ignored, as for the openings.
 //!
-//! @param _
+//! @param plane The first pixel of the line
+//! @param n The number of pixels of the line
+//! @param stride The distance between two pixels of the line
+//! @param maxRadius The largest radius
+//! @param runs The first value of a work line (same stride)
+//! @param radiiOut The first output radius (same stride)
 //!
 //! @return _
 //------------------------------------------------------------------------------
-void COpMorphoMaths::initNeighborhood(void)
+static void segmentRadii(const uchar *plane, int n, int stride, int maxRadius, int *runs, int *radiiOut)
 {
-    m_neighborhood = new CImageInt(m_dimension * 2 + 1, m_dimension * 2 + 1);
-
-    if (m_neighborhood)
+    for (int x = 0, run = maxRadius; x < n; x++)
     {
-        switch (m_neighborhoodType)
-        {
-            case OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_4:
-                for (int x = 0; x < m_neighborhood->getWidth(); x++)
-                    (*m_neighborhood)(x, m_dimension) = CIMAGEINT_MAX;
-                for (int y = 0; y < m_neighborhood->getHeight(); y++)
-                    (*m_neighborhood)(m_dimension, y) = CIMAGEINT_MAX;
-                break;
+        run              = (plane[x * stride] == 0) ? -1 : qMin(run + 1, maxRadius);
+        runs[x * stride] = run;
+    }
+    for (int x = n - 1, run = maxRadius; x >= 0; x--)
+    {
+        run                  = (plane[x * stride] == 0) ? -1 : qMin(run + 1, maxRadius);
+        radiiOut[x * stride] = qMin(runs[x * stride], run);
+    }
+}
 
-            case OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_8:
-                for (int x = 0; x < m_neighborhood->getWidth(); x++)
-                    for (int y = 0; y < m_neighborhood->getHeight(); y++)
-                        (*m_neighborhood)(x, y) = CIMAGEINT_MAX;
-                break;
 
-            case OPMORPHOMATHS_NEIGHBORHOOD_VERTICAL:
-                for (int y = 0; y < m_neighborhood->getHeight(); y++)
-                    (*m_neighborhood)(m_dimension, y) = CIMAGEINT_MAX;
-                break;
+//------------------------------------------------------------------------------
+//! Add a value to a two-level histogram (256 levels and 16 groups of 16
+//! levels)
+//!
+//! @param levels The histogram of the levels
+//! @param groups The histogram of the groups of levels
+//! @param value The value
+//! @param count 1 to add the value, -1 to remove it
+//!
+//! @return _
+//------------------------------------------------------------------------------
+static inline void addToHistogram(int *levels, int *groups, uchar value, int count)
+{
+    levels[value] += count;
+    groups[value >> 4] += count;
+}
 
-            case OPMORPHOMATHS_NEIGHBORHOOD_HORIZONTAL:
-                for (int x = 0; x < m_neighborhood->getWidth(); x++)
-                    (*m_neighborhood)(x, m_dimension) = CIMAGEINT_MAX;
-                break;
 
-            case OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_4_UP:
-                for (int x = 0; x < m_neighborhood->getWidth(); x++)
-                    (*m_neighborhood)(x, m_dimension) = CIMAGEINT_MAX;
-                for (int y = 0; y <= m_dimension; y++)
-                    (*m_neighborhood)(m_dimension, y) = CIMAGEINT_MAX;
-                break;
+//------------------------------------------------------------------------------
+//! Slide the histogram of a neighborhood by one column: the leaving column
+//! histogram is subtracted and the entering one is added (all of them are
+//! two-level histograms: the 256 levels followed by the 16 groups)
+//!
+//! @param histogram The histogram of the neighborhood
+//! @param columnOut The histogram of the leaving column
+//! @param columnIn The histogram of the entering column
+//!
+//! @return _
+//------------------------------------------------------------------------------
+static inline void slideHistogram(int *histogram, const int *columnOut, const int *columnIn)
+{
+    int i = 0;
 
-            case OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_4_DOWN:
-                for (int x = 0; x < m_neighborhood->getWidth(); x++)
-                    (*m_neighborhood)(x, m_dimension) = CIMAGEINT_MAX;
-                for (int y = m_dimension + 1; y < m_neighborhood->getHeight(); y++)
-                    (*m_neighborhood)(m_dimension, y) = CIMAGEINT_MAX;
-                break;
+#ifdef OPMORPHOMATHS_SSE2
+    __m128i values;
 
-            case OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_4_LEFT:
-                for (int x = 0; x <= m_dimension; x++)
-                    (*m_neighborhood)(x, m_dimension) = CIMAGEINT_MAX;
-                for (int y = 0; y < m_neighborhood->getHeight(); y++)
-                    (*m_neighborhood)(m_dimension, y) = CIMAGEINT_MAX;
-                break;
+    for (; i + 4 <= OPMORPHOMATHS_RANK_HISTOGRAM_SIZE; i += 4)
+    {
+        values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(histogram + i));
+        values = _mm_sub_epi32(values, _mm_loadu_si128(reinterpret_cast<const __m128i *>(columnOut + i)));
+        values = _mm_add_epi32(values, _mm_loadu_si128(reinterpret_cast<const __m128i *>(columnIn + i)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(histogram + i), values);
+    }
+#endif
 
-            case OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_4_RIGHT:
-                for (int x = m_dimension + 1; x < m_neighborhood->getWidth(); x++)
-                    (*m_neighborhood)(x, m_dimension) = CIMAGEINT_MAX;
-                for (int y = 0; y < m_neighborhood->getHeight(); y++)
-                    (*m_neighborhood)(m_dimension, y) = CIMAGEINT_MAX;
-                break;
+    for (; i < OPMORPHOMATHS_RANK_HISTOGRAM_SIZE; i++)
+        histogram[i] += columnIn[i] - columnOut[i];
+}
+
+
+//------------------------------------------------------------------------------
+//! Find the value of a given rank in a two-level histogram (at most 16 groups
+//! and 16 levels are visited)
+//!
+//! @param levels The histogram of the levels
+//! @param groups The histogram of the groups of levels
+//! @param rank The rank (0 for the minimum)
+//!
+//! @return The value
+//------------------------------------------------------------------------------
+static inline uchar findRank(const int *levels, const int *groups, int rank)
+{
+    int group = 0;
+    int level;
+
+    while (rank >= groups[group])
+        rank -= groups[group++];
+    level = group << 4;
+    while (rank >= levels[level])
+        rank -= levels[level++];
+
+    return static_cast<uchar>(level);
+}
+
+
+//------------------------------------------------------------------------------
+// Public Method(s):
+
+//------------------------------------------------------------------------------
+//! COpMorphoMaths constructor for a given image
+//!
+//! @param imageIn The input image
+//!
+//! @return The created object
+//------------------------------------------------------------------------------
+COpMorphoMaths::COpMorphoMaths(QImage *imageIn)
+{
+    m_imageOrigin    = imageIn;
+    m_runLengthImage = nullptr;
+    if (m_imageOrigin)
+    {
+        m_imageTreated = new QImage(m_imageOrigin->size(), QImage::Format_RGB32);
+        m_imageGray    = new CImageInt(m_imageOrigin->width(), m_imageOrigin->height());
+    }
+
+    createImageGray(m_imageOrigin, m_imageGray);
+
+    if (m_imageOrigin && m_imageTreated && m_imageGray)
+        m_isValid = true;
+    else
+        m_isValid = false;
+
+    m_isGrayscale = false;
+    if (m_isValid)
+    {
+        createLuminancePlane(m_imageOrigin, m_luminancePlane);
+        updatePlane();
+    }
+
+    m_dimension                   = 0;
+    m_neighborhood                = nullptr;
+    m_customNeighborhood          = nullptr;
+    m_compiledDimension           = -1;
+    m_compiledNeighborhoodType    = OPMORPHOMATHS_NEIGHBORHOOD_UNKNOWN;
+    m_isBitParallel               = true;
+    m_isRunLength                 = false;
+    m_incrementalOperationType    = OPMORPHOMATHS_UNKNOWN;
+    m_incrementalNeighborhoodType = OPMORPHOMATHS_NEIGHBORHOOD_UNKNOWN;
+    m_incrementalIsGrayscale      = false;
+    m_nThreads                    = CParallel::getIdealThreadCount();
+    m_tileSize                    = OPMORPHOMATHS_DEFAULT_TILE_SIZE;
+    m_area                        = OPMORPHOMATHS_DEFAULT_AREA;
+    m_attribute                   = MAXTREE_ATTRIBUTE_CONTRAST;
+    m_attributeThreshold          = OPMORPHOMATHS_DEFAULT_CONTRAST;
+    m_lineAngle                   = OPMORPHOMATHS_DEFAULT_LINE_ANGLE;
+    m_nOrientations               = OPMORPHOMATHS_DEFAULT_ORIENTATIONS;
+    m_percentile                  = OPMORPHOMATHS_DEFAULT_PERCENTILE;
+    m_maxTreeConnectedness        = 0;
+    m_minTreeConnectedness        = 0;
+}
+
+
+//------------------------------------------------------------------------------
+//! Destructor
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+COpMorphoMaths::~COpMorphoMaths()
+{
+    delete m_imageTreated;
+    delete m_imageGray;
+    delete m_neighborhood;
+    delete m_customNeighborhood;
+    delete m_runLengthImage;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the treated image
+//!
+//! @param _
+//!
+//! @return A pointer on the treated image
+//------------------------------------------------------------------------------
+QImage *COpMorphoMaths::getImageTreated(void)
+{
+    return m_imageTreated;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the dimension of the neighborhood
+//!
+//! @param _
+//!
+//! @return The dimension
+//------------------------------------------------------------------------------
+int COpMorphoMaths::getDimension(void)
+{
+    return m_dimension;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get if the thinning and the skeletonization are computed on the packed
+//! binary image (64 pixels at a time)
+//!
+//! @param _
+//!
+//! @return true or false
+//------------------------------------------------------------------------------
+bool COpMorphoMaths::isBitParallel(void)
+{
+    return m_isBitParallel;
+}
+
+
+//------------------------------------------------------------------------------
+//! Set if the thinning and the skeletonization are computed on the packed
+//! binary image (64 pixels at a time)
+//!
+//! @param isBitParallel The bit-parallel flag
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::setBitParallel(bool isBitParallel)
+{
+    m_isBitParallel = isBitParallel;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get if the binary dilation, erosion, opening and closing by a square or a
+//! line are computed on the run-length encoded image
+//!
+//! @param _
+//!
+//! @return true or false
+//------------------------------------------------------------------------------
+bool COpMorphoMaths::isRunLength(void)
+{
+    return m_isRunLength;
+}
+
+
+//------------------------------------------------------------------------------
+//! Set if the binary dilation, erosion, opening and closing by a square or a
+//! line are computed on the run-length encoded image (faster for the images
+//! made of long runs, such as the scanned documents). The image is encoded
+//! once, on the first operation, and kept until the plane changes.
+//!
+//! @param isRunLength The run-length flag
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::setRunLength(bool isRunLength)
+{
+    m_isRunLength = isRunLength;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the grayscale flag
+//!
+//! @param _
+//!
+//! @return true if the operations are computed on the gray levels
+//! @return false if they are computed on the binarized image
+//------------------------------------------------------------------------------
+bool COpMorphoMaths::isGrayscale(void)
+{
+    return m_isGrayscale;
+}
+
+
+//------------------------------------------------------------------------------
+//! Set if the operations are computed on the gray levels (luminance) instead
+//! of the binarized image. The hit or miss, the thinning and the
+//! skeletonization are binary operations and always use the binarized image.
+//!
+//! @param isGrayscale The grayscale flag
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::setGrayscale(bool isGrayscale)
+{
+    if (m_isGrayscale != isGrayscale)
+    {
+        m_isGrayscale = isGrayscale;
+        if (m_isValid)
+            updatePlane();
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the number of threads of the tiled operations
+//!
+//! @param _
+//!
+//! @return The number of threads
+//------------------------------------------------------------------------------
+int COpMorphoMaths::getNumberThreads(void)
+{
+    return m_nThreads;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the tile size of the tiled operations
+//!
+//! @param _
+//!
+//! @return The tile size (in pixels)
+//------------------------------------------------------------------------------
+int COpMorphoMaths::getTileSize(void)
+{
+    return m_tileSize;
+}
+
+
+//------------------------------------------------------------------------------
+//! Set the tiled execution of the dilation, the erosion and the operations
+//! built on them (1 thread and a tile size larger than the image give the
+//! untiled execution, the result is the same in all cases)
+//!
+//! @param nThreads The number of threads
+//! @param tileSize The tile size (in pixels)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::setTiling(int nThreads, int tileSize)
+{
+    m_nThreads = qMax(nThreads, 1);
+    m_tileSize = qMax(tileSize, 1);
+}
+
+
+//------------------------------------------------------------------------------
+//! Set the neighborhood used with the OPMORPHOMATHS_NEIGHBORHOOD_CUSTOM type
+//! (the dimension is then given by the neighborhood size)
+//!
+//! @param neighborhood The neighborhood (square with an odd size, a pixel is
+//!        active if its value is not 0), copied
+//!
+//! @return true if OK
+//! @return false otherwise
+//------------------------------------------------------------------------------
+bool COpMorphoMaths::setCustomNeighborhood(CImageInt *neighborhood)
+{
+    bool ret = false;
+
+    if (neighborhood && (neighborhood->getWidth() == neighborhood->getHeight()) && (neighborhood->getWidth() % 2 == 1))
+    {
+        delete m_customNeighborhood;
+        m_customNeighborhood = new CImageInt(neighborhood->getWidth(), neighborhood->getHeight(), neighborhood);
+        ret                  = (m_customNeighborhood != nullptr);
+
+        // Force the compilation of the new neighborhood
+        m_compiledNeighborhoodType = OPMORPHOMATHS_NEIGHBORHOOD_UNKNOWN;
+    }
+
+    return ret;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the area threshold of the area opening and closing
+//!
+//! @param _
+//!
+//! @return The area (in pixels)
+//------------------------------------------------------------------------------
+int COpMorphoMaths::getArea(void)
+{
+    return m_area;
+}
+
+
+//------------------------------------------------------------------------------
+//! Set the area threshold of the area opening and closing
+//!
+//! @param area The area (in pixels)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::setArea(int area)
+{
+    m_area = qMax(area, 1);
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the attribute of the attribute opening and closing
+//!
+//! @param _
+//!
+//! @return The attribute (see MAXTREE_ATTRIBUTE)
+//------------------------------------------------------------------------------
+int COpMorphoMaths::getAttribute(void)
+{
+    return m_attribute;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the attribute threshold of the attribute opening and closing
+//!
+//! @param _
+//!
+//! @return The threshold
+//------------------------------------------------------------------------------
+int COpMorphoMaths::getAttributeThreshold(void)
+{
+    return m_attributeThreshold;
+}
+
+
+//------------------------------------------------------------------------------
+//! Set the attribute of the attribute opening and closing and its threshold
+//! (the component trees are kept, only the filtering is computed again)
+//!
+//! @param attribute The attribute (see MAXTREE_ATTRIBUTE)
+//! @param threshold The minimal attribute value of the kept components
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::setAttribute(int attribute, int threshold)
+{
+    m_attribute          = attribute;
+    m_attributeThreshold = threshold;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the angle of the line of the line opening
+//!
+//! @param _
+//!
+//! @return The angle (in degrees, counterclockwise from the horizontal)
+//------------------------------------------------------------------------------
+int COpMorphoMaths::getLineAngle(void)
+{
+    return m_lineAngle;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the number of orientations of the bank of line openings
+//!
+//! @param _
+//!
+//! @return The number of orientations
+//------------------------------------------------------------------------------
+int COpMorphoMaths::getNumberOrientations(void)
+{
+    return m_nOrientations;
+}
+
+
+//------------------------------------------------------------------------------
+//! Set the line of the line opening (its half length is the dimension) and
+//! the number of orientations of the bank of line openings (regularly spaced
+//! on 180 degrees)
+//!
+//! @param angle The angle (in degrees, counterclockwise from the horizontal)
+//! @param nOrientations The number of orientations
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::setLine(int angle, int nOrientations)
+{
+    m_lineAngle     = angle;
+    m_nOrientations = qMax(nOrientations, 1);
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the percentile of the rank filter
+//!
+//! @param _
+//!
+//! @return The percentile (0 for the erosion, 50 for the median, 100 for the
+//!         dilation)
+//------------------------------------------------------------------------------
+int COpMorphoMaths::getPercentile(void)
+{
+    return m_percentile;
+}
+
+
+//------------------------------------------------------------------------------
+//! Set the percentile of the rank filter
+//!
+//! @param percentile The percentile (0 for the erosion, 50 for the median,
+//!        100 for the dilation)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::setPercentile(int percentile)
+{
+    m_percentile = qBound(0, percentile, 100);
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the pattern spectrum computed by the last granulometry: the value d
+//! (0 <= d < dimension) is the area (the volume in grayscale mode) removed
+//! between the openings of dimension d and d + 1, the last value is the area
+//! of the opening of the maximal dimension
+//!
+//! @param _
+//!
+//! @return The pattern spectrum
+//------------------------------------------------------------------------------
+const std::vector<qint64> &COpMorphoMaths::getPatternSpectrum(void)
+{
+    return m_patternSpectrum;
+}
+
+
+//------------------------------------------------------------------------------
+//! Start method for the MorphoMaths operations
+//!
+//! @param operationType The operation type
+//! @param dimension The neighborhood dimension
+//! @param neighborhoodType The neighborhood type
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeOpMorphoMaths(OPMORPHOMATHS_TYPE operationType, int dimension, int neighborhoodType)
+{
+    m_dimension        = dimension;
+    m_neighborhoodType = neighborhoodType;
+    if ((m_neighborhoodType == OPMORPHOMATHS_NEIGHBORHOOD_CUSTOM) && m_customNeighborhood)
+        m_dimension = m_customNeighborhood->getWidth() / 2;
+
+    initNeighborhood();
+
+    if (m_isValid)
+    {
+        initTiles();
+
+        switch (operationType)
+        {
+            case OPMORPHOMATHS_DILATION:
+                computeDilation();
+                break;
+
+            case OPMORPHOMATHS_EROSION:
+                computeErosion();
+                break;
+
+            case OPMORPHOMATHS_OPENING:
+                computeOpening();
+                break;
+
+            case OPMORPHOMATHS_CLOSING:
+                computeClosing();
+                break;
+
+            case OPMORPHOMATHS_INTERIOR_GRADIENT:
+                computeInteriorGradient();
+                break;
+
+            case OPMORPHOMATHS_EXTERIOR_GRADIENT:
+                computeExteriorGradient();
+                break;
+
+            case OPMORPHOMATHS_MORPHOLOGICAL_GRADIENT:
+                computeMorphologicalGradient();
+                break;
+
+            case OPMORPHOMATHS_TOP_HAT:
+                computeTopHat();
+                break;
+
+            case OPMORPHOMATHS_BOTTOM_HAT:
+                computeBottomHat();
+                break;
+
+            case OPMORPHOMATHS_LINE_OPENING:
+                computeLineOpening();
+                break;
+
+            case OPMORPHOMATHS_LINE_OPENING_BANK:
+                computeLineOpeningBank();
+                break;
+
+            case OPMORPHOMATHS_RANK_FILTER:
+                computeRankFilter();
+                break;
+
+            case OPMORPHOMATHS_HIT_OR_MISS:
+                computeHitOrMiss();
+                break;
+
+            case OPMORPHOMATHS_THINNING:
+                if (m_isBitParallel)
+                    computeThinningBitParallel();
+                else
+                    computeThinning();
+                break;
+
+            case OPMORPHOMATHS_SKELETONIZING:
+                if (m_isBitParallel)
+                    computeSkeletonizingBitParallel();
+                else
+                    computeSkeletonizing();
+                break;
+
+            case OPMORPHOMATHS_OPENING_BY_RECONSTRUCTION:
+                computeOpeningByReconstruction();
+                break;
+
+            case OPMORPHOMATHS_HOLE_FILLING:
+                computeHoleFilling();
+                break;
+
+            case OPMORPHOMATHS_REGIONAL_MAXIMA:
+                computeRegionalMaxima();
+                break;
+
+            case OPMORPHOMATHS_AREA_OPENING:
+                computeAreaOpening();
+                break;
+
+            case OPMORPHOMATHS_AREA_CLOSING:
+                computeAreaClosing();
+                break;
+
+            case OPMORPHOMATHS_ATTRIBUTE_OPENING:
+                computeAttributeOpening();
+                break;
+
+            case OPMORPHOMATHS_ATTRIBUTE_CLOSING:
+                computeAttributeClosing();
+                break;
+
+            case OPMORPHOMATHS_GRANULOMETRY:
+                computeGranulometry();
+                break;
+
+            // Include OPMORPHOMATHS_UNKNOWN
+            default:
+                break;
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Apply a batch of hit-or-miss templates in one sweep (the treated image is
+//! the union of the matches)
+//!
+//! @param hitOrMiss The compiled templates
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeHitOrMiss(CHitOrMiss *hitOrMiss)
+{
+    CBinaryImage *binaryImage    = nullptr;
+    CBinaryImage *hitOrMissImage = nullptr;
+
+    if (m_isValid && hitOrMiss)
+    {
+        binaryImage    = new CBinaryImage(m_imageGray);
+        hitOrMissImage = new CBinaryImage(m_imageGray->getWidth(), m_imageGray->getHeight());
+
+        if (binaryImage && hitOrMissImage)
+        {
+            hitOrMiss->compute(binaryImage, hitOrMissImage);
+            CBinaryImage2QImage(hitOrMissImage, m_imageTreated);
+        }
+    }
+
+    delete binaryImage;
+    delete hitOrMissImage;
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the morphological reconstruction by dilation of a marker under a
+//! mask with the hybrid algorithm of Vincent: one raster scan, one
+//! anti-raster scan which queues the pixels still able to propagate, then a
+//! FIFO propagation. The connectedness is 4 for the 4-connectedness
+//! neighborhood and 8 otherwise.
+//!
+//! @param marker The marker plane (replaced by the reconstruction)
+//! @param mask The mask plane
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeReconstructionByDilation(std::vector<uchar> &marker, const std::vector<uchar> &mask)
+{
+    // Neighbors scanned before the pixel in raster order (dx, dy), the
+    // anti-raster neighbors are the opposite ones
+    const int       neighbors8[4][2] = {{-1, 0}, {-1, -1}, {0, -1}, {1, -1}};
+    const int       neighbors4[2][2] = {{-1, 0}, {0, -1}};
+    const int(*neighbors)[2]         = neighbors8;
+    int             nNeighbors       = 4;
+    int             width;
+    int             height;
+    int             p;
+    int             q;
+    int             xq;
+    int             yq;
+    uchar           value;
+    std::queue<int> fifo;
+
+    if (!m_isValid || (marker.size() != m_plane.size()) || (mask.size() != m_plane.size()))
+        return;
+
+    width  = m_imageGray->getWidth();
+    height = m_imageGray->getHeight();
+    if (getConnectedness() == 4)
+    {
+        neighbors  = neighbors4;
+        nNeighbors = 2;
+    }
+
+    // Raster scan
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            p     = y * width + x;
+            value = marker[p];
+            for (int i = 0; i < nNeighbors; i++)
+            {
+                xq = x + neighbors[i][0];
+                yq = y + neighbors[i][1];
+                if ((xq >= 0) && (xq < width) && (yq >= 0))
+                    value = qMax(value, marker[yq * width + xq]);
+            }
+            marker[p] = qMin(value, mask[p]);
+        }
+    }
+
+    // Anti-raster scan
+    for (int y = height - 1; y >= 0; y--)
+    {
+        for (int x = width - 1; x >= 0; x--)
+        {
+            p     = y * width + x;
+            value = marker[p];
+            for (int i = 0; i < nNeighbors; i++)
+            {
+                xq = x - neighbors[i][0];
+                yq = y - neighbors[i][1];
+                if ((xq >= 0) && (xq < width) && (yq < height))
+                    value = qMax(value, marker[yq * width + xq]);
+            }
+            marker[p] = qMin(value, mask[p]);
+
+            for (int i = 0; i < nNeighbors; i++)
+            {
+                xq = x - neighbors[i][0];
+                yq = y - neighbors[i][1];
+                if ((xq >= 0) && (xq < width) && (yq < height))
+                {
+                    q = yq * width + xq;
+                    if ((marker[q] < marker[p]) && (marker[q] < mask[q]))
+                    {
+                        fifo.push(p);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    // FIFO propagation
+    while (!fifo.empty())
+    {
+        p = fifo.front();
+        fifo.pop();
+
+        for (int i = 0; i < nNeighbors; i++)
+        {
+            for (int sign = -1; sign <= 1; sign += 2)
+            {
+                xq = p % width + sign * neighbors[i][0];
+                yq = p / width + sign * neighbors[i][1];
+                if ((xq >= 0) && (xq < width) && (yq >= 0) && (yq < height))
+                {
+                    q = yq * width + xq;
+                    if ((marker[q] < marker[p]) && (mask[q] != marker[q]))
+                    {
+                        marker[q] = qMin(marker[p], mask[q]);
+                        fifo.push(q);
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the morphological reconstruction by erosion of a marker over a
+//! mask (dual of computeReconstructionByDilation)
+//!
+//! @param marker The marker plane (replaced by the reconstruction)
+//! @param mask The mask plane
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeReconstructionByErosion(std::vector<uchar> &marker, const std::vector<uchar> &mask)
+{
+    std::vector<uchar> negativeMask(mask.size());
+
+    for (size_t i = 0; i < mask.size(); i++)
+        negativeMask[i] = CIMAGEINT_MAX - mask[i];
+    for (size_t i = 0; i < marker.size(); i++)
+        marker[i] = CIMAGEINT_MAX - marker[i];
+
+    computeReconstructionByDilation(marker, negativeMask);
+
+    for (size_t i = 0; i < marker.size(); i++)
+        marker[i] = CIMAGEINT_MAX - marker[i];
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the area opening of a plane with the union-find algorithm of
+//! Meijster and Wilkinson: the pixels are processed by decreasing value and
+//! merged with their processed neighbors, a component being frozen as soon as
+//! its area reaches the threshold. The connected components (4 or 8 depending
+//! on the neighborhood type) of each threshold set smaller than the area are
+//! removed.
+//!
+//! @param plane The plane (replaced by the result)
+//! @param area The minimal area (in pixels) of the kept components
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeAreaOpening(std::vector<uchar> &plane, int area)
+{
+    const int        neighbors[8][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}, {-1, -1}, {1, -1}, {-1, 1}, {1, 1}};
+    int              nNeighbors      = getConnectedness();
+    int              nPixels         = static_cast<int>(plane.size());
+    int              width;
+    int              height;
+    int              histogram[CIMAGEINT_MAX + 1];
+    std::vector<int> sortedPixels(nPixels);
+    std::vector<int> parent(nPixels, -1);
+    std::vector<int> areas(nPixels);
+    int              p;
+    int              q;
+    int              r;
+    int              xq;
+    int              yq;
+
+    if (!m_isValid || (plane.size() != m_plane.size()))
+        return;
+
+    width  = m_imageGray->getWidth();
+    height = m_imageGray->getHeight();
+
+    // Counting sort by decreasing value
+    std::fill(histogram, histogram + CIMAGEINT_MAX + 1, 0);
+    for (int i = 0; i < nPixels; i++)
+        histogram[plane[i]]++;
+    for (int value = CIMAGEINT_MAX, position = 0; value >= 0; value--)
+    {
+        p                = histogram[value];
+        histogram[value] = position;
+        position += p;
+    }
+    for (int i = 0; i < nPixels; i++)
+        sortedPixels[histogram[plane[i]]++] = i;
+
+    // Union-find
+    for (int i = 0; i < nPixels; i++)
+    {
+        p         = sortedPixels[i];
+        parent[p] = p;
+        areas[p]  = 1;
+
+        for (int k = 0; k < nNeighbors; k++)
+        {
+            xq = p % width + neighbors[k][0];
+            yq = p / width + neighbors[k][1];
+            if ((xq < 0) || (xq >= width) || (yq < 0) || (yq >= height))
+                continue;
+
+            q = yq * width + xq;
+            if (parent[q] < 0)
+                continue;
+
+            r = findRoot(parent, q);
+            if (r != p)
+            {
+                if ((plane[r] == plane[p]) || (areas[r] < area))
+                {
+                    parent[r] = p;
+                    areas[p]  = qMin(areas[p] + areas[r], area);
+                }
+                else
+                {
+                    areas[p] = area;
+                }
+            }
+        }
+    }
+
+    // Resolution: the parents are processed before their children
+    for (int i = nPixels - 1; i >= 0; i--)
+    {
+        p = sortedPixels[i];
+        if (parent[p] != p)
+            plane[p] = plane[parent[p]];
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the area closing of a plane (dual of the area opening)
+//!
+//! @param plane The plane (replaced by the result)
+//! @param area The minimal area (in pixels) of the kept components of the
+//!        complementary
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeAreaClosing(std::vector<uchar> &plane, int area)
+{
+    for (size_t i = 0; i < plane.size(); i++)
+        plane[i] = CIMAGEINT_MAX - plane[i];
+
+    computeAreaOpening(plane, area);
+
+    for (size_t i = 0; i < plane.size(); i++)
+        plane[i] = CIMAGEINT_MAX - plane[i];
+}
+
+
+//------------------------------------------------------------------------------
+// Private Method(s):
+
+//------------------------------------------------------------------------------
+//! Create a grayscale image (binary) for a given image
+//!
+//! @param imageIn The input image
+//! @param imageOut The output image
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::createImageGray(QImage *imageIn, CImageInt *imageOut)
+{
+    int GOut;
+
+    if (imageIn && imageOut)
+    {
+        for (int x = 0; x < imageIn->width(); x++)
+        {
+            for (int y = 0; y < imageIn->height(); y++)
+            {
+                GOut = (299 * qRed(imageIn->pixel(x, y)) +
+                        587 * qGreen(imageIn->pixel(x, y)) +
+                        114 * qBlue(imageIn->pixel(x, y))) /
+                       1000;
+
+                if (GOut < 128)
+                    (*imageOut)(x, y) = 0;
+                else
+                    (*imageOut)(x, y) = CIMAGEINT_MAX;
+            }
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Create the luminance plane (8 bits) of a given image
+//!
+//! @param imageIn The input image
+//! @param planeOut The output plane
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::createLuminancePlane(QImage *imageIn, std::vector<uchar> &planeOut)
+{
+    const QRgb *line;
+
+    if (imageIn)
+    {
+        QImage imageRGB = imageIn->convertToFormat(QImage::Format_RGB32);
+
+        planeOut.resize(static_cast<size_t>(imageRGB.width()) * imageRGB.height());
+        for (int y = 0; y < imageRGB.height(); y++)
+        {
+            line = reinterpret_cast<const QRgb *>(imageRGB.constScanLine(y));
+            for (int x = 0; x < imageRGB.width(); x++)
+            {
+                planeOut[y * imageRGB.width() + x] = static_cast<uchar>((299 * qRed(line[x]) +
+                                                                         587 * qGreen(line[x]) +
+                                                                         114 * qBlue(line[x])) /
+                                                                        1000);
+            }
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Update the plane used by the operations: the luminance plane in grayscale
+//! mode, the binarized plane otherwise (same threshold as createImageGray).
+//! The component trees, the incremental planes and the run-length encoding of
+//! the previous plane are released.
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::updatePlane(void)
+{
+    m_maxTree.clear();
+    m_minTree.clear();
+    m_incrementalOperationType = OPMORPHOMATHS_UNKNOWN;
+    m_incrementalPlanes.clear();
+    delete m_runLengthImage;
+    m_runLengthImage = nullptr;
+    m_plane.resize(m_luminancePlane.size());
+    for (size_t i = 0; i < m_luminancePlane.size(); i++)
+    {
+        if (m_isGrayscale)
+            m_plane[i] = m_luminancePlane[i];
+        else
+            m_plane[i] = (m_luminancePlane[i] < 128) ? 0 : CIMAGEINT_MAX;
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Initialize the neighborhood depending on the type (see the
+//! computeOpMorphoMaths method) and compile it into runs, with its reflection
+//! (used by the second pass of the opening and of the closing, so that they
+//! stay anti-extensive and extensive with the one-sided neighborhoods). The
+//! neighborhood is kept until the type or the dimension changes.
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::initNeighborhood(void)
+{
+    if (m_neighborhood && (m_compiledNeighborhoodType == m_neighborhoodType) && (m_compiledDimension == m_dimension))
+        return;
+
+    delete m_neighborhood;
+    m_neighborhood = new CImageInt(m_dimension * 2 + 1, m_dimension * 2 + 1);
+
+    if (m_neighborhood)
+    {
+        switch (m_neighborhoodType)
+        {
+            case OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_4:
+                for (int x = 0; x < m_neighborhood->getWidth(); x++)
+                    (*m_neighborhood)(x, m_dimension) = CIMAGEINT_MAX;
+                for (int y = 0; y < m_neighborhood->getHeight(); y++)
+                    (*m_neighborhood)(m_dimension, y) = CIMAGEINT_MAX;
+                break;
+
+            case OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_8:
+                for (int x = 0; x < m_neighborhood->getWidth(); x++)
+                    for (int y = 0; y < m_neighborhood->getHeight(); y++)
+                        (*m_neighborhood)(x, y) = CIMAGEINT_MAX;
+                break;
+
+            case OPMORPHOMATHS_NEIGHBORHOOD_VERTICAL:
+                for (int y = 0; y < m_neighborhood->getHeight(); y++)
+                    (*m_neighborhood)(m_dimension, y) = CIMAGEINT_MAX;
+                break;
+
+            case OPMORPHOMATHS_NEIGHBORHOOD_HORIZONTAL:
+                for (int x = 0; x < m_neighborhood->getWidth(); x++)
+                    (*m_neighborhood)(x, m_dimension) = CIMAGEINT_MAX;
+                break;
+
+            case OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_4_UP:
+                for (int x = 0; x < m_neighborhood->getWidth(); x++)
+                    (*m_neighborhood)(x, m_dimension) = CIMAGEINT_MAX;
+                for (int y = 0; y <= m_dimension; y++)
+                    (*m_neighborhood)(m_dimension, y) = CIMAGEINT_MAX;
+                break;
+
+            case OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_4_DOWN:
+                for (int x = 0; x < m_neighborhood->getWidth(); x++)
+                    (*m_neighborhood)(x, m_dimension) = CIMAGEINT_MAX;
+                for (int y = m_dimension + 1; y < m_neighborhood->getHeight(); y++)
+                    (*m_neighborhood)(m_dimension, y) = CIMAGEINT_MAX;
+                break;
+
+            case OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_4_LEFT:
+                for (int x = 0; x <= m_dimension; x++)
+                    (*m_neighborhood)(x, m_dimension) = CIMAGEINT_MAX;
+                for (int y = 0; y < m_neighborhood->getHeight(); y++)
+                    (*m_neighborhood)(m_dimension, y) = CIMAGEINT_MAX;
+                break;
+
+            case OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_4_RIGHT:
+                for (int x = m_dimension + 1; x < m_neighborhood->getWidth(); x++)
+                    (*m_neighborhood)(x, m_dimension) = CIMAGEINT_MAX;
+                for (int y = 0; y < m_neighborhood->getHeight(); y++)
+                    (*m_neighborhood)(m_dimension, y) = CIMAGEINT_MAX;
+                break;
+
+            case OPMORPHOMATHS_NEIGHBORHOOD_CUSTOM:
+                if (m_customNeighborhood)
+                {
+                    // Centred crop (the granulometry uses the smaller
+                    // dimensions)
+                    int offset = m_customNeighborhood->getWidth() / 2 - m_dimension;
+
+                    for (int x = qMax(-offset, 0); x < qMin(m_neighborhood->getWidth(), m_customNeighborhood->getWidth() - offset); x++)
+                        for (int y = qMax(-offset, 0); y < qMin(m_neighborhood->getHeight(), m_customNeighborhood->getHeight() - offset); y++)
+                            (*m_neighborhood)(x, y) = m_customNeighborhood->get(x + offset, y + offset);
+                }
+                break;
+
+            case OPMORPHOMATHS_NEIGHBORHOOD_UNKNOWN:
+            default:
+                break;
+        }
+
+        CImageInt reflectedNeighborhood(m_neighborhood->getWidth(), m_neighborhood->getHeight());
+
+        for (int x = 0; x < m_neighborhood->getWidth(); x++)
+        {
+            for (int y = 0; y < m_neighborhood->getHeight(); y++)
+                reflectedNeighborhood(x, y) = m_neighborhood->get(m_neighborhood->getWidth() - 1 - x, m_neighborhood->getHeight() - 1 - y);
+        }
+
+        m_structuringElement.compile(m_neighborhood);
+        m_reflectedStructuringElement.compile(&reflectedNeighborhood);
+        m_compiledNeighborhoodType = m_neighborhoodType;
+        m_compiledDimension        = m_dimension;
+    }
+    else
+    {
+        m_structuringElement.clear();
+        m_reflectedStructuringElement.clear();
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Split the image into tiles (the tiling is kept for all the steps of a
+//! chained operation)
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::initTiles(void)
+{
+    SOpMorphoMathsTile tile;
+    int                width  = m_imageGray->getWidth();
+    int                height = m_imageGray->getHeight();
+
+    m_tiles.clear();
+    for (int y = 0; y < height; y += m_tileSize)
+    {
+        for (int x = 0; x < width; x += m_tileSize)
+        {
+            tile.x0 = x;
+            tile.y0 = y;
+            tile.x1 = qMin(x + m_tileSize, width);
+            tile.y1 = qMin(y + m_tileSize, height);
+            m_tiles.push_back(tile);
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Run a task on every tile with the worker pool
+//!
+//! @param task The task, called with the tile and a buffer owned by the
+//!        running thread
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::runTiled(const std::function<void(const SOpMorphoMathsTile &, std::vector<uchar> &)> &task)
+{
+    std::vector<std::vector<uchar>> buffers(qMax(m_nThreads, 1));
+
+    CParallel::runWithThreadIndex(static_cast<int>(m_tiles.size()), m_nThreads, [&](int noTile, int noThread) {
+        task(m_tiles[noTile], buffers[noThread]);
+    });
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the erosion and/or the dilation of one tile: the tile and its halo
+//! (the radius of the structuring element) are first copied into a local
+//! buffer, the pixels outside the image being set to the neutral value of the
+//! operation so that they are ignored. The running min/max of each run length
+//! of the structuring element is then computed on every row of the buffer,
+//! and each stack of runs is folded with a running min/max along the columns.
+//! The cost per pixel only depends on the number of stacks (1 for a square or
+//! a line, 3 for a cross), not on the dimension. The neighborhoods of
+//! dimension 1 and 2 use a kernel specialized at compile time instead. The
+//! result of a pixel only depends on the input image, so the tiled result is
+//! identical to the untiled one.
+//!
+//! @param structuringElement The compiled structuring element
+//! @param planeIn The input plane
+//! @param tile The tile to compute
+//! @param planeErosion The eroded plane (nullptr if not needed)
+//! @param planeDilation The dilated plane (nullptr if not needed)
+//! @param buffer The local buffer of the thread
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeTileMinMax(CStructuringElement &structuringElement, const uchar *planeIn, const SOpMorphoMathsTile &tile, uchar *planeErosion, uchar *planeDilation, std::vector<uchar> &buffer)
+{
+    int                     width        = m_imageGray->getWidth();
+    int                     height       = m_imageGray->getHeight();
+    int                     haloX        = structuringElement.getRadiusX();
+    int                     haloY        = structuringElement.getRadiusY();
+    int                     tileWidth    = tile.x1 - tile.x0;
+    int                     tileHeight   = tile.y1 - tile.y0;
+    int                     bufferWidth  = tileWidth + 2 * haloX;
+    int                     bufferHeight = tileHeight + 2 * haloY;
+    size_t                  bufferSize   = static_cast<size_t>(bufferWidth) * bufferHeight;
+    const std::vector<int> &runLengths   = structuringElement.getRunLengths();
+    uchar *                 planeOut;
+    uchar *                 pixelsIn;
+    uchar *                 pixelsRunning;
+    uchar *                 prefix;
+    uchar *                 suffix;
+    uchar                   neutral;
+    bool                    isDilation;
+    TOpMorphoMathsKernel    kernel;
+    int                     noRun;
+    int                     xIn;
+    int                     yIn;
+
+    buffer.resize(4 * bufferSize);
+    pixelsIn      = buffer.data();
+    pixelsRunning = pixelsIn + bufferSize;
+    prefix        = pixelsRunning + bufferSize;
+    suffix        = prefix + bufferSize;
+
+    for (int noOperation = 0; noOperation < 2; noOperation++)
+    {
+        planeOut   = (noOperation == 0) ? planeErosion : planeDilation;
+        neutral    = (noOperation == 0) ? CIMAGEINT_MAX : 0;
+        isDilation = (noOperation == 1);
+        if (!planeOut)
+            continue;
+
+        // Halo exchange
+        for (int y = 0; y < bufferHeight; y++)
+        {
+            yIn = tile.y0 - haloY + y;
+            for (int x = 0; x < bufferWidth; x++)
+            {
+                xIn = tile.x0 - haloX + x;
+                if ((xIn >= 0) && (xIn < width) && (yIn >= 0) && (yIn < height))
+                    pixelsIn[y * bufferWidth + x] = planeIn[yIn * width + xIn];
+                else
+                    pixelsIn[y * bufferWidth + x] = neutral;
+            }
+        }
+
+        // Specialized kernel of the small neighborhoods
+        kernel = findKernel(structuringElement, isDilation);
+        if (kernel)
+        {
+            kernel(pixelsIn, bufferWidth, tileWidth, tileHeight, planeOut + tile.y0 * width + tile.x0, width);
+            continue;
+        }
+
+        for (int y = tile.y0; y < tile.y1; y++)
+            std::fill(planeOut + y * width + tile.x0, planeOut + y * width + tile.x1, neutral);
+
+        noRun = 0;
+        for (size_t noLength = 0; noLength < runLengths.size(); noLength++)
+        {
+            for (int y = 0; y < bufferHeight; y++)
+                runningMinMax(pixelsIn + y * bufferWidth, bufferWidth, runLengths[noLength], isDilation, prefix, suffix, pixelsRunning + y * bufferWidth);
+
+            for (; (noRun < structuringElement.getNumberRuns()) && (structuringElement.getRun(noRun).length == runLengths[noLength]); noRun++)
+            {
+                const SStructuringElementRun &run = structuringElement.getRun(noRun);
+
+                foldColumnMinMax(pixelsRunning + (haloY + run.y) * bufferWidth + haloX + run.x0, bufferWidth,
+                                 tileHeight, tileWidth, run.height, isDilation, prefix, suffix,
+                                 planeOut + tile.y0 * width + tile.x0, width);
+            }
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the dilated image
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeDilation(void)
+{
+    if (m_isRunLength && !m_isGrayscale && isIncremental())
+    {
+        computeRunLength(OPMORPHOMATHS_DILATION);
+    }
+    else if (isIncremental())
+    {
+        computeIncrementalMinMax(OPMORPHOMATHS_DILATION);
+    }
+    else
+    {
+        std::vector<uchar> dilatedPlane(m_plane.size());
+
+        runTiled([&](const SOpMorphoMathsTile &tile, std::vector<uchar> &buffer) {
+            computeTileMinMax(m_structuringElement, m_plane.data(), tile, nullptr, dilatedPlane.data(), buffer);
+        });
+
+        plane2QImage(dilatedPlane, m_imageTreated);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the eroded image
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeErosion(void)
+{
+    if (m_isRunLength && !m_isGrayscale && isIncremental())
+    {
+        computeRunLength(OPMORPHOMATHS_EROSION);
+    }
+    else if (isIncremental())
+    {
+        computeIncrementalMinMax(OPMORPHOMATHS_EROSION);
+    }
+    else
+    {
+        std::vector<uchar> erodedPlane(m_plane.size());
+
+        runTiled([&](const SOpMorphoMathsTile &tile, std::vector<uchar> &buffer) {
+            computeTileMinMax(m_structuringElement, m_plane.data(), tile, erodedPlane.data(), nullptr, buffer);
+        });
+
+        plane2QImage(erodedPlane, m_imageTreated);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Check if the dilation and the erosion can be computed incrementally: for
+//! the square, horizontal and vertical neighborhoods, the neighborhood of
+//! dimension d + 1 is the one of dimension d dilated by the one of dimension 1
+//! (this is not the case for the crosses)
+//!
+//! @param _
+//!
+//! @return true if incremental
+//! @return false otherwise
+//------------------------------------------------------------------------------
+bool COpMorphoMaths::isIncremental(void)
+{
+    return (m_neighborhoodType == OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_8) ||
+           (m_neighborhoodType == OPMORPHOMATHS_NEIGHBORHOOD_VERTICAL) ||
+           (m_neighborhoodType == OPMORPHOMATHS_NEIGHBORHOOD_HORIZONTAL);
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the dilated or the eroded image from the closest result already
+//! computed for a lower dimension, one unit step at a time. The results of the
+//! last dimensions are kept (until the operation, the neighborhood or the mode
+//! changes), so that moving back the dimension costs nothing. A jump of more
+//! than OPMORPHOMATHS_INCREMENTAL_MAX_STEPS is computed directly.
+//!
+//! @param operationType OPMORPHOMATHS_DILATION or OPMORPHOMATHS_EROSION
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeIncrementalMinMax(OPMORPHOMATHS_TYPE operationType)
+{
+    bool                                        isDilation = (operationType == OPMORPHOMATHS_DILATION);
+    std::map<int, std::vector<uchar>>::iterator it;
+    std::map<int, std::vector<uchar>>::iterator itFarthest;
+    CImageInt                                   unitNeighborhood(3, 3);
+    int                                         dimension;
+
+    if ((m_incrementalOperationType != operationType) ||
+        (m_incrementalNeighborhoodType != m_neighborhoodType) ||
+        (m_incrementalIsGrayscale != m_isGrayscale))
+    {
+        m_incrementalOperationType    = operationType;
+        m_incrementalNeighborhoodType = m_neighborhoodType;
+        m_incrementalIsGrayscale      = m_isGrayscale;
+        m_incrementalPlanes.clear();
+        m_incrementalPlanes[0] = m_plane;
+
+        for (int i = 0; i < 3; i++)
+        {
+            if (m_neighborhoodType != OPMORPHOMATHS_NEIGHBORHOOD_VERTICAL)
+                unitNeighborhood(i, 1) = CIMAGEINT_MAX;
+            if (m_neighborhoodType != OPMORPHOMATHS_NEIGHBORHOOD_HORIZONTAL)
+                unitNeighborhood(1, i) = CIMAGEINT_MAX;
+            if (m_neighborhoodType == OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_8)
+            {
+                unitNeighborhood(i, 0) = CIMAGEINT_MAX;
+                unitNeighborhood(i, 2) = CIMAGEINT_MAX;
+            }
+        }
+        m_unitStructuringElement.compile(&unitNeighborhood);
+    }
+
+    // Closest result computed for a lower or equal dimension
+    it        = --m_incrementalPlanes.upper_bound(m_dimension);
+    dimension = it->first;
+
+    if (m_dimension - dimension > OPMORPHOMATHS_INCREMENTAL_MAX_STEPS)
+    {
+        std::vector<uchar> &planeOut = m_incrementalPlanes[m_dimension];
+
+        planeOut.resize(m_plane.size());
+        runTiled([&](const SOpMorphoMathsTile &tile, std::vector<uchar> &buffer) {
+            computeTileMinMax(m_structuringElement, m_plane.data(), tile, isDilation ? nullptr : planeOut.data(), isDilation ? planeOut.data() : nullptr, buffer);
+        });
+    }
+    else
+    {
+        for (; dimension < m_dimension; dimension++)
+        {
+            const std::vector<uchar> &planeIn  = m_incrementalPlanes[dimension];
+            std::vector<uchar> &      planeOut = m_incrementalPlanes[dimension + 1];
+
+            planeOut.resize(m_plane.size());
+            runTiled([&](const SOpMorphoMathsTile &tile, std::vector<uchar> &buffer) {
+                computeTileMinMax(m_unitStructuringElement, planeIn.data(), tile, isDilation ? nullptr : planeOut.data(), isDilation ? planeOut.data() : nullptr, buffer);
+            });
+        }
+    }
+
+    // Forget the results the farthest from the current dimension (the input
+    // plane, dimension 0, is always kept)
+    while (m_incrementalPlanes.size() > OPMORPHOMATHS_INCREMENTAL_MAX_PLANES)
+    {
+        itFarthest = ++m_incrementalPlanes.begin();
+        for (it = itFarthest; it != m_incrementalPlanes.end(); ++it)
+        {
+            if (qAbs(it->first - m_dimension) > qAbs(itFarthest->first - m_dimension))
+                itFarthest = it;
+        }
+        m_incrementalPlanes.erase(itFarthest);
+    }
+
+    plane2QImage(m_incrementalPlanes[m_dimension], m_imageTreated);
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the dilated, the eroded, the opened or the closed binary image by a
+//! square or a line on the run-length encoded image (encoded on the first
+//! call, see updatePlane). The opening and the closing chain the two
+//! operations on the runs (the square and the lines are symmetric).
+//!
+//! @param operationType OPMORPHOMATHS_DILATION, OPMORPHOMATHS_EROSION,
+//!                      OPMORPHOMATHS_OPENING or OPMORPHOMATHS_CLOSING
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeRunLength(OPMORPHOMATHS_TYPE operationType)
+{
+    CRunLengthImage runLengthImage(0, 0);
+    int             radiusX = (m_neighborhoodType == OPMORPHOMATHS_NEIGHBORHOOD_VERTICAL) ? 0 : m_dimension;
+    int             radiusY = (m_neighborhoodType == OPMORPHOMATHS_NEIGHBORHOOD_HORIZONTAL) ? 0 : m_dimension;
+
+    if (!m_runLengthImage)
+        m_runLengthImage = new CRunLengthImage(m_imageGray);
+
+    if (m_runLengthImage)
+    {
+        switch (operationType)
+        {
+            case OPMORPHOMATHS_DILATION:
+                m_runLengthImage->dilate(radiusX, radiusY, &runLengthImage);
+                break;
+
+            case OPMORPHOMATHS_EROSION:
+                m_runLengthImage->erode(radiusX, radiusY, &runLengthImage);
+                break;
+
+            case OPMORPHOMATHS_OPENING:
+                m_runLengthImage->erode(radiusX, radiusY, &runLengthImage);
+                runLengthImage.dilate(radiusX, radiusY, &runLengthImage);
+                break;
+
+            case OPMORPHOMATHS_CLOSING:
+                m_runLengthImage->dilate(radiusX, radiusY, &runLengthImage);
+                runLengthImage.erode(radiusX, radiusY, &runLengthImage);
+                break;
+
+            default:
+                break;
+        }
+
+        CRunLengthImage2QImage(&runLengthImage, m_imageTreated);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the "opened" image: erosion by the structuring element, then
+//! dilation by its reflection
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeOpening(void)
+{
+    std::vector<uchar> erodedPlane;
+    std::vector<uchar> openedPlane;
+
+    if (m_isRunLength && !m_isGrayscale && isIncremental())
+    {
+        computeRunLength(OPMORPHOMATHS_OPENING);
+        return;
+    }
+
+    erodedPlane.resize(m_plane.size());
+    openedPlane.resize(m_plane.size());
+    runTiled([&](const SOpMorphoMathsTile &tile, std::vector<uchar> &buffer) {
+        computeTileMinMax(m_structuringElement, m_plane.data(), tile, erodedPlane.data(), nullptr, buffer);
+    });
+    runTiled([&](const SOpMorphoMathsTile &tile, std::vector<uchar> &buffer) {
+        computeTileMinMax(m_reflectedStructuringElement, erodedPlane.data(), tile, nullptr, openedPlane.data(), buffer);
+    });
+
+    plane2QImage(openedPlane, m_imageTreated);
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the "closed" image: dilation by the structuring element, then
+//! erosion by its reflection
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeClosing(void)
+{
+    std::vector<uchar> dilatedPlane;
+    std::vector<uchar> closedPlane;
+
+    if (m_isRunLength && !m_isGrayscale && isIncremental())
+    {
+        computeRunLength(OPMORPHOMATHS_CLOSING);
+        return;
+    }
+
+    dilatedPlane.resize(m_plane.size());
+    closedPlane.resize(m_plane.size());
+    runTiled([&](const SOpMorphoMathsTile &tile, std::vector<uchar> &buffer) {
+        computeTileMinMax(m_structuringElement, m_plane.data(), tile, nullptr, dilatedPlane.data(), buffer);
+    });
+    runTiled([&](const SOpMorphoMathsTile &tile, std::vector<uchar> &buffer) {
+        computeTileMinMax(m_reflectedStructuringElement, dilatedPlane.data(), tile, closedPlane.data(), nullptr, buffer);
+    });
+
+    plane2QImage(closedPlane, m_imageTreated);
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the interior gradient of the image
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeInteriorGradient(void)
+{
+    std::vector<uchar> gradientPlane(m_plane.size());
+    int                width = m_imageGray->getWidth();
+
+    runTiled([&](const SOpMorphoMathsTile &tile, std::vector<uchar> &buffer) {
+        computeTileMinMax(m_structuringElement, m_plane.data(), tile, gradientPlane.data(), nullptr, buffer);
+        for (int y = tile.y0; y < tile.y1; y++)
+        {
+            for (int x = tile.x0; x < tile.x1; x++)
+                gradientPlane[y * width + x] = m_plane[y * width + x] - gradientPlane[y * width + x];
+        }
+    });
+
+    plane2QImage(gradientPlane, m_imageTreated);
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the exterior gradient of the image
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeExteriorGradient(void)
+{
+    std::vector<uchar> gradientPlane(m_plane.size());
+    int                width = m_imageGray->getWidth();
+
+    runTiled([&](const SOpMorphoMathsTile &tile, std::vector<uchar> &buffer) {
+        computeTileMinMax(m_structuringElement, m_plane.data(), tile, nullptr, gradientPlane.data(), buffer);
+        for (int y = tile.y0; y < tile.y1; y++)
+        {
+            for (int x = tile.x0; x < tile.x1; x++)
+                gradientPlane[y * width + x] = gradientPlane[y * width + x] - m_plane[y * width + x];
+        }
+    });
+
+    plane2QImage(gradientPlane, m_imageTreated);
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the morphological gradient of the image
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeMorphologicalGradient(void)
+{
+    std::vector<uchar> gradientPlane(m_plane.size());
+    std::vector<uchar> erodedPlane(m_plane.size());
+    int                width = m_imageGray->getWidth();
+
+    runTiled([&](const SOpMorphoMathsTile &tile, std::vector<uchar> &buffer) {
+        computeTileMinMax(m_structuringElement, m_plane.data(), tile, erodedPlane.data(), gradientPlane.data(), buffer);
+        for (int y = tile.y0; y < tile.y1; y++)
+        {
+            for (int x = tile.x0; x < tile.x1; x++)
+                gradientPlane[y * width + x] = gradientPlane[y * width + x] - erodedPlane[y * width + x];
+        }
+    });
+
+    plane2QImage(gradientPlane, m_imageTreated);
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the white top-hat of the image (image - opening): the difference
+//! is computed by the dilation pass (reflected structuring element, so that
+//! the opening is below the image), tile per tile, without any intermediate
+//! opened image
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeTopHat(void)
+{
+    std::vector<uchar> erodedPlane(m_plane.size());
+    std::vector<uchar> topHatPlane(m_plane.size());
+    int                width = m_imageGray->getWidth();
+
+    runTiled([&](const SOpMorphoMathsTile &tile, std::vector<uchar> &buffer) {
+        computeTileMinMax(m_structuringElement, m_plane.data(), tile, erodedPlane.data(), nullptr, buffer);
+    });
+    runTiled([&](const SOpMorphoMathsTile &tile, std::vector<uchar> &buffer) {
+        computeTileMinMax(m_reflectedStructuringElement, erodedPlane.data(), tile, nullptr, topHatPlane.data(), buffer);
+        for (int y = tile.y0; y < tile.y1; y++)
+        {
+            for (int x = tile.x0; x < tile.x1; x++)
+                topHatPlane[y * width + x] = m_plane[y * width + x] - topHatPlane[y * width + x];
+        }
+    });
+
+    plane2QImage(topHatPlane, m_imageTreated);
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the black top-hat (bottom-hat) of the image (closing - image): the
+//! difference is computed by the erosion pass (reflected structuring element,
+//! so that the closing is above the image), tile per tile, without any
+//! intermediate closed image
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeBottomHat(void)
+{
+    std::vector<uchar> dilatedPlane(m_plane.size());
+    std::vector<uchar> bottomHatPlane(m_plane.size());
+    int                width = m_imageGray->getWidth();
+
+    runTiled([&](const SOpMorphoMathsTile &tile, std::vector<uchar> &buffer) {
+        computeTileMinMax(m_structuringElement, m_plane.data(), tile, nullptr, dilatedPlane.data(), buffer);
+    });
+    runTiled([&](const SOpMorphoMathsTile &tile, std::vector<uchar> &buffer) {
+        computeTileMinMax(m_reflectedStructuringElement, dilatedPlane.data(), tile, bottomHatPlane.data(), nullptr, buffer);
+        for (int y = tile.y0; y < tile.y1; y++)
+        {
+            for (int x = tile.x0; x < tile.x1; x++)
+                bottomHatPlane[y * width + x] = bottomHatPlane[y * width + x] - m_plane[y * width + x];
+        }
+    });
+
+    plane2QImage(bottomHatPlane, m_imageTreated);
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the opening of the image by a line of length 2 * dimension + 1 and
+//! of any angle
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeLineOpening(void)
+{
+    std::vector<uchar> openedPlane(m_plane.size());
+
+    computeLineOpening(m_plane.data(), m_lineAngle, false, openedPlane.data());
+
+    plane2QImage(openedPlane, m_imageTreated);
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the supremum of the openings of the image by the lines of length
+//! 2 * dimension + 1 for the orientations 0, 180 / n ... 180 * (n - 1) / n
+//! (keeps the thin structures of any orientation, such as the scratches)
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeLineOpeningBank(void)
+{
+    std::vector<uchar> openedPlane(m_plane.size(), 0);
+
+    for (int noOrientation = 0; noOrientation < m_nOrientations; noOrientation++)
+        computeLineOpening(m_plane.data(), 180.0 * noOrientation / m_nOrientations, true, openedPlane.data());
+
+    plane2QImage(openedPlane, m_imageTreated);
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the opening of a plane by a line of length 2 * dimension + 1: the
+//! image is covered by the translations of a Bresenham line of the given
+//! angle (along the columns for the lines closer to the horizontal, along the
+//! rows otherwise), each pixel belonging to a single path. The erosion and
+//! the dilation are computed along each path with the van Herk/Gil-Werman
+//! running min/max, so the cost per pixel does not depend on the length. The
+//! line is the 2 * dimension + 1 consecutive pixels of the path, the pixels
+//! outside the image are ignored. The paths are distributed on the threads.
+//!
+//! @param planeIn The input plane
+//! @param angle The angle of the line (in degrees, counterclockwise from the
+//!        horizontal)
+//! @param isMerged true to keep the maximum of planeOut and of the opening,
+//!        false to overwrite planeOut
+//! @param planeOut The output plane
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeLineOpening(const uchar *planeIn, qreal angle, bool isMerged, uchar *planeOut)
+{
+    int                             width       = m_imageGray->getWidth();
+    int                             height      = m_imageGray->getHeight();
+    int                             radius      = m_dimension;
+    qreal                           radianAngle = angle * M_PI / 180;
+    bool                            isXMajor    = qAbs(qCos(radianAngle)) >= qAbs(qSin(radianAngle));
+    int                             nMajor      = isXMajor ? width : height;
+    int                             nMinor      = isXMajor ? height : width;
+    int                             strideMajor = isXMajor ? 1 : width;
+    int                             strideMinor = isXMajor ? width : 1;
+    qreal                           slope;
+    std::vector<int>                offsets(nMajor);
+    std::vector<std::vector<uchar>> buffers(qMax(m_nThreads, 1));
+    int                             offsetMin;
+    int                             offsetMax;
+
+    // Offset of the minor coordinate along the Bresenham line (y grows
+    // downward)
+    slope = isXMajor ? -qSin(radianAngle) / qCos(radianAngle) : -qCos(radianAngle) / qSin(radianAngle);
+    for (int i = 0; i < nMajor; i++)
+        offsets[i] = qRound(i * slope);
+    offsetMin = *std::min_element(offsets.begin(), offsets.end());
+    offsetMax = *std::max_element(offsets.begin(), offsets.end());
+
+    // Path k: the pixels (i, k - offsetMax + offsets[i]) inside the image
+    CParallel::runWithThreadIndex(nMinor + offsetMax - offsetMin, m_nThreads, [&](int noPath, int noThread) {
+        std::vector<uchar> &buffer = buffers[noThread];
+        int                 minor0 = noPath - offsetMax;
+        int                 first  = -1;
+        int                 n      = 0;
+        int                 nPadded;
+        uchar *             values;
+        uchar *             prefix;
+        uchar *             suffix;
+        uchar *             eroded;
+        int                 minor;
+
+        for (int i = 0; i < nMajor; i++)
+        {
+            minor = minor0 + offsets[i];
+            if ((minor >= 0) && (minor < nMinor))
+            {
+                if (first < 0)
+                    first = i;
+                n++;
+            }
+        }
+
+        if (n > 0)
+        {
+            nPadded = n + 2 * radius;
+            buffer.resize(4 * static_cast<size_t>(nPadded));
+            values = buffer.data();
+            prefix = values + nPadded;
+            suffix = prefix + nPadded;
+            eroded = suffix + nPadded;
+
+            // Erosion, the pixels outside the image set to the neutral value
+            std::fill(values, values + nPadded, CIMAGEINT_MAX);
+            for (int i = 0; i < n; i++)
+                values[radius + i] = planeIn[(first + i) * strideMajor + (minor0 + offsets[first + i]) * strideMinor];
+            runningMinMax(values, nPadded, 2 * radius + 1, false, prefix, suffix, eroded + radius);
+
+            // Dilation of the eroded path
+            std::fill(eroded, eroded + radius, 0);
+            std::fill(eroded + radius + n, eroded + nPadded, 0);
+            runningMinMax(eroded, nPadded, 2 * radius + 1, true, prefix, suffix, values);
+
+            for (int i = 0; i < n; i++)
+            {
+                uchar &pixelOut = planeOut[(first + i) * strideMajor + (minor0 + offsets[first + i]) * strideMinor];
+
+                pixelOut = isMerged ? qMax(pixelOut, values[i]) : values[i];
+            }
+        }
+    });
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the rank filter of the image for the percentile (the median by
+//! default) over the neighborhood, the pixels outside the image being
+//! ignored. The histogram of the neighborhood slides along each row of a
+//! tile, and the rank is found in a two-level histogram. The stacks of runs
+//! of at least OPMORPHOMATHS_RANK_MIN_COLUMN_HEIGHT rows keep one histogram
+//! per column (Perreault-Hebert): the column histograms move down by one
+//! pixel per row, and the histogram of the neighborhood is slid by
+//! subtracting the leaving column and adding the entering one, so the cost
+//! per pixel does not depend on the height of the neighborhood. The shorter
+//! stacks slide pixel by pixel (Huang).
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeRankFilter(void)
+{
+    std::vector<uchar> rankPlane(m_plane.size());
+    int                width  = m_imageGray->getWidth();
+    int                height = m_imageGray->getHeight();
+
+    runTiled([&](const SOpMorphoMathsTile &tile, std::vector<uchar> &) {
+        std::vector<int> columnHistograms;
+        std::vector<int> emptyColumn(OPMORPHOMATHS_RANK_HISTOGRAM_SIZE, 0);
+        std::vector<int> firstColumns(m_structuringElement.getNumberRuns(), 0);
+        std::vector<int> offsets(m_structuringElement.getNumberRuns(), -1);
+        std::vector<int> nRows(m_structuringElement.getNumberRuns(), 0);
+        int              histogram[OPMORPHOMATHS_RANK_HISTOGRAM_SIZE];
+        int *            levels = histogram;
+        int *            groups = histogram + 256;
+        int *            column;
+        const int *      columnOut;
+        const int *      columnIn;
+        int              count;
+        int              yIn;
+        int              xIn;
+        int              xMax;
+
+        // Columns of the stacks with column histograms: the columns entering
+        // and leaving the neighborhood of the pixels of the tile
+        for (int noRun = 0; noRun < m_structuringElement.getNumberRuns(); noRun++)
+        {
+            const SStructuringElementRun &run = m_structuringElement.getRun(noRun);
+
+            if (run.height >= OPMORPHOMATHS_RANK_MIN_COLUMN_HEIGHT)
+            {
+                firstColumns[noRun] = qMax(tile.x0 + run.x0, 0);
+                xMax                = qMin(tile.x1 + run.x0 + run.length, width);
+                offsets[noRun]      = static_cast<int>(columnHistograms.size());
+                columnHistograms.resize(columnHistograms.size() + qMax(xMax - firstColumns[noRun], 0) * OPMORPHOMATHS_RANK_HISTOGRAM_SIZE, 0);
+            }
+        }
+
+        for (int y = tile.y0; y < tile.y1; y++)
+        {
+            // Move the column histograms to the row
+            for (int noRun = 0; noRun < m_structuringElement.getNumberRuns(); noRun++)
+            {
+                const SStructuringElementRun &run = m_structuringElement.getRun(noRun);
+
+                if (offsets[noRun] < 0)
+                    continue;
+
+                nRows[noRun] = qMax(qMin(y + run.y + run.height, height) - qMax(y + run.y, 0), 0);
+                column       = columnHistograms.data() + offsets[noRun];
+                xMax         = qMin(tile.x1 + run.x0 + run.length, width);
+                for (xIn = firstColumns[noRun]; xIn < xMax; xIn++, column += OPMORPHOMATHS_RANK_HISTOGRAM_SIZE)
+                {
+                    if (y == tile.y0)
+                    {
+                        for (yIn = qMax(y + run.y, 0); yIn < qMin(y + run.y + run.height, height); yIn++)
+                            addToHistogram(column, column + 256, m_plane[yIn * width + xIn], 1);
+                    }
+                    else
+                    {
+                        yIn = y - 1 + run.y;
+                        if ((yIn >= 0) && (yIn < height))
+                            addToHistogram(column, column + 256, m_plane[yIn * width + xIn], -1);
+                        yIn += run.height;
+                        if ((yIn >= 0) && (yIn < height))
+                            addToHistogram(column, column + 256, m_plane[yIn * width + xIn], 1);
+                    }
+                }
+            }
+
+            // Histogram of the neighborhood of the first pixel of the row
+            std::fill(histogram, histogram + OPMORPHOMATHS_RANK_HISTOGRAM_SIZE, 0);
+            count = 0;
+            for (int noRun = 0; noRun < m_structuringElement.getNumberRuns(); noRun++)
+            {
+                const SStructuringElementRun &run = m_structuringElement.getRun(noRun);
+
+                for (xIn = qMax(tile.x0 + run.x0, 0); xIn < qMin(tile.x0 + run.x0 + run.length, width); xIn++)
+                {
+                    if (offsets[noRun] >= 0)
+                    {
+                        slideHistogram(histogram, emptyColumn.data(), columnHistograms.data() + offsets[noRun] + (xIn - firstColumns[noRun]) * OPMORPHOMATHS_RANK_HISTOGRAM_SIZE);
+                        count += nRows[noRun];
+                    }
+                    else
+                    {
+                        for (yIn = qMax(y + run.y, 0); yIn < qMin(y + run.y + run.height, height); yIn++)
+                        {
+                            addToHistogram(levels, groups, m_plane[yIn * width + xIn], 1);
+                            count++;
+                        }
+                    }
+                }
+            }
+
+            for (int x = tile.x0; x < tile.x1; x++)
+            {
+                if (count > 0)
+                    rankPlane[y * width + x] = findRank(levels, groups, (count - 1) * m_percentile / 100);
+                else
+                    rankPlane[y * width + x] = m_plane[y * width + x];
+
+                // Slide the neighborhood to the next pixel
+                for (int noRun = 0; noRun < m_structuringElement.getNumberRuns(); noRun++)
+                {
+                    const SStructuringElementRun &run = m_structuringElement.getRun(noRun);
+
+                    if (offsets[noRun] >= 0)
+                    {
+                        columnOut = emptyColumn.data();
+                        columnIn  = emptyColumn.data();
+                        xIn       = x + run.x0;
+                        if ((xIn >= 0) && (xIn < width))
+                        {
+                            columnOut = columnHistograms.data() + offsets[noRun] + (xIn - firstColumns[noRun]) * OPMORPHOMATHS_RANK_HISTOGRAM_SIZE;
+                            count -= nRows[noRun];
+                        }
+                        xIn += run.length;
+                        if ((xIn >= 0) && (xIn < width))
+                        {
+                            columnIn = columnHistograms.data() + offsets[noRun] + (xIn - firstColumns[noRun]) * OPMORPHOMATHS_RANK_HISTOGRAM_SIZE;
+                            count += nRows[noRun];
+                        }
+                        slideHistogram(histogram, columnOut, columnIn);
+                        continue;
+                    }
+
+                    for (yIn = qMax(y + run.y, 0); yIn < qMin(y + run.y + run.height, height); yIn++)
+                    {
+                        xIn = x + run.x0;
+                        if ((xIn >= 0) && (xIn < width))
+                        {
+                            addToHistogram(levels, groups, m_plane[yIn * width + xIn], -1);
+                            count--;
+                        }
+                        xIn += run.length;
+                        if ((xIn >= 0) && (xIn < width))
+                        {
+                            addToHistogram(levels, groups, m_plane[yIn * width + xIn], 1);
+                            count++;
+                        }
+                    }
+                }
+            }
+        }
+    });
+
+    plane2QImage(rankPlane, m_imageTreated);
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the "hit or miss" transformation of the image: the neighborhood
+//! (pixels to hit) and its local complementary (pixels to miss) are compiled
+//! into a single template evaluated in one pass
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeHitOrMiss(void)
+{
+    CHitOrMiss hitOrMiss;
+
+    if (hitOrMiss.addTemplate(m_neighborhood))
+        computeHitOrMiss(&hitOrMiss);
+    else
+        computeHitOrMissByErosions();
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the "hit or miss" transformation of the image with two erosions
+//! (used when the neighborhood is too large for CHitOrMiss)
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeHitOrMissByErosions(void)
+{
+    CImageInt *erodedImage1                   = nullptr;
+    CImageInt *erodedImage2                   = nullptr;
+    CImageInt *negativeImage                  = nullptr;
+    CImageInt *intersectionImage              = nullptr;
+    CImageInt *localComplementaryNeighborhood = nullptr;
+
+    erodedImage1  = m_imageGray->opErosion(m_neighborhood);
+    negativeImage = m_imageGray->opNegative();
+    if (negativeImage)
+    {
+        localComplementaryNeighborhood = m_neighborhood->opLocalComplementary();
+
+        if (localComplementaryNeighborhood)
+            erodedImage2 = negativeImage->opErosion(localComplementaryNeighborhood);
+    }
+    if (erodedImage1)
+        intersectionImage = erodedImage1->opIntersection(erodedImage2);
+
+    CImage2QImage(intersectionImage, m_imageTreated);
+
+    delete erodedImage1;
+    delete erodedImage2;
+    delete negativeImage;
+    delete intersectionImage;
+    delete localComplementaryNeighborhood;
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the thinness image
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+bool COpMorphoMaths::computeThinning(void)
+{
+    CImageInt * thinImage = new CImageInt(m_imageGray->getWidth(), m_imageGray->getHeight(), m_imageGray);
+    CImageBool *passImage = new CImageBool(m_imageGray->getWidth(), m_imageGray->getHeight());
+    bool        ret       = false;
+    int         nNeighbors;
+    int         nTransitions;
+    bool        conditionConnection;
+    int         v0, v1, v2, v3, v4, v5, v6, v7;
+
+    if (thinImage && passImage)
+    {
+        for (int i = 0; i < m_dimension; i++)
+        {
+            for (int noPass = 1; noPass <= 2; noPass++)
+            {
+                passImage->reset();
+
+                for (int x = 0; x < thinImage->getWidth(); x++)
+                {
+                    for (int y = 0; y < thinImage->getHeight(); y++)
+                    {
+                        if (thinImage->get(x, y) != 0)
+                        {
+                            v0 = ((thinImage->get(x, y + 1) == 0) ? 0 : 1);
+                            v1 = ((thinImage->get(x + 1, y + 1) == 0) ? 0 : 1);
+                            v2 = ((thinImage->get(x + 1, y) == 0) ? 0 : 1);
+                            v3 = ((thinImage->get(x + 1, y - 1) == 0) ? 0 : 1);
+                            v4 = ((thinImage->get(x, y - 1) == 0) ? 0 : 1);
+                            v5 = ((thinImage->get(x - 1, y - 1) == 0) ? 0 : 1);
+                            v6 = ((thinImage->get(x - 1, y) == 0) ? 0 : 1);
+                            v7 = ((thinImage->get(x - 1, y + 1) == 0) ? 0 : 1);
+
+                            if (noPass == 1)
+                                conditionConnection = (!v0 || !v2 || !v4) && (!v2 || !v4 || !v6);
+                            else
+                                conditionConnection = (!v0 || !v2 || !v6) && (!v0 || !v4 || !v6);
+
+                            nTransitions = 0;
+                            if (v0 && !v1)
+                                nTransitions++;
+                            if (v1 && !v2)
+                                nTransitions++;
+                            if (v2 && !v3)
+                                nTransitions++;
+                            if (v3 && !v4)
+                                nTransitions++;
+                            if (v4 && !v5)
+                                nTransitions++;
+                            if (v5 && !v6)
+                                nTransitions++;
+                            if (v6 && !v7)
+                                nTransitions++;
+                            if (v7 && !v0)
+                                nTransitions++;
+
+                            nNeighbors = v0 + v1 + v2 + v3 + v4 + v5 + v6 + v7;
+
+                            if ((nNeighbors >= 2) &&
+                                (nNeighbors <= 6) &&
+                                (nTransitions == 1) &&
+                                conditionConnection)
+                            {
+                                (*passImage)(x, y) = true;
+                                ret                = true;
+                            }
+                        }
+                    }
+                }
+
+                for (int x = 0; x < thinImage->getWidth(); x++)
+                {
+                    for (int y = 0; y < thinImage->getHeight(); y++)
+                    {
+                        if (passImage->get(x, y))
+                            (*thinImage)(x, y) = 0;
+                    }
+                }
+            }
+        }
+    }
+
+    CImage2QImage(thinImage, m_imageTreated);
+
+    delete thinImage;
+    delete passImage;
+
+    return ret;
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute one pass of the thinning on a packed binary image: the Zhang-Suen
+//! conditions are evaluated with bitwise logic on the shifted neighbor words,
+//! 64 pixels at a time. The pixels are removed only after the evaluation of
+//! their row and of the next one, as in computeThinning.
+//!
+//! @param image The packed binary image (updated)
+//! @param noPass The pass number (1 or 2)
+//!
+//! @return true if at least one pixel has been removed
+//! @return false otherwise
+//------------------------------------------------------------------------------
+bool COpMorphoMaths::computeThinningPass(CBinaryImage *image, int noPass)
+{
+    int                  nWords = image->getWordsPerRow();
+    std::vector<quint64> previousRow(nWords, 0);
+    std::vector<quint64> currentRow(nWords, 0);
+    std::vector<quint64> emptyRow(nWords, 0);
+    quint64 *            row;
+    const quint64 *      nextRow;
+    quint64              v0, v1, v2, v3, v4, v5, v6, v7;
+    quint64              c0, c1, c2, c3;
+    quint64              transition, oneTransition, twoTransitions;
+    quint64              conditionNeighbors;
+    quint64              conditionConnection;
+    quint64              removed;
+    bool                 ret = false;
+
+    for (int y = 0; y < image->getHeight(); y++)
+    {
+        row     = image->getRow(y);
+        nextRow = (y + 1 < image->getHeight()) ? image->getRow(y + 1) : emptyRow.data();
+        std::copy(row, row + nWords, currentRow.begin());
+
+        for (int w = 0; w < nWords; w++)
+        {
+            if (currentRow[w] == 0)
+                continue;
+
+            v0 = nextRow[w];
+            v1 = shiftEast(nextRow, w, nWords);
+            v2 = shiftEast(currentRow.data(), w, nWords);
+            v3 = shiftEast(previousRow.data(), w, nWords);
+            v4 = previousRow[w];
+            v5 = shiftWest(previousRow.data(), w);
+            v6 = shiftWest(currentRow.data(), w);
+            v7 = shiftWest(nextRow, w);
+
+            // Neighbor count in [2, 6]
+            c0 = c1 = c2 = c3 = 0;
+            addBitPlane(v0, c0, c1, c2, c3);
+            addBitPlane(v1, c0, c1, c2, c3);
+            addBitPlane(v2, c0, c1, c2, c3);
+            addBitPlane(v3, c0, c1, c2, c3);
+            addBitPlane(v4, c0, c1, c2, c3);
+            addBitPlane(v5, c0, c1, c2, c3);
+            addBitPlane(v6, c0, c1, c2, c3);
+            addBitPlane(v7, c0, c1, c2, c3);
+            conditionNeighbors = (c1 | c2) & ~c3 & ~(c2 & c1 & c0);
+
+            // Exactly one transition in the cyclic sequence v0, ..., v7, v0
+            oneTransition  = 0;
+            twoTransitions = 0;
+            transition     = v0 & ~v1;
+            oneTransition |= transition;
+            transition = v1 & ~v2;
+            twoTransitions |= oneTransition & transition;
+            oneTransition |= transition;
+            transition = v2 & ~v3;
+            twoTransitions |= oneTransition & transition;
+            oneTransition |= transition;
+            transition = v3 & ~v4;
+            twoTransitions |= oneTransition & transition;
+            oneTransition |= transition;
+            transition = v4 & ~v5;
+            twoTransitions |= oneTransition & transition;
+            oneTransition |= transition;
+            transition = v5 & ~v6;
+            twoTransitions |= oneTransition & transition;
+            oneTransition |= transition;
+            transition = v6 & ~v7;
+            twoTransitions |= oneTransition & transition;
+            oneTransition |= transition;
+            transition = v7 & ~v0;
+            twoTransitions |= oneTransition & transition;
+            oneTransition |= transition;
+
+            if (noPass == 1)
+                conditionConnection = ~(v0 & v2 & v4) & ~(v2 & v4 & v6);
+            else
+                conditionConnection = ~(v0 & v2 & v6) & ~(v0 & v4 & v6);
+
+            removed = currentRow[w] & conditionNeighbors & oneTransition & ~twoTransitions & conditionConnection;
+            if (removed)
+            {
+                row[w] &= ~removed;
+                ret = true;
+            }
+        }
+
+        previousRow.swap(currentRow);
+    }
+
+    return ret;
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the thinness image on the packed binary image (same result as
+//! computeThinning)
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeThinningBitParallel(void)
+{
+    CBinaryImage *thinImage = new CBinaryImage(m_imageGray);
+    bool          thinning  = true;
+
+    if (thinImage)
+    {
+        for (int i = 0; (i < m_dimension) && thinning; i++)
+        {
+            thinning = computeThinningPass(thinImage, 1);
+            thinning = computeThinningPass(thinImage, 2) || thinning;
+        }
+
+        CBinaryImage2QImage(thinImage, m_imageTreated);
+    }
+
+    delete thinImage;
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the skeletonized image
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeSkeletonizing(void)
+{
+    bool thinning;
 
-            case OPMORPHOMATHS_NEIGHBORHOOD_UNKNOWN:
-            default:
-                break;
-        }
-    }
+    m_dimension = 1;
+
+    do
+    {
+        thinning = computeThinning();
+        createImageGray(m_imageTreated, m_imageGray);
+    } while (thinning);
+
+    // The gray image is now the skeleton: the plane of the tiled operations
+    // follows it
+    createLuminancePlane(m_imageTreated, m_luminancePlane);
+    updatePlane();
 }
 
 
 //------------------------------------------------------------------------------
-//! Compute the dilated image
+//! Compute the skeletonized image on the packed binary image: the thinning
+//! passes are iterated in place until stability, without going back to the
+//! QImage between two iterations. As with computeSkeletonizing, the gray image
+//! and the plane of the tiled operations are then replaced by the skeleton.
 //!
 //! @param _
 //!
 //! @return _
 //------------------------------------------------------------------------------
-void COpMorphoMaths::computeDilation(void)
+void COpMorphoMaths::computeSkeletonizingBitParallel(void)
 {
-    CImageInt *dilateImage = nullptr;
+    CBinaryImage *skeletonImage = new CBinaryImage(m_imageGray);
+    bool          thinning      = true;
+
+    if (skeletonImage)
+    {
+        while (thinning)
+        {
+            thinning = computeThinningPass(skeletonImage, 1);
+            thinning = computeThinningPass(skeletonImage, 2) || thinning;
+        }
 
-    dilateImage = m_imageGray->opDilation(m_neighborhood);
-    CImage2QImage(dilateImage, m_imageTreated);
+        CBinaryImage2QImage(skeletonImage, m_imageTreated);
+        createImageGray(m_imageTreated, m_imageGray);
+        createLuminancePlane(m_imageTreated, m_luminancePlane);
+        updatePlane();
+    }
 
-    delete dilateImage;
+    delete skeletonImage;
 }
 
 
 //------------------------------------------------------------------------------
-//! Compute the eroded image
+//! Get the connectedness of the geodesic operations
 //!
 //! @param _
 //!
-//! @return _
+//! @return 4 for the 4-connectedness neighborhood, 8 otherwise
 //------------------------------------------------------------------------------
-void COpMorphoMaths::computeErosion(void)
+int COpMorphoMaths::getConnectedness(void)
 {
-    CImageInt *erodedImage = nullptr;
-
-    erodedImage = m_imageGray->opErosion(m_neighborhood);
-    CImage2QImage(erodedImage, m_imageTreated);
-
-    delete erodedImage;
+    return (m_neighborhoodType == OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_4) ? 4 : 8;
 }
 
 
 //------------------------------------------------------------------------------
-//! Compute the "opened" image
+//! Compute the opening by reconstruction of the image (the eroded image is
+//! reconstructed by dilation under the image)
 //!
 //! @param _
 //!
 //! @return _
 //------------------------------------------------------------------------------
-void COpMorphoMaths::computeOpening(void)
+void COpMorphoMaths::computeOpeningByReconstruction(void)
 {
-    CImageInt *erodedImage = nullptr;
-    CImageInt *dilateImage = nullptr;
+    std::vector<uchar> openedPlane(m_plane.size());
 
-    erodedImage = m_imageGray->opErosion(m_neighborhood);
-    if (erodedImage)
-        dilateImage = erodedImage->opDilation(m_neighborhood);
-    CImage2QImage(dilateImage, m_imageTreated);
+    runTiled([&](const SOpMorphoMathsTile &tile, std::vector<uchar> &buffer) {
+        computeTileMinMax(m_structuringElement, m_plane.data(), tile, openedPlane.data(), nullptr, buffer);
+    });
+    computeReconstructionByDilation(openedPlane, m_plane);
 
-    delete erodedImage;
-    delete dilateImage;
+    plane2QImage(openedPlane, m_imageTreated);
 }
 
 
 //------------------------------------------------------------------------------
-//! Compute the "closed" image
+//! Fill the holes of the image: a marker equal to the image on its border and
+//! to the maximum inside is reconstructed by erosion over the image
 //!
 //! @param _
 //!
 //! @return _
 //------------------------------------------------------------------------------
-void COpMorphoMaths::computeClosing(void)
+void COpMorphoMaths::computeHoleFilling(void)
 {
-    CImageInt *dilateImage = nullptr;
-    CImageInt *erodedImage = nullptr;
+    std::vector<uchar> filledPlane(m_plane.size(), CIMAGEINT_MAX);
+    int                width  = m_imageGray->getWidth();
+    int                height = m_imageGray->getHeight();
 
-    dilateImage = m_imageGray->opDilation(m_neighborhood);
-    if (dilateImage)
-        erodedImage = dilateImage->opErosion(m_neighborhood);
-    CImage2QImage(erodedImage, m_imageTreated);
+    for (int x = 0; x < width; x++)
+    {
+        filledPlane[x]                        = m_plane[x];
+        filledPlane[(height - 1) * width + x] = m_plane[(height - 1) * width + x];
+    }
+    for (int y = 0; y < height; y++)
+    {
+        filledPlane[y * width]             = m_plane[y * width];
+        filledPlane[y * width + width - 1] = m_plane[y * width + width - 1];
+    }
+    computeReconstructionByErosion(filledPlane, m_plane);
 
-    delete dilateImage;
-    delete erodedImage;
+    plane2QImage(filledPlane, m_imageTreated);
 }
 
 
 //------------------------------------------------------------------------------
-//! Compute the interior gradient of the image
+//! Compute the regional maxima of the image: the pixels where the image is
+//! above its reconstruction by dilation of the image minus 1
 //!
 //! @param _
 //!
 //! @return _
 //------------------------------------------------------------------------------
-void COpMorphoMaths::computeInteriorGradient(void)
+void COpMorphoMaths::computeRegionalMaxima(void)
 {
-    CImageInt *erodedImage        = nullptr;
-    CImageInt *complementaryImage = nullptr;
+    std::vector<uchar> maximaPlane(m_plane.size());
 
-    erodedImage = m_imageGray->opErosion(m_neighborhood);
-    if (erodedImage)
-        complementaryImage = m_imageGray->opComplementary(erodedImage);
-    CImage2QImage(complementaryImage, m_imageTreated);
+    for (size_t i = 0; i < m_plane.size(); i++)
+        maximaPlane[i] = (m_plane[i] > 0) ? m_plane[i] - 1 : 0;
+    computeReconstructionByDilation(maximaPlane, m_plane);
 
-    delete erodedImage;
-    delete complementaryImage;
+    for (size_t i = 0; i < m_plane.size(); i++)
+        maximaPlane[i] = (m_plane[i] > maximaPlane[i]) ? CIMAGEINT_MAX : 0;
+
+    plane2QImage(maximaPlane, m_imageTreated);
 }
 
 
 //------------------------------------------------------------------------------
-//! Compute the exterior gradient of the image
+//! Compute the area opening of the image (the bright components smaller than
+//! the area are removed)
 //!
 //! @param _
 //!
 //! @return _
 //------------------------------------------------------------------------------
-void COpMorphoMaths::computeExteriorGradient(void)
+void COpMorphoMaths::computeAreaOpening(void)
 {
-    CImageInt *dilateImage        = nullptr;
-    CImageInt *complementaryImage = nullptr;
+    std::vector<uchar> openedPlane(m_plane);
 
-    dilateImage = m_imageGray->opDilation(m_neighborhood);
-    if (dilateImage)
-        complementaryImage = dilateImage->opComplementary(m_imageGray);
-    CImage2QImage(complementaryImage, m_imageTreated);
+    computeAreaOpening(openedPlane, m_area);
 
-    delete dilateImage;
-    delete complementaryImage;
+    plane2QImage(openedPlane, m_imageTreated);
 }
 
 
 //------------------------------------------------------------------------------
-//! Compute the morphological gradient of the image
+//! Compute the area closing of the image (the dark components smaller than
+//! the area are removed)
 //!
 //! @param _
 //!
 //! @return _
 //------------------------------------------------------------------------------
-void COpMorphoMaths::computeMorphologicalGradient(void)
+void COpMorphoMaths::computeAreaClosing(void)
 {
-    CImageInt *dilateImage        = nullptr;
-    CImageInt *erodedImage        = nullptr;
-    CImageInt *complementaryImage = nullptr;
+    std::vector<uchar> closedPlane(m_plane);
 
-    dilateImage = m_imageGray->opDilation(m_neighborhood);
-    erodedImage = m_imageGray->opErosion(m_neighborhood);
-    if (dilateImage)
-        complementaryImage = dilateImage->opComplementary(erodedImage);
-    CImage2QImage(complementaryImage, m_imageTreated);
+    computeAreaClosing(closedPlane, m_area);
 
-    delete dilateImage;
-    delete erodedImage;
-    delete complementaryImage;
+    plane2QImage(closedPlane, m_imageTreated);
 }
 
 
 //------------------------------------------------------------------------------
-//! Compute the "hit or miss" transformation of the image
+//! Compute the attribute opening of the image: the max-tree of the plane is
+//! built at the first call (and when the connectedness changes), then only
+//! filtered
 //!
 //! @param _
 //!
 //! @return _
 //------------------------------------------------------------------------------
-void COpMorphoMaths::computeHitOrMiss(void)
+void COpMorphoMaths::computeAttributeOpening(void)
 {
-    CImageInt *erodedImage1                   = nullptr;
-    CImageInt *erodedImage2                   = nullptr;
-    CImageInt *negativeImage                  = nullptr;
-    CImageInt *intersectionImage              = nullptr;
-    CImageInt *localComplementaryNeighborhood = nullptr;
+    std::vector<uchar> openedPlane;
 
-    erodedImage1  = m_imageGray->opErosion(m_neighborhood);
-    negativeImage = m_imageGray->opNegative();
-    if (negativeImage)
+    if (!m_maxTree.isBuilt() || (m_maxTreeConnectedness != getConnectedness()))
     {
-        localComplementaryNeighborhood = m_neighborhood->opLocalComplementary();
-
-        if (localComplementaryNeighborhood)
-            erodedImage2 = negativeImage->opErosion(localComplementaryNeighborhood);
+        m_maxTreeConnectedness = getConnectedness();
+        m_maxTree.build(m_plane, m_imageGray->getWidth(), m_imageGray->getHeight(), m_maxTreeConnectedness);
     }
-    if (erodedImage1)
-        intersectionImage = erodedImage1->opIntersection(erodedImage2);
 
-    CImage2QImage(intersectionImage, m_imageTreated);
+    m_maxTree.filter(static_cast<MAXTREE_ATTRIBUTE>(m_attribute), m_attributeThreshold, openedPlane);
 
-    delete erodedImage1;
-    delete erodedImage2;
-    delete negativeImage;
-    delete intersectionImage;
-    delete localComplementaryNeighborhood;
+    plane2QImage(openedPlane, m_imageTreated);
 }
 
 
 //------------------------------------------------------------------------------
-//! Compute the thinness image
+//! Compute the attribute closing of the image with the min-tree (max-tree of
+//! the negative plane), built at the first call and then only filtered
 //!
 //! @param _
 //!
 //! @return _
 //------------------------------------------------------------------------------
-bool COpMorphoMaths::computeThinning(void)
+void COpMorphoMaths::computeAttributeClosing(void)
 {
-    CImageInt * thinImage = new CImageInt(m_imageGray->getWidth(), m_imageGray->getHeight(), m_imageGray);
-    CImageBool *passImage = new CImageBool(m_imageGray->getWidth(), m_imageGray->getHeight());
-    bool        ret       = false;
-    int         nNeighbors;
-    int         nTransitions;
-    bool        conditionConnection;
-    int         v0, v1, v2, v3, v4, v5, v6, v7;
+    std::vector<uchar> closedPlane(m_plane.size());
 
-    if (thinImage && passImage)
+    if (!m_minTree.isBuilt() || (m_minTreeConnectedness != getConnectedness()))
     {
-        for (int i = 0; i < m_dimension; i++)
-        {
-            for (int noPass = 1; noPass <= 2; noPass++)
-            {
-                passImage->reset();
+        for (size_t i = 0; i < m_plane.size(); i++)
+            closedPlane[i] = CIMAGEINT_MAX - m_plane[i];
 
-                for (int x = 0; x < thinImage->getWidth(); x++)
-                {
-                    for (int y = 0; y < thinImage->getHeight(); y++)
-                    {
-                        if (thinImage->get(x, y) != 0)
-                        {
-                            v0 = ((thinImage->get(x, y + 1) == 0) ? 0 : 1);
-                            v1 = ((thinImage->get(x + 1, y + 1) == 0) ? 0 : 1);
-                            v2 = ((thinImage->get(x + 1, y) == 0) ? 0 : 1);
-                            v3 = ((thinImage->get(x + 1, y - 1) == 0) ? 0 : 1);
-                            v4 = ((thinImage->get(x, y - 1) == 0) ? 0 : 1);
-                            v5 = ((thinImage->get(x - 1, y - 1) == 0) ? 0 : 1);
-                            v6 = ((thinImage->get(x - 1, y) == 0) ? 0 : 1);
-                            v7 = ((thinImage->get(x - 1, y + 1) == 0) ? 0 : 1);
+        m_minTreeConnectedness = getConnectedness();
+        m_minTree.build(closedPlane, m_imageGray->getWidth(), m_imageGray->getHeight(), m_minTreeConnectedness);
+    }
 
-                            if (noPass == 1)
-                                conditionConnection = (!v0 || !v2 || !v4) && (!v2 || !v4 || !v6);
-                            else
-                                conditionConnection = (!v0 || !v2 || !v6) && (!v0 || !v4 || !v6);
+    m_minTree.filter(static_cast<MAXTREE_ATTRIBUTE>(m_attribute), m_attributeThreshold, closedPlane);
+    for (size_t i = 0; i < closedPlane.size(); i++)
+        closedPlane[i] = CIMAGEINT_MAX - closedPlane[i];
 
-                            nTransitions = 0;
-                            if (v0 && !v1)
-                                nTransitions++;
-                            if (v1 && !v2)
-                                nTransitions++;
-                            if (v2 && !v3)
-                                nTransitions++;
-                            if (v3 && !v4)
-                                nTransitions++;
-                            if (v4 && !v5)
-                                nTransitions++;
-                            if (v5 && !v6)
-                                nTransitions++;
-                            if (v6 && !v7)
-                                nTransitions++;
-                            if (v7 && !v0)
-                                nTransitions++;
+    plane2QImage(closedPlane, m_imageTreated);
+}
 
-                            nNeighbors = v0 + v1 + v2 + v3 + v4 + v5 + v6 + v7;
 
-                            if ((nNeighbors >= 2) &&
-                                (nNeighbors <= 6) &&
-                                (nTransitions == 1) &&
-                                conditionConnection)
-                            {
-                                (*passImage)(x, y) = true;
-                                ret                = true;
-                            }
-                        }
-                    }
-                }
+//------------------------------------------------------------------------------
+//! Compute the granulometry of the image for the dimensions 0 ... dimension:
+//! for a binary image and a square, cross or line neighborhood, the pattern
+//! spectrum is read from the opening transform, otherwise the openings of
+//! all the dimensions are computed. The crosses are not unions of smaller
+//! crosses, so the size d is the supremum of the openings of dimension d and
+//! more (the same as the opening of dimension d for the squares and the
+//! lines), which keeps the pattern spectrum positive. The dimension d of a
+//! custom neighborhood is its centred crop of size 2d+1. The treated image is
+//! the histogram of the pattern spectrum.
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::computeGranulometry(void)
+{
+    std::vector<int>    openingTransform;
+    std::vector<qint64> volumes(m_dimension + 2, 0);
+    std::vector<uchar>  erodedPlane(m_plane.size());
+    std::vector<uchar>  openedPlane(m_plane.size());
+    int                 dimension = m_dimension;
+
+    if (!m_isGrayscale &&
+        ((m_neighborhoodType == OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_4) ||
+         (m_neighborhoodType == OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_8) ||
+         (m_neighborhoodType == OPMORPHOMATHS_NEIGHBORHOOD_VERTICAL) ||
+         (m_neighborhoodType == OPMORPHOMATHS_NEIGHBORHOOD_HORIZONTAL)))
+    {
+        computeOpeningTransform(openingTransform);
+        for (size_t i = 0; i < openingTransform.size(); i++)
+        {
+            if (openingTransform[i] >= 0)
+                volumes[openingTransform[i]]++;
+        }
+        // Cumulated from the largest dimension: area of each opening
+        for (int d = dimension - 1; d >= 0; d--)
+            volumes[d] += volumes[d + 1];
+    }
+    else
+    {
+        // From the largest dimension: supremum of the openings
+        std::vector<uchar> supremumPlane(m_plane.size(), 0);
 
-                for (int x = 0; x < thinImage->getWidth(); x++)
-                {
-                    for (int y = 0; y < thinImage->getHeight(); y++)
-                    {
-                        if (passImage->get(x, y))
-                            (*thinImage)(x, y) = 0;
-                    }
-                }
+        for (int d = dimension; d >= 0; d--)
+        {
+            m_dimension = d;
+            initNeighborhood();
+            runTiled([&](const SOpMorphoMathsTile &tile, std::vector<uchar> &buffer) {
+                computeTileMinMax(m_structuringElement, m_plane.data(), tile, erodedPlane.data(), nullptr, buffer);
+            });
+            runTiled([&](const SOpMorphoMathsTile &tile, std::vector<uchar> &buffer) {
+                computeTileMinMax(m_reflectedStructuringElement, erodedPlane.data(), tile, nullptr, openedPlane.data(), buffer);
+            });
+
+            for (size_t i = 0; i < openedPlane.size(); i++)
+            {
+                supremumPlane[i] = qMax(supremumPlane[i], openedPlane[i]);
+                volumes[d] += supremumPlane[i];
             }
+            if (!m_isGrayscale)
+                volumes[d] /= CIMAGEINT_MAX;
         }
+        m_dimension = dimension;
+        initNeighborhood();
     }
 
-    CImage2QImage(thinImage, m_imageTreated);
-
-    delete thinImage;
-    delete passImage;
+    m_patternSpectrum.resize(dimension + 1);
+    for (int d = 0; d <= dimension; d++)
+        m_patternSpectrum[d] = volumes[d] - volumes[d + 1];
 
-    return ret;
+    histogram2QImage(m_patternSpectrum, m_imageTreated);
 }
 
 
 //------------------------------------------------------------------------------
-//! Compute the skeletonized image
+//! Compute the opening transform of the binary image: the largest dimension
+//! (up to the current dimension) of the openings containing each pixel, -1
+//! for the background. The pixels outside the image are ignored, as for the
+//! openings. The radius of the largest neighborhood centred on each pixel and
+//! included in the image is given by the chessboard distance (square), the
+//! lengths of the runs (lines) or the shortest of the horizontal and vertical
+//! arms given by the runs (cross), the openings then spread the radii over
+//! the lines and the columns (coverMax).
 //!
-//! @param _
+//! @param openingTransform The opening transform
 //!
 //! @return _
 //------------------------------------------------------------------------------
-void COpMorphoMaths::computeSkeletonizing(void)
+void COpMorphoMaths::computeOpeningTransform(std::vector<int> &openingTransform)
 {
-    bool thinning;
+    int              width     = m_imageGray->getWidth();
+    int              height    = m_imageGray->getHeight();
+    int              maxRadius = m_dimension;
+    std::vector<int> radii(m_plane.size());
+    std::vector<int> runs(m_plane.size());
+    std::vector<int> covered(m_plane.size(), -1);
+    int              p;
 
-    m_dimension = 1;
+    openingTransform.assign(m_plane.size(), -1);
 
-    do
+    if (m_neighborhoodType == OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_8)
     {
-        thinning = computeThinning();
-        createImageGray(m_imageTreated, m_imageGray);
-    } while (thinning);
+        // Chessboard distance to the background (minus 1), in two passes
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                p        = y * width + x;
+                radii[p] = (m_plane[p] == 0) ? -1 : maxRadius;
+                if ((radii[p] >= 0) && (x > 0))
+                    radii[p] = qMin(radii[p], radii[p - 1] + 1);
+                if ((radii[p] >= 0) && (y > 0))
+                {
+                    radii[p] = qMin(radii[p], radii[p - width] + 1);
+                    if (x > 0)
+                        radii[p] = qMin(radii[p], radii[p - width - 1] + 1);
+                    if (x < width - 1)
+                        radii[p] = qMin(radii[p], radii[p - width + 1] + 1);
+                }
+            }
+        }
+        for (int y = height - 1; y >= 0; y--)
+        {
+            for (int x = width - 1; x >= 0; x--)
+            {
+                p = y * width + x;
+                if (radii[p] < 0)
+                    continue;
+                if (x < width - 1)
+                    radii[p] = qMin(radii[p], radii[p + 1] + 1);
+                if (y < height - 1)
+                {
+                    radii[p] = qMin(radii[p], radii[p + width] + 1);
+                    if (x > 0)
+                        radii[p] = qMin(radii[p], radii[p + width - 1] + 1);
+                    if (x < width - 1)
+                        radii[p] = qMin(radii[p], radii[p + width + 1] + 1);
+                }
+            }
+        }
+
+        // The largest radius of a column covering a pixel also has the
+        // largest reach along the line
+        for (int x = 0; x < width; x++)
+            coverMax(radii.data() + x, height, width, covered.data() + x);
+        for (int y = 0; y < height; y++)
+            coverMax(covered.data() + y * width, width, 1, openingTransform.data() + y * width);
+    }
+    else if (m_neighborhoodType == OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_4)
+    {
+        // Arms of the cross: the shortest of the horizontal and vertical ones
+        for (int y = 0; y < height; y++)
+            segmentRadii(m_plane.data() + y * width, width, 1, maxRadius, runs.data() + y * width, radii.data() + y * width);
+        for (int x = 0; x < width; x++)
+            segmentRadii(m_plane.data() + x, height, width, maxRadius, runs.data() + x, covered.data() + x);
+        for (size_t i = 0; i < radii.size(); i++)
+            radii[i] = qMin(radii[i], covered[i]);
+
+        // A pixel is covered by the horizontal arms of the crosses of its
+        // line or by the vertical arms of the crosses of its column
+        for (int y = 0; y < height; y++)
+            coverMax(radii.data() + y * width, width, 1, covered.data() + y * width);
+        for (int x = 0; x < width; x++)
+            coverMax(radii.data() + x, height, width, runs.data() + x);
+        for (size_t i = 0; i < openingTransform.size(); i++)
+            openingTransform[i] = qMax(covered[i], runs[i]);
+    }
+    else
+    {
+        // Arms of the line: distance to the background along the lines or
+        // the columns (minus 1)
+        bool isVertical = (m_neighborhoodType == OPMORPHOMATHS_NEIGHBORHOOD_VERTICAL);
+        int  length     = isVertical ? height : width;
+        int  number     = isVertical ? width : height;
+        int  stride     = isVertical ? width : 1;
+        int  step       = isVertical ? 1 : width;
+
+        for (int line = 0; line < number; line++)
+        {
+            segmentRadii(m_plane.data() + line * step, length, stride, maxRadius, runs.data() + line * step, radii.data() + line * step);
+            coverMax(radii.data() + line * step, length, stride, openingTransform.data() + line * step);
+        }
+    }
 }
 
 
@@ -590,3 +3186,118 @@ void COpMorphoMaths::CImage2QImage(CImageInt *imageIn, QImage *imageOut)
         }
     }
 }
+
+
+//------------------------------------------------------------------------------
+//! Convert a packed binary image to a QImage
+//!
+//! @param imageIn The input image
+//! @param imageOut The output image
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::CBinaryImage2QImage(CBinaryImage *imageIn, QImage *imageOut)
+{
+    int GOut;
+
+    if (imageIn && imageOut)
+    {
+        for (int yOut = 0; yOut < imageOut->height(); yOut++)
+        {
+            for (int xOut = 0; xOut < imageOut->width(); xOut++)
+            {
+                GOut = imageIn->get(xOut, yOut) ? CIMAGEINT_MAX : 0;
+                imageOut->setPixel(xOut, yOut, qRgb(GOut, GOut, GOut));
+            }
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Convert a run-length encoded binary image to a QImage
+//!
+//! @param imageIn The input image
+//! @param imageOut The output image
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::CRunLengthImage2QImage(CRunLengthImage *imageIn, QImage *imageOut)
+{
+    const SRunLengthRun *row;
+    QRgb *               line;
+
+    if (imageIn && imageOut)
+    {
+        imageOut->fill(qRgb(0, 0, 0));
+        for (int yOut = 0; yOut < qMin(imageIn->getHeight(), imageOut->height()); yOut++)
+        {
+            row  = imageIn->getRow(yOut);
+            line = reinterpret_cast<QRgb *>(imageOut->scanLine(yOut));
+            for (int noRun = 0; noRun < imageIn->getNumberRuns(yOut); noRun++)
+            {
+                if (row[noRun].x0 < imageOut->width())
+                    std::fill(line + row[noRun].x0, line + qMin(row[noRun].x1, imageOut->width()), qRgb(CIMAGEINT_MAX, CIMAGEINT_MAX, CIMAGEINT_MAX));
+            }
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Convert a plane to a QImage
+//!
+//! @param planeIn The input plane
+//! @param imageOut The output image
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::plane2QImage(const std::vector<uchar> &planeIn, QImage *imageOut)
+{
+    QRgb *line;
+    int   GOut;
+
+    if (imageOut && (planeIn.size() == static_cast<size_t>(imageOut->width()) * imageOut->height()))
+    {
+        for (int yOut = 0; yOut < imageOut->height(); yOut++)
+        {
+            line = reinterpret_cast<QRgb *>(imageOut->scanLine(yOut));
+            for (int xOut = 0; xOut < imageOut->width(); xOut++)
+            {
+                GOut       = planeIn[yOut * imageOut->width() + xOut];
+                line[xOut] = qRgb(GOut, GOut, GOut);
+            }
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Draw a histogram (one black bar per value on a white background)
+//!
+//! @param histogram The histogram
+//! @param imageOut The output image
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void COpMorphoMaths::histogram2QImage(const std::vector<qint64> &histogram, QImage *imageOut)
+{
+    qint64 maxValue = 1;
+    int    noBar;
+    int    barHeight;
+
+    if (imageOut && !histogram.empty())
+    {
+        for (size_t i = 0; i < histogram.size(); i++)
+            maxValue = qMax(maxValue, histogram[i]);
+
+        imageOut->fill(qRgb(CIMAGEINT_MAX, CIMAGEINT_MAX, CIMAGEINT_MAX));
+        for (int xOut = 0; xOut < imageOut->width(); xOut++)
+        {
+            noBar     = static_cast<int>(static_cast<qint64>(xOut) * static_cast<qint64>(histogram.size()) / imageOut->width());
+            barHeight = static_cast<int>(histogram[noBar] * imageOut->height() / maxValue);
+            for (int yOut = imageOut->height() - barHeight; yOut < imageOut->height(); yOut++)
+                imageOut->setPixel(xOut, yOut, qRgb(0, 0, 0));
+        }
+    }
+}
@@ -12,8 +12,32 @@
 // Include(s) :
 
 #include <QImage>
+#include <functional>
+#include <map>
+#include <vector>
 
 #include "../../Commun/Image/cimage.h"
+#include "BinaryImage.h"
+#include "HitOrMiss.h"
+#include "MaxTree.h"
+#include "Parallel.h"
+#include "RunLengthImage.h"
+#include "StructuringElement.h"
+
+
+//------------------------------------------------------------------------------
+// Constant(s):
+
+const int OPMORPHOMATHS_DEFAULT_TILE_SIZE       = 256;
+const int OPMORPHOMATHS_INCREMENTAL_MAX_STEPS  = 4;
+const int OPMORPHOMATHS_INCREMENTAL_MAX_PLANES = 8;
+const int OPMORPHOMATHS_DEFAULT_AREA           = 50;
+const int OPMORPHOMATHS_DEFAULT_CONTRAST       = 20;
+const int OPMORPHOMATHS_DEFAULT_LINE_ANGLE     = 0;
+const int OPMORPHOMATHS_DEFAULT_ORIENTATIONS   = 12;
+const int OPMORPHOMATHS_DEFAULT_PERCENTILE     = 50;
+const int OPMORPHOMATHS_RANK_HISTOGRAM_SIZE    = 256 + 16;
+const int OPMORPHOMATHS_RANK_MIN_COLUMN_HEIGHT = 16;
 
 
 //------------------------------------------------------------------------------
@@ -31,7 +55,20 @@ enum OPMORPHOMATHS_TYPE
     OPMORPHOMATHS_MORPHOLOGICAL_GRADIENT,
     OPMORPHOMATHS_HIT_OR_MISS,
     OPMORPHOMATHS_THINNING,
-    OPMORPHOMATHS_SKELETONIZING
+    OPMORPHOMATHS_SKELETONIZING,
+    OPMORPHOMATHS_OPENING_BY_RECONSTRUCTION,
+    OPMORPHOMATHS_HOLE_FILLING,
+    OPMORPHOMATHS_REGIONAL_MAXIMA,
+    OPMORPHOMATHS_AREA_OPENING,
+    OPMORPHOMATHS_AREA_CLOSING,
+    OPMORPHOMATHS_ATTRIBUTE_OPENING,
+    OPMORPHOMATHS_ATTRIBUTE_CLOSING,
+    OPMORPHOMATHS_GRANULOMETRY,
+    OPMORPHOMATHS_TOP_HAT,
+    OPMORPHOMATHS_BOTTOM_HAT,
+    OPMORPHOMATHS_LINE_OPENING,
+    OPMORPHOMATHS_LINE_OPENING_BANK,
+    OPMORPHOMATHS_RANK_FILTER
 };
 
 enum OPMORPHOMATHS_NEIGHBORHOOD_TYPE
@@ -44,7 +81,21 @@ enum OPMORPHOMATHS_NEIGHBORHOOD_TYPE
     OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_4_UP,
     OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_4_DOWN,
     OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_4_LEFT,
-    OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_4_RIGHT
+    OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_4_RIGHT,
+    OPMORPHOMATHS_NEIGHBORHOOD_CUSTOM
+};
+
+
+//------------------------------------------------------------------------------
+// Structure(s):
+
+//! Rectangle [x0, x1[ x [y0, y1[ of the image computed by one task
+struct SOpMorphoMathsTile
+{
+    int x0;
+    int y0;
+    int x1;
+    int y1;
 };
 
 
@@ -57,32 +108,124 @@ public:
     COpMorphoMaths(QImage *imageIn);
     ~COpMorphoMaths(void);
 
-    QImage *getImageTreated(void);
-    int     getDimension(void);
-    void    computeOpMorphoMaths(OPMORPHOMATHS_TYPE OperationType, int dimension, int neighborhoodType = OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_8);
+    QImage *                   getImageTreated(void);
+    int                        getDimension(void);
+    bool                       isBitParallel(void);
+    void                       setBitParallel(bool isBitParallel);
+    bool                       isRunLength(void);
+    void                       setRunLength(bool isRunLength);
+    bool                       isGrayscale(void);
+    void                       setGrayscale(bool isGrayscale);
+    int                        getNumberThreads(void);
+    int                        getTileSize(void);
+    void                       setTiling(int nThreads, int tileSize);
+    bool                       setCustomNeighborhood(CImageInt *neighborhood);
+    int                        getArea(void);
+    void                       setArea(int area);
+    int                        getAttribute(void);
+    int                        getAttributeThreshold(void);
+    void                       setAttribute(int attribute, int threshold);
+    int                        getLineAngle(void);
+    int                        getNumberOrientations(void);
+    void                       setLine(int angle, int nOrientations);
+    int                        getPercentile(void);
+    void                       setPercentile(int percentile);
+    const std::vector<qint64> &getPatternSpectrum(void);
+    void                       computeOpMorphoMaths(OPMORPHOMATHS_TYPE OperationType, int dimension, int neighborhoodType = OPMORPHOMATHS_NEIGHBORHOOD_CONNECTEDNESS_8);
+    void                       computeHitOrMiss(CHitOrMiss *hitOrMiss);
+    void                       computeReconstructionByDilation(std::vector<uchar> &marker, const std::vector<uchar> &mask);
+    void                       computeReconstructionByErosion(std::vector<uchar> &marker, const std::vector<uchar> &mask);
+    void                       computeAreaOpening(std::vector<uchar> &plane, int area);
+    void                       computeAreaClosing(std::vector<uchar> &plane, int area);
 
 private:
     QImage *   m_imageOrigin;
     QImage *   m_imageTreated;
     CImageInt *m_imageGray;
     CImageInt *m_neighborhood;
+    CImageInt *m_customNeighborhood;
     bool       m_isValid;
     int        m_dimension;
     int        m_neighborhoodType;
+    bool       m_isBitParallel;
+    bool       m_isRunLength;
+    bool       m_isGrayscale;
+    int        m_nThreads;
+    int        m_tileSize;
+    int        m_area;
+    int        m_attribute;
+    int        m_attributeThreshold;
+    int        m_lineAngle;
+    int        m_nOrientations;
+    int        m_percentile;
+    int        m_compiledDimension;
+    int        m_compiledNeighborhoodType;
+
+    std::vector<uchar>              m_luminancePlane;
+    std::vector<uchar>              m_plane;
+    std::vector<qint64>             m_patternSpectrum;
+    CStructuringElement             m_structuringElement;
+    CStructuringElement             m_reflectedStructuringElement;
+    std::vector<SOpMorphoMathsTile> m_tiles;
+
+    OPMORPHOMATHS_TYPE                m_incrementalOperationType;
+    int                               m_incrementalNeighborhoodType;
+    bool                              m_incrementalIsGrayscale;
+    CStructuringElement               m_unitStructuringElement;
+    std::map<int, std::vector<uchar>> m_incrementalPlanes;
+
+    CMaxTree m_maxTree;
+    CMaxTree m_minTree;
+    int      m_maxTreeConnectedness;
+    int      m_minTreeConnectedness;
+
+    CRunLengthImage *m_runLengthImage;
 
     void createImageGray(QImage *imageIn, CImageInt *imageOut);
+    void createLuminancePlane(QImage *imageIn, std::vector<uchar> &planeOut);
+    void updatePlane(void);
     void initNeighborhood(void);
+    void initTiles(void);
+    void runTiled(const std::function<void(const SOpMorphoMathsTile &, std::vector<uchar> &)> &task);
+    void computeTileMinMax(CStructuringElement &structuringElement, const uchar *planeIn, const SOpMorphoMathsTile &tile, uchar *planeErosion, uchar *planeDilation, std::vector<uchar> &buffer);
     void computeDilation(void);
     void computeErosion(void);
+    bool isIncremental(void);
+    void computeIncrementalMinMax(OPMORPHOMATHS_TYPE operationType);
+    void computeRunLength(OPMORPHOMATHS_TYPE operationType);
     void computeOpening(void);
     void computeClosing(void);
     void computeInteriorGradient(void);
     void computeExteriorGradient(void);
     void computeMorphologicalGradient(void);
+    void computeTopHat(void);
+    void computeBottomHat(void);
+    void computeLineOpening(void);
+    void computeLineOpeningBank(void);
+    void computeLineOpening(const uchar *planeIn, qreal angle, bool isMerged, uchar *planeOut);
+    void computeRankFilter(void);
     void computeHitOrMiss(void);
+    void computeHitOrMissByErosions(void);
     bool computeThinning(void);
+    bool computeThinningPass(CBinaryImage *image, int noPass);
+    void computeThinningBitParallel(void);
     void computeSkeletonizing(void);
+    void computeSkeletonizingBitParallel(void);
+    int  getConnectedness(void);
+    void computeOpeningByReconstruction(void);
+    void computeHoleFilling(void);
+    void computeRegionalMaxima(void);
+    void computeAreaOpening(void);
+    void computeAreaClosing(void);
+    void computeAttributeOpening(void);
+    void computeAttributeClosing(void);
+    void computeGranulometry(void);
+    void computeOpeningTransform(std::vector<int> &openingTransform);
     void CImage2QImage(CImageInt *imageIn, QImage *imageOut);
+    void CBinaryImage2QImage(CBinaryImage *imageIn, QImage *imageOut);
+    void CRunLengthImage2QImage(CRunLengthImage *imageIn, QImage *imageOut);
+    void plane2QImage(const std::vector<uchar> &planeIn, QImage *imageOut);
+    void histogram2QImage(const std::vector<qint64> &histogram, QImage *imageOut);
 };
 
 #endif // OP_MORPHO_MATHS_HEADER
@@ -0,0 +1,269 @@
+//------------------------------------------------------------------------------
+//! @file Parallel.cpp
+//! @brief Definition file of the CParallel class
+//! @author Fabrice Cochet
+//! @version 1.0
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Include(s) :
+
+#include <QThread>
+#include <QtGlobal>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "Parallel.h"
+
+
+//------------------------------------------------------------------------------
+// Local Variable(s):
+
+//! true on a thread running a task of the pool (the calls made from a task
+//! run on this thread)
+static thread_local bool isInTask = false;
+
+
+//------------------------------------------------------------------------------
+// Public Method(s):
+
+//------------------------------------------------------------------------------
+//! Get the number of threads matching the number of cores
+//!
+//! @param _
+//!
+//! @return The number of threads (at least 1)
+//------------------------------------------------------------------------------
+int CParallel::getIdealThreadCount(void)
+{
+    int nThreads = QThread::idealThreadCount();
+
+    return (nThreads > 0) ? nThreads : 1;
+}
+
+
+//------------------------------------------------------------------------------
+//! Run a set of independent tasks on the worker pool
+//!
+//! @param nTasks The number of tasks
+//! @param nThreads The maximum number of threads (the calling thread included)
+//! @param task The task function, called with the task index
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CParallel::run(int nTasks, int nThreads, const std::function<void(int)> &task)
+{
+    runWithThreadIndex(nTasks, nThreads, [&task](int noTask, int) { task(noTask); });
+}
+
+
+//------------------------------------------------------------------------------
+//! Run a set of independent tasks on the worker pool, giving to each task the
+//! index of the thread running it (to use per-thread buffers). The workers 1
+//! ... nThreads - 1 are woken up (and created the first time), the calling
+//! thread being the thread 0.
+//!
+//! @param nTasks The number of tasks
+//! @param nThreads The maximum number of threads (the calling thread included)
+//! @param task The task function, called with the task index and the thread
+//!        index (0 ... nThreads - 1)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CParallel::runWithThreadIndex(int nTasks, int nThreads, const std::function<void(int, int)> &task)
+{
+    CParallel &pool     = getPool();
+    int        nWorkers = qBound(1, nThreads, qMax(nTasks, 1));
+
+    if (nTasks <= 0)
+        return;
+
+    // Call from a task (or a single thread): no worker
+    if (isInTask || (nWorkers == 1))
+    {
+        bool wasInTask = isInTask;
+
+        isInTask = true;
+        for (int noTask = 0; noTask < nTasks; noTask++)
+            task(noTask, 0);
+        isInTask = wasInTask;
+        return;
+    }
+
+    std::lock_guard<std::mutex> runLock(pool.m_runMutex);
+
+    {
+        std::lock_guard<std::mutex> lock(pool.m_mutex);
+
+        while (static_cast<int>(pool.m_workers.size()) < nWorkers - 1)
+            pool.m_workers.push_back(std::thread(&CParallel::runWorker, &pool, static_cast<int>(pool.m_workers.size()) + 1));
+
+        pool.m_task     = &task;
+        pool.m_nTasks   = nTasks;
+        pool.m_nextTask = 0;
+        pool.m_nWorkers = nWorkers;
+        pool.m_nRunning = nWorkers - 1;
+        pool.m_generation++;
+    }
+    pool.m_startCondition.notify_all();
+
+    isInTask = true;
+    pool.runTasks(0);
+    isInTask = false;
+
+    std::unique_lock<std::mutex> lock(pool.m_mutex);
+
+    pool.m_endCondition.wait(lock, [&pool]() { return pool.m_nRunning == 0; });
+    pool.m_task = nullptr;
+}
+
+
+//------------------------------------------------------------------------------
+// Private Method(s):
+
+//------------------------------------------------------------------------------
+//! CParallel constructor (pool without workers)
+//!
+//! @param _
+//!
+//! @return The created object
+//------------------------------------------------------------------------------
+CParallel::CParallel(void)
+{
+    m_task       = nullptr;
+    m_nextTask   = 0;
+    m_nTasks     = 0;
+    m_nWorkers   = 0;
+    m_nRunning   = 0;
+    m_generation = 0;
+    m_isStopped  = false;
+}
+
+
+//------------------------------------------------------------------------------
+//! Destructor: the workers are stopped and joined
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+CParallel::~CParallel(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_isStopped = true;
+    }
+    m_startCondition.notify_all();
+
+    for (size_t i = 0; i < m_workers.size(); i++)
+        m_workers[i].join();
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the pool of the process (created on the first call)
+//!
+//! @param _
+//!
+//! @return The pool
+//------------------------------------------------------------------------------
+CParallel &CParallel::getPool(void)
+{
+    static CParallel pool;
+
+    return pool;
+}
+
+
+//------------------------------------------------------------------------------
+//! Run the tasks of the current call until there is no task left
+//!
+//! @param noThread The index of the thread
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CParallel::runTasks(int noThread)
+{
+    for (int noTask = m_nextTask++; noTask < m_nTasks; noTask = m_nextTask++)
+        (*m_task)(noTask, noThread);
+}
+
+
+//------------------------------------------------------------------------------
+//! Loop of a worker: wait for a call using it, run its tasks, signal the end
+//!
+//! @param noThread The index of the worker (1 ... )
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CParallel::runWorker(int noThread)
+{
+    int generation = 0;
+
+    isInTask = true;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            m_startCondition.wait(lock, [this, generation, noThread]() {
+                return m_isStopped || ((m_generation != generation) && (noThread < m_nWorkers));
+            });
+            if (m_isStopped)
+                return;
+            generation = m_generation;
+        }
+
+        runTasks(noThread);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (--m_nRunning == 0)
+                m_endCondition.notify_one();
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! CParallelBarrier constructor
+//!
+//! @param nThreads The number of threads synchronized
+//!
+//! @return The created object
+//------------------------------------------------------------------------------
+CParallelBarrier::CParallelBarrier(int nThreads)
+{
+    m_nThreads   = qMax(nThreads, 1);
+    m_nWaiting   = 0;
+    m_generation = 0;
+}
+
+
+//------------------------------------------------------------------------------
+//! Wait for all the threads: the last one to arrive starts a new generation
+//! and wakes up the others
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CParallelBarrier::wait(void)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    int                          generation = m_generation;
+
+    if (++m_nWaiting == m_nThreads)
+    {
+        m_nWaiting = 0;
+        m_generation++;
+        m_condition.notify_all();
+    }
+    else
+    {
+        m_condition.wait(lock, [this, generation]() { return m_generation != generation; });
+    }
+}
@@ -0,0 +1,78 @@
+//------------------------------------------------------------------------------
+//! @file Parallel.h
+//! @brief Header file of the CParallel class
+//! @author Fabrice Cochet
+//! @version 1.0
+//------------------------------------------------------------------------------
+
+#ifndef PARALLEL_HEADER
+#define PARALLEL_HEADER
+
+//------------------------------------------------------------------------------
+// Include(s) :
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+//------------------------------------------------------------------------------
+// Classe(s) :
+
+//! Persistent worker pool: the worker threads are created on the first call
+//! that needs them and wait for the next calls. The tasks 0 ... nTasks - 1
+//! are distributed on the calling thread and the workers through a shared
+//! counter, the call returns when all the tasks are done. With as many
+//! threads as tasks, the tasks run concurrently (one per thread) and can
+//! synchronize through a CParallelBarrier. The calls are serialized, and a
+//! call made from a task runs its tasks on the thread of this task.
+class CParallel
+{
+public:
+    static int  getIdealThreadCount(void);
+    static void run(int nTasks, int nThreads, const std::function<void(int)> &task);
+    static void runWithThreadIndex(int nTasks, int nThreads, const std::function<void(int, int)> &task);
+
+private:
+    std::mutex                            m_runMutex;
+    std::mutex                            m_mutex;
+    std::condition_variable               m_startCondition;
+    std::condition_variable               m_endCondition;
+    std::vector<std::thread>              m_workers;
+    const std::function<void(int, int)> * m_task;
+    std::atomic<int>                      m_nextTask;
+    int                                   m_nTasks;
+    int                                   m_nWorkers;
+    int                                   m_nRunning;
+    int                                   m_generation;
+    bool                                  m_isStopped;
+
+    CParallel(void);
+    ~CParallel(void);
+
+    static CParallel &getPool(void);
+    void              runTasks(int noThread);
+    void              runWorker(int noThread);
+};
+
+//! Reusable barrier of a fixed number of threads: wait() returns when all the
+//! threads have called it, the memory written before being visible after
+class CParallelBarrier
+{
+public:
+    CParallelBarrier(int nThreads);
+
+    void wait(void);
+
+private:
+    std::mutex              m_mutex;
+    std::condition_variable m_condition;
+    int                     m_nThreads;
+    int                     m_nWaiting;
+    int                     m_generation;
+};
+
+#endif // PARALLEL_HEADER
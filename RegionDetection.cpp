@@ -8,7 +8,245 @@
 //------------------------------------------------------------------------------
 // Include(s) :
 
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QFile>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include "EdgeDetection.h"
 #include "RegionDetection.h"
+#include "qmath.h"
+
+
+//------------------------------------------------------------------------------
+// Constant Variable(s):
+
+//! Moves of the Freeman chain codes (counterclockwise from the east)
+const int freemanMoveX[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+const int freemanMoveY[8] = {0, -1, -1, -1, 0, 1, 1, 1};
+
+
+//------------------------------------------------------------------------------
+// Local Function(s):
+
+//------------------------------------------------------------------------------
+//! Compute the length of the chord of a line in the image, clipped by the
+//! rectangle [0, width - 1] x [0, height - 1] (the line is the point
+//! (rho * cos(theta), rho * sin(theta)) plus t * (-sin(theta), cos(theta)))
+//!
+//! @param width The width of the image
+//! @param height The height of the image
+//! @param cosTheta The cosine of the angle of the line
+//! @param sinTheta The sine of the angle of the line
+//! @param rho The distance of the line
+//!
+//! @return The length of the chord (0 if the line misses the image)
+//------------------------------------------------------------------------------
+static qreal computeChordLength(int width, int height, qreal cosTheta, qreal sinTheta, qreal rho)
+{
+    qreal origins[2]    = {rho * cosTheta, rho * sinTheta};
+    qreal directions[2] = {-sinTheta, cosTheta};
+    qreal maxima[2]     = {static_cast<qreal>(width - 1), static_cast<qreal>(height - 1)};
+    qreal t0            = -std::numeric_limits<qreal>::max();
+    qreal t1            = std::numeric_limits<qreal>::max();
+    qreal tMin;
+    qreal tMax;
+
+    for (int noAxis = 0; noAxis < 2; noAxis++)
+    {
+        // Parallel to the axis: inside the image or not at all
+        if (qAbs(directions[noAxis]) < 1e-9)
+        {
+            if ((origins[noAxis] < 0) || (origins[noAxis] > maxima[noAxis]))
+                return 0;
+            continue;
+        }
+
+        tMin = -origins[noAxis] / directions[noAxis];
+        tMax = (maxima[noAxis] - origins[noAxis]) / directions[noAxis];
+        if (tMin > tMax)
+            std::swap(tMin, tMax);
+        t0 = qMax(t0, tMin);
+        t1 = qMin(t1, tMax);
+    }
+
+    return qMax(t1 - t0, static_cast<qreal>(0));
+}
+
+
+//------------------------------------------------------------------------------
+//! Clip a segment by the rectangle [0, width - 1] x [0, height - 1] (the
+//! points (x0, y0) + t * (x1 - x0, y1 - y0), t in [0, 1]), then round its
+//! ends
+//!
+//! @param width The width of the image
+//! @param height The height of the image
+//! @param x0 The X coordinate of the first end
+//! @param y0 The Y coordinate of the first end
+//! @param x1 The X coordinate of the second end
+//! @param y1 The Y coordinate of the second end
+//! @param segmentOut The clipped segment
+//!
+//! @return true if a part of the segment is in the image
+//! @return false otherwise
+//------------------------------------------------------------------------------
+static bool clipSegment(int width, int height, qreal x0, qreal y0, qreal x1, qreal y1, SRegionDetectionSegment &segmentOut)
+{
+    qreal origins[2]    = {x0, y0};
+    qreal directions[2] = {x1 - x0, y1 - y0};
+    qreal maxima[2]     = {static_cast<qreal>(width - 1), static_cast<qreal>(height - 1)};
+    qreal t0            = 0;
+    qreal t1            = 1;
+    qreal tMin;
+    qreal tMax;
+
+    for (int noAxis = 0; noAxis < 2; noAxis++)
+    {
+        // Parallel to the axis: inside the image or not at all
+        if (qAbs(directions[noAxis]) < 1e-9)
+        {
+            if ((origins[noAxis] < 0) || (origins[noAxis] > maxima[noAxis]))
+                return false;
+            continue;
+        }
+
+        tMin = -origins[noAxis] / directions[noAxis];
+        tMax = (maxima[noAxis] - origins[noAxis]) / directions[noAxis];
+        if (tMin > tMax)
+            std::swap(tMin, tMax);
+        t0 = qMax(t0, tMin);
+        t1 = qMin(t1, tMax);
+    }
+    if (t0 > t1)
+        return false;
+
+    // The rounding can not leave the image, the bounds being integers
+    segmentOut.x0 = qBound(0, qRound(x0 + t0 * directions[0]), width - 1);
+    segmentOut.y0 = qBound(0, qRound(y0 + t0 * directions[1]), height - 1);
+    segmentOut.x1 = qBound(0, qRound(x0 + t1 * directions[0]), width - 1);
+    segmentOut.y1 = qBound(0, qRound(y0 + t1 * directions[1]), height - 1);
+
+    return true;
+}
+
+
+//------------------------------------------------------------------------------
+//! Find the root of a run in the union-find forest of the labeling, and make
+//! the runs of the path point directly to it
+//!
+//! @param parents The parent of each run
+//! @param noRun The run
+//!
+//! @return The root (the first run of the component found so far)
+//------------------------------------------------------------------------------
+static int findRoot(std::vector<int> &parents, int noRun)
+{
+    int root = noRun;
+    int next;
+
+    while (parents[root] != root)
+        root = parents[root];
+
+    while (parents[noRun] != root)
+    {
+        next           = parents[noRun];
+        parents[noRun] = root;
+        noRun          = next;
+    }
+
+    return root;
+}
+
+
+//------------------------------------------------------------------------------
+//! Find the run covering a pixel, the runs of its row covering the whole row
+//!
+//! @param runs The runs, in the raster order
+//! @param rowStarts The index of the first run of each row (and the number of
+//!                  runs at the end)
+//! @param x The abscissa of the pixel
+//! @param y The row of the pixel
+//!
+//! @return The run
+//------------------------------------------------------------------------------
+static int findRun(const std::vector<SRegionDetectionRun> &runs, const std::vector<int> &rowStarts, int x, int y)
+{
+    std::vector<SRegionDetectionRun>::const_iterator next = std::upper_bound(runs.begin() + rowStarts[y], runs.begin() + rowStarts[y + 1], x, [](int xPixel, const SRegionDetectionRun &run) {
+        return xPixel < run.x0;
+    });
+
+    return static_cast<int>(next - runs.begin()) - 1;
+}
+
+
+//------------------------------------------------------------------------------
+//! Restrict an interval of abscissas to the x such that
+//! |coefficient * (x - xCentre) + offset| <= halfWidth (a slab of a
+//! rectangle cut by a row), widened by one pixel against the rounding errors
+//!
+//! @param coefficient The coefficient of x - xCentre
+//! @param offset The part of the row (constant along it)
+//! @param halfWidth The half width of the slab
+//! @param xCentre The abscissa of the centre of the rectangle
+//! @param xMin The first abscissa of the interval (restricted)
+//! @param xMax The last abscissa of the interval (restricted)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+static void clipToSlab(qreal coefficient, qreal offset, qreal halfWidth, qreal xCentre, qreal &xMin, qreal &xMax)
+{
+    qreal bound0;
+    qreal bound1;
+
+    // A null coefficient leaves the whole row (the caller tests the pixels)
+    if (coefficient == 0)
+        return;
+
+    bound0 = (-halfWidth - offset) / coefficient;
+    bound1 = (halfWidth - offset) / coefficient;
+    xMin   = qMax(xMin, xCentre + qMin(bound0, bound1) - 1);
+    xMax   = qMin(xMax, xCentre + qMax(bound0, bound1) + 1);
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the logarithm of the tail of a binomial law: the probability to
+//! get at least k successes among n trials of probability p
+//!
+//! @param n The number of trials
+//! @param k The number of successes
+//! @param p The probability of a success
+//!
+//! @return log10(sum of C(n, i) * p^i * (1 - p)^(n - i) for i = k ... n)
+//------------------------------------------------------------------------------
+static qreal computeLogBinomialTail(int n, int k, qreal p)
+{
+    qreal term;
+    qreal tail;
+
+    if ((k <= 0) || (n <= 0))
+        return 0;
+    if (k > n)
+        return -std::numeric_limits<qreal>::infinity();
+
+    // Terms relative to the first one:
+    // term(i + 1) = term(i) * (n - i) / (i + 1) * p / (1 - p)
+    term = 1;
+    tail = 1;
+    for (int i = k; (i < n) && (term > tail * std::numeric_limits<qreal>::epsilon()); i++)
+    {
+        term *= static_cast<qreal>(n - i) / (i + 1) * p / (1 - p);
+        tail += term;
+    }
+
+    return (std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0) +
+            k * std::log(p) + (n - k) * std::log(1 - p) + std::log(tail)) /
+           std::log(10.0);
+}
 
 
 //------------------------------------------------------------------------------
@@ -36,6 +274,27 @@ CRegionDetection::CRegionDetection(QImage *imageIn)
         m_isValid = true;
     else
         m_isValid = false;
+
+    m_nAngles           = REGIONDETECTION_DEFAULT_NUMBER_ANGLES;
+    m_nLines            = REGIONDETECTION_DEFAULT_NUMBER_LINES;
+    m_maxRho            = 0;
+    m_nThreads          = CParallel::getIdealThreadCount();
+    m_isMultiresolution = false;
+    m_threshold         = REGIONDETECTION_DEFAULT_THRESHOLD;
+    m_minLength         = REGIONDETECTION_DEFAULT_MIN_LENGTH;
+    m_maxGap            = REGIONDETECTION_DEFAULT_MAX_GAP;
+    m_timeBudget        = REGIONDETECTION_DEFAULT_TIME_BUDGET;
+    m_minRadius         = REGIONDETECTION_DEFAULT_MIN_RADIUS;
+    m_maxRadius         = REGIONDETECTION_DEFAULT_MAX_RADIUS;
+    m_nCircles          = REGIONDETECTION_DEFAULT_NUMBER_CIRCLES;
+    m_connectedness     = REGIONDETECTION_DEFAULT_CONNECTEDNESS;
+    m_isGradientImage   = false;
+    m_nSuperpixels      = REGIONDETECTION_DEFAULT_SUPERPIXELS;
+    m_compactness       = REGIONDETECTION_DEFAULT_COMPACTNESS;
+    if (m_isValid)
+        m_maxRho = qCeil(qSqrt(static_cast<qreal>(m_imageOrigin->width()) * m_imageOrigin->width() +
+                               static_cast<qreal>(m_imageOrigin->height()) * m_imageOrigin->height()));
+    initTables();
 }
 
 
@@ -67,112 +326,3159 @@ QImage *CRegionDetection::getImageTreated(void)
 
 
 //------------------------------------------------------------------------------
-//! Entry point for the region detection
+//! Get the number of angles of the Hough accumulator
 //!
-//! @param typeDetectionRegion The type of the region detection
+//! @param _
+//!
+//! @return The number of angles (on 180 degrees)
+//------------------------------------------------------------------------------
+int CRegionDetection::getNumberAngles(void)
+{
+    return m_nAngles;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the maximal number of lines found by the Hough transform
+//!
+//! @param _
+//!
+//! @return The number of lines
+//------------------------------------------------------------------------------
+int CRegionDetection::getNumberLines(void)
+{
+    return m_nLines;
+}
+
+
+//------------------------------------------------------------------------------
+//! Set the parameters of the Hough transform
+//!
+//! @param nAngles The number of angles of the accumulator (on 180 degrees)
+//! @param nLines The maximal number of lines to find
 //!
 //! @return _
 //------------------------------------------------------------------------------
-void CRegionDetection::computeDetectionRegion(DETECTION_REGION_TYPE detectionRegionType)
+void CRegionDetection::setHough(int nAngles, int nLines)
 {
-    if (m_isValid)
+    m_nLines = qMax(nLines, 1);
+    if (qMax(nAngles, 1) != m_nAngles)
     {
-        switch (detectionRegionType)
-        {
-            case DETECTION_REGION_LINE:
-                computeLine();
-                break;
-
-            // include DETECTION_REGION_UNKNOWN
-            default:
-                break;
-        }
+        m_nAngles = qMax(nAngles, 1);
+        initTables();
     }
 }
 
 
 //------------------------------------------------------------------------------
-// Private Method(s):
+//! Get the number of threads of the Hough transform
+//!
+//! @param _
+//!
+//! @return The number of threads
+//------------------------------------------------------------------------------
+int CRegionDetection::getNumberThreads(void)
+{
+    return m_nThreads;
+}
+
 
 //------------------------------------------------------------------------------
-//! Create a grayscale (binary) image for a given image
+//! Set the number of threads of the Hough transform (the result does not
+//! depend on it)
 //!
-//! @param imageIn The input image
-//! @param imageOut The output image
+//! @param nThreads The number of threads (0 for the number of cores)
 //!
 //! @return _
 //------------------------------------------------------------------------------
-void CRegionDetection::createImageGray(QImage *imageIn, CImageInt *imageOut)
+void CRegionDetection::setNumberThreads(int nThreads)
 {
-    int GOut;
+    m_nThreads = (nThreads > 0) ? nThreads : CParallel::getIdealThreadCount();
+}
 
-    if (imageIn && imageOut)
-    {
-        for (int x = 0; x < imageIn->width(); x++)
-        {
-            for (int y = 0; y < imageIn->height(); y++)
-            {
-                GOut = (299 * qRed(imageIn->pixel(x, y)) +
-                        587 * qGreen(imageIn->pixel(x, y)) +
-                        114 * qBlue(imageIn->pixel(x, y))) /
-                       1000;
 
-                if (GOut < 128)
-                    (*imageOut)(x, y) = 0;
-                else
-                    (*imageOut)(x, y) = CIMAGEINT_MAX;
-            }
-        }
-    }
+//------------------------------------------------------------------------------
+//! Get if the line detection is computed coarse to fine
+//!
+//! @param _
+//!
+//! @return true or false
+//------------------------------------------------------------------------------
+bool CRegionDetection::isMultiresolution(void)
+{
+    return m_isMultiresolution;
+}
+
+
+//------------------------------------------------------------------------------
+//! Set if the line detection is computed coarse to fine (a coarse Hough
+//! transform on a reduced image, refined at full resolution around its peaks)
+//!
+//! @param isMultiresolution The multiresolution flag
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::setMultiresolution(bool isMultiresolution)
+{
+    m_isMultiresolution = isMultiresolution;
 }
 
 
 //------------------------------------------------------------------------------
-//! Detect a line in the image
+//! Get the time budget of the probabilistic Hough transform
 //!
 //! @param _
 //!
+//! @return The time budget (in milliseconds)
+//------------------------------------------------------------------------------
+int CRegionDetection::getTimeBudget(void)
+{
+    return m_timeBudget;
+}
+
+
+//------------------------------------------------------------------------------
+//! Set the time budget of the probabilistic Hough transform: the search stops
+//! with the segments already found when it is spent
+//!
+//! @param timeBudget The time budget (in milliseconds)
+//!
 //! @return _
 //------------------------------------------------------------------------------
-void CRegionDetection::computeLine(void)
+void CRegionDetection::setTimeBudget(int timeBudget)
 {
-    CImageInt *imageVote = nullptr;
-    int        aMin      = -m_imageOrigin->height();
-    int        aMax      = 2 * m_imageOrigin->height() + 1;
-    int        bMin      = -(2 * m_imageOrigin->height() + 1) * (m_imageOrigin->width() - 1);
-    int        bMax      = m_imageOrigin->height() * m_imageOrigin->width() - 1;
-    int        noVote    = 0;
-    int        aWin;
-    int        bWin;
+    m_timeBudget = qMax(timeBudget, 1);
+}
 
-    imageVote = new CImageInt(aMax - aMin + 1, bMax - bMin + 1);
 
-    for (int x = 0; x < m_imageOrigin->width(); x++)
-    {
-        for (int y = 0; y < m_imageOrigin->height(); y++)
-        {
-            for (int a = aMin; a <= aMax; a++)
-            {
-                (*imageVote)(a - aMin, y - a * x - bMin)++;
-            }
-        }
-    }
+//------------------------------------------------------------------------------
+//! Set the parameters of the probabilistic Hough transform
+//!
+//! @param threshold The number of votes making a line significant
+//! @param minLength The minimal length of a segment
+//! @param maxGap The maximal gap between two pixels of a segment
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::setSegmentParameters(int threshold, int minLength, int maxGap)
+{
+    m_threshold = qMax(threshold, 1);
+    m_minLength = qMax(minLength, 0);
+    m_maxGap    = qMax(maxGap, 0);
+}
 
-    for (int a = aMin; a <= aMax; a++)
-    {
-        for (int b = bMin; b <= bMax; b++)
-        {
-            if ((*imageVote)(a - aMin, b - bMin) > noVote)
-            {
-                aWin = a;
-                bWin = b;
-            }
-        }
-    }
 
-    CImage2QImage(imageVote, m_imageTreated);
+//------------------------------------------------------------------------------
+//! Get the minimal radius of the circles
+//!
+//! @param _
+//!
+//! @return The minimal radius (in pixels)
+//------------------------------------------------------------------------------
+int CRegionDetection::getMinRadius(void)
+{
+    return m_minRadius;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the maximal radius of the circles
+//!
+//! @param _
+//!
+//! @return The maximal radius (in pixels)
+//------------------------------------------------------------------------------
+int CRegionDetection::getMaxRadius(void)
+{
+    return m_maxRadius;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the maximal number of circles found by the circle detection
+//!
+//! @param _
+//!
+//! @return The number of circles
+//------------------------------------------------------------------------------
+int CRegionDetection::getNumberCircles(void)
+{
+    return m_nCircles;
+}
+
+
+//------------------------------------------------------------------------------
+//! Set the parameters of the circle detection
+//!
+//! @param minRadius The minimal radius (in pixels)
+//! @param maxRadius The maximal radius (in pixels)
+//! @param nCircles The maximal number of circles to find
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::setCircleParameters(int minRadius, int maxRadius, int nCircles)
+{
+    m_minRadius = qMax(minRadius, 1);
+    m_maxRadius = qMax(maxRadius, m_minRadius);
+    m_nCircles  = qMax(nCircles, 1);
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the connectedness of the labeling
+//!
+//! @param _
+//!
+//! @return The connectedness (4 or 8)
+//------------------------------------------------------------------------------
+int CRegionDetection::getConnectedness(void)
+{
+    return m_connectedness;
+}
+
+
+//------------------------------------------------------------------------------
+//! Set the connectedness of the labeling
+//!
+//! @param connectedness The connectedness (4 or 8, 8 for any other value)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::setConnectedness(int connectedness)
+{
+    m_connectedness = (connectedness == 4) ? 4 : 8;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get if the input image is already a gradient image for the watershed
+//!
+//! @param _
+//!
+//! @return true or false
+//------------------------------------------------------------------------------
+bool CRegionDetection::isGradientImage(void)
+{
+    return m_isGradientImage;
+}
+
 
-    delete imageVote;
+//------------------------------------------------------------------------------
+//! Set if the input image is already a gradient image (for example the output
+//! of the edge detection or a morphological gradient): the watershed then
+//! floods its luminance instead of its Sobel gradient
+//!
+//! @param isGradientImage The gradient image flag
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::setGradientImage(bool isGradientImage)
+{
+    m_isGradientImage = isGradientImage;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the wanted number of superpixels
+//!
+//! @param _
+//!
+//! @return The number of superpixels
+//------------------------------------------------------------------------------
+int CRegionDetection::getNumberSuperpixels(void)
+{
+    return m_nSuperpixels;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the compactness of the superpixels
+//!
+//! @param _
+//!
+//! @return The compactness
+//------------------------------------------------------------------------------
+int CRegionDetection::getCompactness(void)
+{
+    return m_compactness;
+}
+
+
+//------------------------------------------------------------------------------
+//! Set the parameters of the superpixel segmentation
+//!
+//! @param nSuperpixels The wanted number of superpixels (the final number
+//!                     depends on the grid and on the connectivity)
+//! @param compactness The weight of the distance in the image against the
+//!                    distance of the colors (larger for more regular
+//!                    superpixels)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::setSuperpixelParameters(int nSuperpixels, int compactness)
+{
+    m_nSuperpixels = qMax(nSuperpixels, 1);
+    m_compactness  = qMax(compactness, 1);
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the lines found by the last line detection, sorted by decreasing
+//! number of votes
+//!
+//! @param _
+//!
+//! @return The lines
+//------------------------------------------------------------------------------
+const std::vector<SRegionDetectionLine> &CRegionDetection::getLines(void)
+{
+    return m_lines;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the segments found by the last segment detection, in the order of
+//! detection (their ends are in the image)
+//!
+//! @param _
+//!
+//! @return The segments
+//------------------------------------------------------------------------------
+const std::vector<SRegionDetectionSegment> &CRegionDetection::getSegments(void)
+{
+    return m_segments;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the circles found by the last circle detection, sorted by decreasing
+//! number of votes
+//!
+//! @param _
+//!
+//! @return The circles
+//------------------------------------------------------------------------------
+const std::vector<SRegionDetectionCircle> &CRegionDetection::getCircles(void)
+{
+    return m_circles;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the label image of the last labeling, watershed or superpixel
+//! segmentation: 0 for the background, and 1 ... n for the components, the
+//! basins or the superpixels, numbered in the raster order of their first
+//! pixel (of their marker for the watershed)
+//!
+//! @param _
+//!
+//! @return The labels (y * width + x)
+//------------------------------------------------------------------------------
+const std::vector<int> &CRegionDetection::getLabels(void)
+{
+    return m_labels;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the components of the last labeling (the component of label n is the
+//! element n - 1), empty after a watershed or a superpixel segmentation
+//!
+//! @param _
+//!
+//! @return The components
+//------------------------------------------------------------------------------
+const std::vector<SRegionDetectionComponent> &CRegionDetection::getComponents(void)
+{
+    return m_components;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the borders of the last contour tracing, in the raster order of their
+//! first pixel
+//!
+//! @param _
+//!
+//! @return The borders
+//------------------------------------------------------------------------------
+const std::vector<SRegionDetectionContour> &CRegionDetection::getContours(void)
+{
+    return m_contours;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the superpixels of the last superpixel segmentation (the superpixel
+//! of label n is the element n - 1)
+//!
+//! @param _
+//!
+//! @return The superpixels
+//------------------------------------------------------------------------------
+const std::vector<SRegionDetectionSuperpixel> &CRegionDetection::getSuperpixels(void)
+{
+    return m_superpixels;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get a border of the last contour tracing as a closed polyline: its first
+//! pixel, then the pixels where its chain code changes of direction
+//!
+//! @param noContour The index of the border
+//! @param verticesOut The vertices (empty if the index is not valid)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::getContourVertices(int noContour, std::vector<QPoint> &verticesOut)
+{
+    int x;
+    int y;
+
+    verticesOut.clear();
+    if ((noContour < 0) || (noContour >= static_cast<int>(m_contours.size())))
+        return;
+
+    const SRegionDetectionContour &contour = m_contours[noContour];
+
+    x = contour.xStart;
+    y = contour.yStart;
+    verticesOut.push_back(QPoint(x, y));
+    for (size_t noCode = 0; noCode + 1 < contour.chainCodes.size(); noCode++)
+    {
+        x += freemanMoveX[contour.chainCodes[noCode]];
+        y += freemanMoveY[contour.chainCodes[noCode]];
+        if (contour.chainCodes[noCode + 1] != contour.chainCodes[noCode])
+            verticesOut.push_back(QPoint(x, y));
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Save the borders of the last contour tracing in a compact binary file
+//! (QDataStream, big endian):
+//! - the tag "CTR1", the width and the height of the image, the number of
+//!   borders (quint32);
+//! - for each border: its first pixel (quint32 x, quint32 y), its parent
+//!   (qint32), 1 for a hole or 0 (quint8), its number of chain codes
+//!   (quint32), then its chain codes packed on 3 bits (from the high bits of
+//!   the first byte).
+//!
+//! @param filename The name of the file
+//!
+//! @return true if the file has been written, false otherwise
+//------------------------------------------------------------------------------
+bool CRegionDetection::saveContours(const QString &filename)
+{
+    QFile              file(filename);
+    std::vector<uchar> packedCodes;
+    int                nBits;
+
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream stream(&file);
+
+    stream << static_cast<quint32>(REGIONDETECTION_CONTOUR_FILE_TAG)
+           << static_cast<quint32>(m_imageOrigin->width())
+           << static_cast<quint32>(m_imageOrigin->height())
+           << static_cast<quint32>(m_contours.size());
+    for (size_t noContour = 0; noContour < m_contours.size(); noContour++)
+    {
+        const SRegionDetectionContour &contour = m_contours[noContour];
+
+        packedCodes.assign((contour.chainCodes.size() * REGIONDETECTION_CONTOUR_CODE_BITS + 7) / 8, 0);
+        nBits = 0;
+        for (size_t noCode = 0; noCode < contour.chainCodes.size(); noCode++)
+        {
+            // A code spans at most two bytes
+            packedCodes[nBits / 8] |= static_cast<uchar>((contour.chainCodes[noCode] << (16 - REGIONDETECTION_CONTOUR_CODE_BITS - nBits % 8)) >> 8);
+            if (nBits % 8 > 8 - REGIONDETECTION_CONTOUR_CODE_BITS)
+                packedCodes[nBits / 8 + 1] |= static_cast<uchar>(contour.chainCodes[noCode] << (16 - REGIONDETECTION_CONTOUR_CODE_BITS - nBits % 8));
+            nBits += REGIONDETECTION_CONTOUR_CODE_BITS;
+        }
+
+        stream << static_cast<quint32>(contour.xStart)
+               << static_cast<quint32>(contour.yStart)
+               << static_cast<qint32>(contour.parent)
+               << static_cast<quint8>(contour.isHole)
+               << static_cast<quint32>(contour.chainCodes.size());
+        stream.writeRawData(reinterpret_cast<const char *>(packedCodes.data()), static_cast<int>(packedCodes.size()));
+    }
+    file.close();
+
+    return stream.status() == QDataStream::Ok;
+}
+
+
+//------------------------------------------------------------------------------
+//! Entry point for the region detection
+//!
+//! @param typeDetectionRegion The type of the region detection
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::computeDetectionRegion(DETECTION_REGION_TYPE detectionRegionType)
+{
+    if (m_isValid)
+    {
+        switch (detectionRegionType)
+        {
+            case DETECTION_REGION_LINE:
+                computeLine();
+                break;
+
+            case DETECTION_REGION_SEGMENT:
+                computeSegment();
+                break;
+
+            case DETECTION_REGION_CIRCLE:
+                computeCircle();
+                break;
+
+            case DETECTION_REGION_COMPONENT:
+                computeComponent();
+                break;
+
+            case DETECTION_REGION_WATERSHED_MINIMA:
+                computeWatershed(false);
+                break;
+
+            case DETECTION_REGION_WATERSHED_MARKERS:
+                computeWatershed(true);
+                break;
+
+            case DETECTION_REGION_SEGMENT_LSD:
+                computeSegmentLSD();
+                break;
+
+            case DETECTION_REGION_CONTOUR:
+                computeContour();
+                break;
+
+            case DETECTION_REGION_SUPERPIXEL:
+                computeSuperpixel();
+                break;
+
+            // include DETECTION_REGION_UNKNOWN
+            default:
+                break;
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Detect the lines of the image (see getLines) without drawing them, with
+//! the exhaustive or the multiresolution Hough transform (see
+//! setMultiresolution)
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::computeLines(void)
+{
+    if (m_isValid)
+    {
+        indexForeground();
+        if (m_isMultiresolution)
+        {
+            computeLineMultiresolution();
+        }
+        else
+        {
+            computeHoughAccumulator();
+            findPeaks(m_accumulator, m_nAngles, m_maxRho, REGIONDETECTION_PEAK_RADIUS, m_nLines, m_lines);
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+// Private Method(s):
+
+//------------------------------------------------------------------------------
+//! Create a grayscale (binary) image for a given image
+//!
+//! @param imageIn The input image
+//! @param imageOut The output image
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::createImageGray(QImage *imageIn, CImageInt *imageOut)
+{
+    int GOut;
+
+    if (imageIn && imageOut)
+    {
+        for (int x = 0; x < imageIn->width(); x++)
+        {
+            for (int y = 0; y < imageIn->height(); y++)
+            {
+                GOut = (299 * qRed(imageIn->pixel(x, y)) +
+                        587 * qGreen(imageIn->pixel(x, y)) +
+                        114 * qBlue(imageIn->pixel(x, y))) /
+                       1000;
+
+                if (GOut < 128)
+                    (*imageOut)(x, y) = 0;
+                else
+                    (*imageOut)(x, y) = CIMAGEINT_MAX;
+            }
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the cosine and sine tables of the angles of the Hough accumulator
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::initTables(void)
+{
+    m_cosTable.resize(m_nAngles);
+    m_sinTable.resize(m_nAngles);
+    for (int noAngle = 0; noAngle < m_nAngles; noAngle++)
+    {
+        m_cosTable[noAngle] = qCos(noAngle * M_PI / m_nAngles);
+        m_sinTable[noAngle] = qSin(noAngle * M_PI / m_nAngles);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Detect the lines of the image with the Hough transform: the lines
+//! x * cos(theta) + y * sin(theta) = rho are voted by the foreground pixels
+//! in a (theta, rho) accumulator of m_nAngles * (2 * diagonal + 1) cells, and
+//! the m_nLines highest local maxima are kept. The lines are drawn in red on
+//! the binarized image.
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::computeLine(void)
+{
+    computeLines();
+    CImage2QImage(m_imageGray, m_imageTreated);
+    drawLines();
+}
+
+
+//------------------------------------------------------------------------------
+//! Index the foreground pixels of the binarized image by rows and by columns
+//! (see SRegionDetectionPixelIndex), once: the binarized image does not
+//! change. The rows are counted and filled in parallel.
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::indexForeground(void)
+{
+    int              width  = m_imageGray->getWidth();
+    int              height = m_imageGray->getHeight();
+    std::vector<int> columnEnds;
+
+    if (!m_pixelIndex.rowStarts.empty())
+        return;
+
+    // Index by rows
+    m_pixelIndex.rowStarts.assign(height + 1, 0);
+    CParallel::run(height, m_nThreads, [&](int y) {
+        for (int x = 0; x < width; x++)
+        {
+            if (m_imageGray->get(x, y) != 0)
+                m_pixelIndex.rowStarts[y + 1]++;
+        }
+    });
+    for (int y = 0; y < height; y++)
+        m_pixelIndex.rowStarts[y + 1] += m_pixelIndex.rowStarts[y];
+    m_pixelIndex.rowX.resize(m_pixelIndex.rowStarts[height]);
+    CParallel::run(height, m_nThreads, [&](int y) {
+        int noPixel = m_pixelIndex.rowStarts[y];
+
+        for (int x = 0; x < width; x++)
+        {
+            if (m_imageGray->get(x, y) != 0)
+                m_pixelIndex.rowX[noPixel++] = x;
+        }
+    });
+
+    // Index by columns (counting sort of the rows)
+    m_pixelIndex.columnStarts.assign(width + 1, 0);
+    for (size_t noPixel = 0; noPixel < m_pixelIndex.rowX.size(); noPixel++)
+        m_pixelIndex.columnStarts[m_pixelIndex.rowX[noPixel] + 1]++;
+    for (int x = 0; x < width; x++)
+        m_pixelIndex.columnStarts[x + 1] += m_pixelIndex.columnStarts[x];
+    m_pixelIndex.columnY.resize(m_pixelIndex.rowX.size());
+    columnEnds.assign(m_pixelIndex.columnStarts.begin(), m_pixelIndex.columnStarts.end() - 1);
+    for (int y = 0; y < height; y++)
+    {
+        for (int noPixel = m_pixelIndex.rowStarts[y]; noPixel < m_pixelIndex.rowStarts[y + 1]; noPixel++)
+            m_pixelIndex.columnY[columnEnds[m_pixelIndex.rowX[noPixel]]++] = y;
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Fill the Hough accumulator: each foreground pixel votes once per angle
+//! (cell noAngle * (2 * m_maxRho + 1) + rho + m_maxRho). The accumulator is
+//! partitioned by angles between the threads: each task clears and votes for
+//! all the foreground pixels (see indexForeground) in its own rows, so no
+//! atomic operation, no per-thread copy of the accumulator and no merge are
+//! needed. There are REGIONDETECTION_TASKS_PER_THREAD tasks per thread (at
+//! most one per angle) to balance the load.
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::computeHoughAccumulator(void)
+{
+    int nRho   = 2 * m_maxRho + 1;
+    int nTasks = qBound(1, qMax(m_nThreads, 1) * REGIONDETECTION_TASKS_PER_THREAD, m_nAngles);
+
+    m_accumulator.resize(static_cast<size_t>(m_nAngles) * nRho);
+
+    CParallel::run(nTasks, m_nThreads, [&](int noTask) {
+        int * votes;
+        qreal cosTheta;
+        qreal sinTheta;
+        qreal rhoRow;
+
+        for (int noAngle = noTask * m_nAngles / nTasks; noAngle < (noTask + 1) * m_nAngles / nTasks; noAngle++)
+        {
+            votes = m_accumulator.data() + static_cast<size_t>(noAngle) * nRho;
+            std::fill(votes, votes + nRho, 0);
+            votes += m_maxRho;
+            cosTheta = m_cosTable[noAngle];
+            sinTheta = m_sinTable[noAngle];
+            for (int y = 0; y < m_imageGray->getHeight(); y++)
+            {
+                rhoRow = y * sinTheta;
+                for (int noPixel = m_pixelIndex.rowStarts[y]; noPixel < m_pixelIndex.rowStarts[y + 1]; noPixel++)
+                    votes[qRound(m_pixelIndex.rowX[noPixel] * cosTheta + rhoRow)]++;
+            }
+        }
+    });
+}
+
+
+//------------------------------------------------------------------------------
+//! Detect the lines coarse to fine: the binarized image is reduced by
+//! REGIONDETECTION_PYRAMID_FACTOR (a reduced pixel counts its set pixels and
+//! votes with this weight; the reduced pixels with less than
+//! REGIONDETECTION_PYRAMID_MIN_WEIGHT set pixels, isolated noise, do not vote)
+//! and voted in a coarse accumulator with REGIONDETECTION_PYRAMID_ANGLE_FACTOR
+//! times fewer angles. REGIONDETECTION_PYRAMID_PEAKS_PER_LINE * m_nLines
+//! coarse peaks are kept, with a suppression radius of
+//! REGIONDETECTION_PYRAMID_PEAK_RADIUS only: a coarse cell is already
+//! REGIONDETECTION_PYRAMID_FACTOR pixels wide, and a larger radius would hide
+//! the distinct lines close to a strong one.
+//!
+//! Each coarse peak selects the pixels of a band around its line: the coarse
+//! distance is known within factor * (1 + sqrt(2)) pixels, and the fine
+//! angles of the peak (up to one coarse step away) move the line by at most
+//! half its chord in the image times the sine of the step. The rows of the
+//! full accumulator around the coarse angles are then voted by the union of
+//! the bands covering them (a pixel in several bands votes once), the other
+//! rows staying empty, and the peaks are searched as in the exhaustive
+//! transform: a line whose voters all lie in a band gets its exact votes, and
+//! the peaks are the same as the exhaustive ones as long as the coarse level
+//! finds the lines.
+//!
+//! The pixels of a band are found from an index of the pixels by rows and by
+//! columns, so a peak costs O(max(width, height) * log(pixels)) plus the
+//! votes of its band. When these votes would outnumber the votes of the
+//! exhaustive transform (many lines, or bands covering most of the pixels),
+//! the exhaustive transform is computed instead.
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::computeLineMultiresolution(void)
+{
+    int                               factor          = REGIONDETECTION_PYRAMID_FACTOR;
+    int                               width           = m_imageGray->getWidth();
+    int                               height          = m_imageGray->getHeight();
+    int                               widthCoarse     = (width + factor - 1) / factor;
+    int                               heightCoarse    = (height + factor - 1) / factor;
+    int                               nAnglesCoarse   = qMax(m_nAngles / REGIONDETECTION_PYRAMID_ANGLE_FACTOR, 1);
+    int                               maxRhoCoarse    = qCeil(qSqrt(static_cast<qreal>(widthCoarse) * widthCoarse + static_cast<qreal>(heightCoarse) * heightCoarse));
+    int                               nRhoCoarse      = 2 * maxRhoCoarse + 1;
+    int                               anglesPerCoarse = (m_nAngles + nAnglesCoarse - 1) / nAnglesCoarse;
+    int                               nRho            = 2 * m_maxRho + 1;
+    std::vector<uchar>                imageCoarse(static_cast<size_t>(widthCoarse) * heightCoarse, 0);
+    std::vector<int>                  accumulatorCoarse(static_cast<size_t>(nAnglesCoarse) * nRhoCoarse, 0);
+    std::vector<SRegionDetectionLine> peaksCoarse;
+    std::vector<int>                  cellsCoarse;
+    std::vector<qreal>                rhos;
+    std::vector<qreal>                bands;
+    std::vector<std::vector<QPoint>>  bandPixels;
+    std::vector<std::vector<int>>     peaksByAngle;
+    std::vector<std::vector<bool>>    votedPixels(qMax(m_nThreads, 1), std::vector<bool>(static_cast<size_t>(width) * height, false));
+    int                               nAnglesRefined = 2 * anglesPerCoarse + 1;
+    qint64                            nVotesRefined  = 0;
+
+    // Coarse level
+    for (int y = 0; y < height; y++)
+    {
+        for (int noPixel = m_pixelIndex.rowStarts[y]; noPixel < m_pixelIndex.rowStarts[y + 1]; noPixel++)
+        {
+            if (imageCoarse[(y / factor) * widthCoarse + m_pixelIndex.rowX[noPixel] / factor]++ == 0)
+                cellsCoarse.push_back((y / factor) * widthCoarse + m_pixelIndex.rowX[noPixel] / factor);
+        }
+    }
+    cellsCoarse.erase(std::remove_if(cellsCoarse.begin(), cellsCoarse.end(), [&imageCoarse](int cell) {
+                          return imageCoarse[cell] < REGIONDETECTION_PYRAMID_MIN_WEIGHT;
+                      }),
+                      cellsCoarse.end());
+
+    CParallel::run(nAnglesCoarse, m_nThreads, [&](int noAngle) {
+        qreal cosTheta = qCos(noAngle * M_PI / nAnglesCoarse);
+        qreal sinTheta = qSin(noAngle * M_PI / nAnglesCoarse);
+        int * votes    = accumulatorCoarse.data() + static_cast<size_t>(noAngle) * nRhoCoarse + maxRhoCoarse;
+
+        // Each reduced pixel votes as many times as it has set pixels
+        for (size_t noCell = 0; noCell < cellsCoarse.size(); noCell++)
+            votes[qRound((cellsCoarse[noCell] % widthCoarse) * cosTheta + (cellsCoarse[noCell] / widthCoarse) * sinTheta)] += imageCoarse[cellsCoarse[noCell]];
+    });
+    findPeaks(accumulatorCoarse, nAnglesCoarse, maxRhoCoarse, REGIONDETECTION_PYRAMID_PEAK_RADIUS, REGIONDETECTION_PYRAMID_PEAKS_PER_LINE * m_nLines, peaksCoarse);
+
+    // Pixels of the bands (the centre of a reduced pixel is at
+    // x * factor + (factor - 1) / 2), the cost of the refinement being
+    // bounded by the exhaustive transform
+    rhos.resize(peaksCoarse.size());
+    bands.resize(peaksCoarse.size());
+    bandPixels.resize(peaksCoarse.size());
+    CParallel::run(static_cast<int>(peaksCoarse.size()), m_nThreads, [&](int noPeak) {
+        qreal theta = peaksCoarse[noPeak].theta;
+
+        rhos[noPeak]        = peaksCoarse[noPeak].rho * factor + (factor - 1) * (qCos(theta) + qSin(theta)) / 2;
+        bands[noPeak]       = factor * (1 + M_SQRT2) + computeChordLength(width, height, qCos(theta), qSin(theta), rhos[noPeak]) / 2 * qSin(anglesPerCoarse * M_PI / m_nAngles);
+        findBandPixels(m_pixelIndex, qCos(theta), qSin(theta), rhos[noPeak], bands[noPeak], bandPixels[noPeak]);
+    });
+    for (size_t noPeak = 0; noPeak < bandPixels.size(); noPeak++)
+        nVotesRefined += static_cast<qint64>(bandPixels[noPeak].size()) * nAnglesRefined;
+    if (nVotesRefined > static_cast<qint64>(m_pixelIndex.rowX.size()) * m_nAngles)
+    {
+        computeHoughAccumulator();
+        findPeaks(m_accumulator, m_nAngles, m_maxRho, REGIONDETECTION_PEAK_RADIUS, m_nLines, m_lines);
+        return;
+    }
+
+    // Coarse peaks covering each fine angle
+    peaksByAngle.resize(m_nAngles);
+    for (size_t noPeak = 0; noPeak < peaksCoarse.size(); noPeak++)
+    {
+        int noCentre = qRound(peaksCoarse[noPeak].theta * m_nAngles / M_PI);
+
+        for (int noAngle = noCentre - anglesPerCoarse; noAngle <= noCentre + anglesPerCoarse; noAngle++)
+            peaksByAngle[(noAngle % m_nAngles + m_nAngles) % m_nAngles].push_back(static_cast<int>(noPeak));
+    }
+
+    // Refinement at full resolution: each row of the accumulator is voted by
+    // the union of the bands covering its angle (a pixel in several bands
+    // votes once), then searched as in the exhaustive transform
+    m_accumulator.resize(static_cast<size_t>(m_nAngles) * nRho);
+    CParallel::runWithThreadIndex(m_nAngles, m_nThreads, [&](int noAngle, int noThread) {
+        const std::vector<int> &peaks    = peaksByAngle[noAngle];
+        std::vector<bool> &     isVoted  = votedPixels[noThread];
+        int *                   votes    = m_accumulator.data() + static_cast<size_t>(noAngle) * nRho;
+        qreal                   cosTheta = m_cosTable[noAngle];
+        qreal                   sinTheta = m_sinTable[noAngle];
+        int                     noPixel;
+
+        std::fill(votes, votes + nRho, 0);
+        votes += m_maxRho;
+        for (size_t i = 0; i < peaks.size(); i++)
+        {
+            const std::vector<QPoint> &pixels = bandPixels[peaks[i]];
+
+            for (size_t j = 0; j < pixels.size(); j++)
+            {
+                noPixel = pixels[j].y() * width + pixels[j].x();
+                if (!isVoted[noPixel])
+                {
+                    isVoted[noPixel] = true;
+                    votes[qRound(pixels[j].x() * cosTheta + pixels[j].y() * sinTheta)]++;
+                }
+            }
+        }
+
+        // Cleared for the next angle of the thread
+        for (size_t i = 0; i < peaks.size(); i++)
+        {
+            const std::vector<QPoint> &pixels = bandPixels[peaks[i]];
+
+            for (size_t j = 0; j < pixels.size(); j++)
+                isVoted[pixels[j].y() * width + pixels[j].x()] = false;
+        }
+    });
+    findPeaks(m_accumulator, m_nAngles, m_maxRho, REGIONDETECTION_PEAK_RADIUS, m_nLines, m_lines);
+}
+
+
+//------------------------------------------------------------------------------
+//! Find the foreground pixels of the band |x * cos(theta) + y * sin(theta) -
+//! rho| <= band: the band is cut by the rows (steep lines) or by the columns
+//! (flat lines), which gives on each one an interval of at most
+//! 2 * sqrt(2) * band pixels, searched in the sorted pixels of the index.
+//!
+//! @param pixelIndex The pixels indexed by rows and by columns
+//! @param cosTheta The cosine of the angle of the line
+//! @param sinTheta The sine of the angle of the line
+//! @param rho The distance of the line
+//! @param band The half width of the band
+//! @param pixelsOut The pixels of the band
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::findBandPixels(const SRegionDetectionPixelIndex &pixelIndex, qreal cosTheta, qreal sinTheta, qreal rho, qreal band, std::vector<QPoint> &pixelsOut)
+{
+    bool                    isByRow     = (qAbs(cosTheta) >= qAbs(sinTheta));
+    const std::vector<int> &starts      = isByRow ? pixelIndex.rowStarts : pixelIndex.columnStarts;
+    const std::vector<int> &coordinates = isByRow ? pixelIndex.rowX : pixelIndex.columnY;
+    qreal                   along       = isByRow ? sinTheta : cosTheta;
+    qreal                   across      = isByRow ? cosTheta : sinTheta;
+    qreal                   bound0;
+    qreal                   bound1;
+    int                     x;
+    int                     y;
+
+    for (int line = 0; line + 1 < static_cast<int>(starts.size()); line++)
+    {
+        // |across * coordinate + along * line - rho| <= band, widened by one
+        // pixel against the rounding errors
+        bound0 = (rho - band - along * line) / across;
+        bound1 = (rho + band - along * line) / across;
+        if (bound0 > bound1)
+            std::swap(bound0, bound1);
+
+        std::vector<int>::const_iterator first = std::lower_bound(coordinates.begin() + starts[line], coordinates.begin() + starts[line + 1], qCeil(bound0) - 1);
+        std::vector<int>::const_iterator last  = std::upper_bound(first, coordinates.begin() + starts[line + 1], qFloor(bound1) + 1);
+
+        for (; first != last; ++first)
+        {
+            x = isByRow ? *first : line;
+            y = isByRow ? line : *first;
+            if (qAbs(x * cosTheta + y * sinTheta - rho) <= band)
+                pixelsOut.push_back(QPoint(x, y));
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Find the cells of an accumulator with the most votes among its local
+//! maxima. The rows of angles are searched in parallel, each thread keeping
+//! its own list of local maxima.
+//!
+//! @param accumulator The accumulator (nAngles rows of 2 * maxRho + 1 cells)
+//! @param nAngles The number of angles (on 180 degrees)
+//! @param maxRho The maximal distance
+//! @param radius The radius of the neighborhood of a peak (see isPeak)
+//! @param nPeaks The maximal number of peaks
+//! @param peaksOut The peaks, sorted by decreasing number of votes
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::findPeaks(const std::vector<int> &accumulator, int nAngles, int maxRho, int radius, int nPeaks, std::vector<SRegionDetectionLine> &peaksOut)
+{
+    int                                            nRho = 2 * maxRho + 1;
+    std::vector<std::vector<SRegionDetectionLine>> peaks(qMax(m_nThreads, 1));
+
+    CParallel::runWithThreadIndex(nAngles, m_nThreads, [&](int noAngle, int noThread) {
+        SRegionDetectionLine line;
+
+        for (int rho = -maxRho; rho <= maxRho; rho++)
+        {
+            if (isPeak(accumulator, nAngles, maxRho, radius, noAngle, rho))
+            {
+                line.rho   = rho;
+                line.theta = noAngle * M_PI / nAngles;
+                line.votes = accumulator[noAngle * nRho + rho + maxRho];
+                peaks[noThread].push_back(line);
+            }
+        }
+    });
+
+    peaksOut.clear();
+    for (size_t noThread = 0; noThread < peaks.size(); noThread++)
+        peaksOut.insert(peaksOut.end(), peaks[noThread].begin(), peaks[noThread].end());
+
+    // Same order whatever the number of threads
+    std::sort(peaksOut.begin(), peaksOut.end(), [](const SRegionDetectionLine &line1, const SRegionDetectionLine &line2) {
+        if (line1.votes != line2.votes)
+            return line1.votes > line2.votes;
+        if (line1.theta != line2.theta)
+            return line1.theta < line2.theta;
+        return line1.rho < line2.rho;
+    });
+    if (peaksOut.size() > static_cast<size_t>(nPeaks))
+        peaksOut.resize(nPeaks);
+}
+
+
+//------------------------------------------------------------------------------
+//! Check if a cell of the accumulator is a local maximum (the angles wrap
+//! around, theta + pi being the line of angle theta and of distance -rho).
+//! The ties are broken by the position of the cells, so that a plateau gives
+//! a single maximum.
+//!
+//! @param accumulator The accumulator (nAngles rows of 2 * maxRho + 1 cells)
+//! @param nAngles The number of angles (on 180 degrees)
+//! @param maxRho The maximal distance
+//! @param radius The radius of the neighborhood, in angles and in distances
+//! @param noAngle The angle of the cell
+//! @param rho The distance of the cell
+//!
+//! @return true if the cell is a local maximum with at least one vote
+//! @return false otherwise
+//------------------------------------------------------------------------------
+bool CRegionDetection::isPeak(const std::vector<int> &accumulator, int nAngles, int maxRho, int radius, int noAngle, int rho)
+{
+    int nRho  = 2 * maxRho + 1;
+    int votes = accumulator[noAngle * nRho + rho + maxRho];
+    int noAngleNeighbor;
+    int rhoNeighbor;
+    int votesNeighbor;
+
+    if (votes == 0)
+        return false;
+
+    for (int dAngle = -radius; dAngle <= radius; dAngle++)
+    {
+        for (int dRho = -radius; dRho <= radius; dRho++)
+        {
+            noAngleNeighbor = noAngle + dAngle;
+            rhoNeighbor     = rho + dRho;
+            if ((noAngleNeighbor < 0) || (noAngleNeighbor >= nAngles))
+            {
+                noAngleNeighbor = (noAngleNeighbor + nAngles) % nAngles;
+                rhoNeighbor     = -rhoNeighbor;
+            }
+            if ((rhoNeighbor < -maxRho) || (rhoNeighbor > maxRho) || ((dAngle == 0) && (dRho == 0)))
+                continue;
+
+            votesNeighbor = accumulator[noAngleNeighbor * nRho + rhoNeighbor + maxRho];
+            if ((votesNeighbor > votes) ||
+                ((votesNeighbor == votes) && ((noAngleNeighbor < noAngle) || ((noAngleNeighbor == noAngle) && (rhoNeighbor < rho)))))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+//------------------------------------------------------------------------------
+//! Draw the lines found (in red) on the treated image
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::drawLines(void)
+{
+    qreal cosTheta;
+    qreal sinTheta;
+    int   coordinate;
+
+    for (size_t noLine = 0; noLine < m_lines.size(); noLine++)
+    {
+        cosTheta = qCos(m_lines[noLine].theta);
+        sinTheta = qSin(m_lines[noLine].theta);
+
+        if (qAbs(sinTheta) >= qAbs(cosTheta))
+        {
+            for (int x = 0; x < m_imageTreated->width(); x++)
+            {
+                coordinate = qRound((m_lines[noLine].rho - x * cosTheta) / sinTheta);
+                if ((coordinate >= 0) && (coordinate < m_imageTreated->height()))
+                    m_imageTreated->setPixel(x, coordinate, qRgb(CIMAGEINT_MAX, 0, 0));
+            }
+        }
+        else
+        {
+            for (int y = 0; y < m_imageTreated->height(); y++)
+            {
+                coordinate = qRound((m_lines[noLine].rho - y * sinTheta) / cosTheta);
+                if ((coordinate >= 0) && (coordinate < m_imageTreated->width()))
+                    m_imageTreated->setPixel(coordinate, y, qRgb(CIMAGEINT_MAX, 0, 0));
+            }
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Detect the main segments of the image with the progressive probabilistic
+//! Hough transform (Matas et al.): the foreground pixels vote one at a time,
+//! in a random order. As soon as a cell of the voting pixel exceeds the
+//! threshold, the line is followed from this pixel in both directions (with
+//! gaps up to m_maxGap) to get the segment; its pixels are removed, and their
+//! votes are withdrawn if the segment is long enough to be kept. The search
+//! stops after m_nLines segments, when all the pixels have voted or when the
+//! time budget is spent.
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::computeSegment(void)
+{
+    int                     width  = m_imageGray->getWidth();
+    int                     height = m_imageGray->getHeight();
+    int                     nRho   = 2 * m_maxRho + 1;
+    std::vector<int>        pixels;
+    std::mt19937            generator(0);
+    QElapsedTimer           timer;
+    SRegionDetectionSegment segment;
+    int                     x;
+    int                     y;
+    int                     xLine;
+    int                     yLine;
+    int                     rho;
+    int                     votes;
+    int                     votesMax;
+    int                     noAngleMax;
+    qreal                   dx;
+    qreal                   dy;
+    int                     ends[2][2];
+    int                     gap;
+    int                     nSteps;
+    bool                    isKept;
+
+    timer.start();
+
+    // State of the pixels: 0 background or removed, 1 not voted yet, 2 voted
+    m_accumulator.assign(static_cast<size_t>(m_nAngles) * nRho, 0);
+    m_pixelStates.assign(static_cast<size_t>(width) * height, 0);
+    m_segments.clear();
+    for (y = 0; y < height; y++)
+    {
+        for (x = 0; x < width; x++)
+        {
+            if (m_imageGray->get(x, y) != 0)
+            {
+                m_pixelStates[y * width + x] = 1;
+                pixels.push_back(y * width + x);
+            }
+        }
+    }
+    std::shuffle(pixels.begin(), pixels.end(), generator);
+
+    for (size_t noPixel = 0; (noPixel < pixels.size()) && (m_segments.size() < static_cast<size_t>(m_nLines)); noPixel++)
+    {
+        if (timer.elapsed() >= m_timeBudget)
+            break;
+
+        x = pixels[noPixel] % width;
+        y = pixels[noPixel] / width;
+        if (m_pixelStates[pixels[noPixel]] != 1)
+            continue;
+
+        // Vote and keep the best cell of the pixel
+        m_pixelStates[pixels[noPixel]] = 2;
+        votesMax                       = 0;
+        noAngleMax                     = 0;
+        for (int noAngle = 0; noAngle < m_nAngles; noAngle++)
+        {
+            rho   = qRound(x * m_cosTable[noAngle] + y * m_sinTable[noAngle]);
+            votes = ++m_accumulator[noAngle * nRho + rho + m_maxRho];
+            if (votes > votesMax)
+            {
+                votesMax   = votes;
+                noAngleMax = noAngle;
+            }
+        }
+        if (votesMax < m_threshold)
+            continue;
+
+        // Follow the line in both directions (one pixel per step along the
+        // main axis)
+        dx = -m_sinTable[noAngleMax] / qMax(qAbs(m_sinTable[noAngleMax]), qAbs(m_cosTable[noAngleMax]));
+        dy = m_cosTable[noAngleMax] / qMax(qAbs(m_sinTable[noAngleMax]), qAbs(m_cosTable[noAngleMax]));
+        for (int direction = 0; direction < 2; direction++)
+        {
+            ends[direction][0] = x;
+            ends[direction][1] = y;
+            gap                = 0;
+            for (int noStep = 1;; noStep++)
+            {
+                xLine = qRound(x + (direction ? -noStep : noStep) * dx);
+                yLine = qRound(y + (direction ? -noStep : noStep) * dy);
+
+                if ((xLine < 0) || (xLine >= width) || (yLine < 0) || (yLine >= height))
+                    break;
+                if (m_pixelStates[yLine * width + xLine] != 0)
+                {
+                    gap                = 0;
+                    ends[direction][0] = xLine;
+                    ends[direction][1] = yLine;
+                }
+                else if (++gap > m_maxGap)
+                {
+                    break;
+                }
+            }
+        }
+
+        segment.x0 = ends[1][0];
+        segment.y0 = ends[1][1];
+        segment.x1 = ends[0][0];
+        segment.y1 = ends[0][1];
+        nSteps     = qMax(qAbs(segment.x1 - segment.x0), qAbs(segment.y1 - segment.y0));
+        isKept     = (nSteps + 1 >= m_minLength);
+
+        // Remove the pixels of the segment (and their votes if it is kept)
+        for (int noStep = 0; noStep <= nSteps; noStep++)
+        {
+            xLine = nSteps ? segment.x0 + qRound(static_cast<qreal>(noStep) * (segment.x1 - segment.x0) / nSteps) : segment.x0;
+            yLine = nSteps ? segment.y0 + qRound(static_cast<qreal>(noStep) * (segment.y1 - segment.y0) / nSteps) : segment.y0;
+
+            if (isKept && (m_pixelStates[yLine * width + xLine] == 2))
+                voteSegmentPixel(xLine, yLine, -1);
+            m_pixelStates[yLine * width + xLine] = 0;
+        }
+
+        if (isKept)
+            m_segments.push_back(segment);
+    }
+
+    CImage2QImage(m_imageGray, m_imageTreated);
+    drawSegments();
+}
+
+
+//------------------------------------------------------------------------------
+//! Add or withdraw the votes of a pixel for all the angles
+//!
+//! @param x The X coordinate
+//! @param y The Y coordinate
+//! @param vote 1 to vote, -1 to withdraw the votes
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::voteSegmentPixel(int x, int y, int vote)
+{
+    int  nRho  = 2 * m_maxRho + 1;
+    int *votes = m_accumulator.data() + m_maxRho;
+
+    for (int noAngle = 0; noAngle < m_nAngles; noAngle++, votes += nRho)
+        votes[qRound(x * m_cosTable[noAngle] + y * m_sinTable[noAngle])] += vote;
+}
+
+
+//------------------------------------------------------------------------------
+//! Draw the segments found (in red) on the treated image, the pixels outside
+//! the image being skipped
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::drawSegments(void)
+{
+    int nSteps;
+    int x;
+    int y;
+
+    for (size_t noSegment = 0; noSegment < m_segments.size(); noSegment++)
+    {
+        const SRegionDetectionSegment &segment = m_segments[noSegment];
+
+        nSteps = qMax(qAbs(segment.x1 - segment.x0), qAbs(segment.y1 - segment.y0));
+        for (int noStep = 0; noStep <= nSteps; noStep++)
+        {
+            x = nSteps ? segment.x0 + qRound(static_cast<qreal>(noStep) * (segment.x1 - segment.x0) / nSteps) : segment.x0;
+            y = nSteps ? segment.y0 + qRound(static_cast<qreal>(noStep) * (segment.y1 - segment.y0) / nSteps) : segment.y0;
+            if ((x >= 0) && (x < m_imageTreated->width()) && (y >= 0) && (y < m_imageTreated->height()))
+                m_imageTreated->setPixel(x, y, qRgb(CIMAGEINT_MAX, 0, 0));
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the Sobel gradient of the original image with the edge detection
+//! (CEdgeDetection::computeGradientSobel). The gradient is computed once and
+//! shared by the circle detection, the watershed and the line segment
+//! detection.
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::computeGradient(void)
+{
+    if (m_gradientMagnitude.empty())
+    {
+        CEdgeDetection edgeDetection(m_imageOrigin);
+
+        edgeDetection.computeGradientSobel(m_nThreads, m_gradientX, m_gradientY, m_gradientMagnitude);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Find the edge pixels from the gradient: the pixels whose magnitude is at
+//! least REGIONDETECTION_EDGE_THRESHOLD and is maximal along the gradient
+//! direction (rounded to 45 degrees), so that the edges are one pixel thick
+//!
+//! @param edgesOut The edge pixels (y * width + x), in the raster order
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::findEdges(std::vector<int> &edgesOut)
+{
+    int        width     = m_imageOrigin->width();
+    int        height    = m_imageOrigin->height();
+    const int *magnitude = m_gradientMagnitude.data();
+    int        gX;
+    int        gY;
+    int        offset;
+
+    edgesOut.clear();
+    for (int y = 1; y < height - 1; y++)
+    {
+        for (int x = 1; x < width - 1; x++)
+        {
+            if (magnitude[y * width + x] < REGIONDETECTION_EDGE_THRESHOLD)
+                continue;
+
+            // Neighbor along the gradient (tan(22.5) ~ 5 / 12)
+            gX = m_gradientX[y * width + x];
+            gY = m_gradientY[y * width + x];
+            if (12 * qAbs(gY) <= 5 * qAbs(gX))
+                offset = 1;
+            else if (12 * qAbs(gX) <= 5 * qAbs(gY))
+                offset = width;
+            else if ((gX > 0) == (gY > 0))
+                offset = width + 1;
+            else
+                offset = width - 1;
+
+            // Strict on one side only, so that a plateau of two pixels
+            // keeps one of them
+            if ((magnitude[y * width + x] > magnitude[y * width + x - offset]) &&
+                (magnitude[y * width + x] >= magnitude[y * width + x + offset]))
+                edgesOut.push_back(y * width + x);
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Detect the circles of the image with the gradient Hough transform: each
+//! edge pixel votes for the centres along its gradient direction only, for
+//! the radii from m_minRadius to m_maxRadius and on both sides (the circle
+//! can be darker or lighter than the background), in a 2-D accumulator of
+//! the size of the image. The best local maxima of this accumulator are the
+//! candidate centres; the radius of each one is the peak of the histogram of
+//! the distances of the edge pixels pointing to it. The memory is linear in
+//! the size of the image whatever the range of radii.
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::computeCircle(void)
+{
+    int                                 width  = m_imageOrigin->width();
+    int                                 height = m_imageOrigin->height();
+    std::vector<int>                    edges;
+    std::vector<int>                    centres;
+    std::vector<SRegionDetectionCircle> circles;
+    qreal                               unitX;
+    qreal                               unitY;
+    int                                 xCentre;
+    int                                 yCentre;
+    bool                                isDuplicate;
+
+    computeGradient();
+    findEdges(edges);
+
+    // Votes along the gradient direction
+    m_accumulator.assign(static_cast<size_t>(width) * height, 0);
+    for (size_t noEdge = 0; noEdge < edges.size(); noEdge++)
+    {
+        unitX = static_cast<qreal>(m_gradientX[edges[noEdge]]) / m_gradientMagnitude[edges[noEdge]];
+        unitY = static_cast<qreal>(m_gradientY[edges[noEdge]]) / m_gradientMagnitude[edges[noEdge]];
+        for (int radius = m_minRadius; radius <= m_maxRadius; radius++)
+        {
+            for (int side = -1; side <= 1; side += 2)
+            {
+                xCentre = qRound(edges[noEdge] % width + side * radius * unitX);
+                yCentre = qRound(edges[noEdge] / width + side * radius * unitY);
+                if ((xCentre >= 0) && (xCentre < width) && (yCentre >= 0) && (yCentre < height))
+                    m_accumulator[yCentre * width + xCentre]++;
+            }
+        }
+    }
+
+    // Radius of each candidate centre
+    smoothCentres();
+    findCentres(4 * m_nCircles, centres);
+    circles.resize(centres.size());
+    CParallel::run(static_cast<int>(centres.size()), m_nThreads, [&](int noCentre) {
+        computeRadius(edges, centres[noCentre], circles[noCentre]);
+    });
+
+    // Best circles, the circles found from two close centres removed
+    std::stable_sort(circles.begin(), circles.end(), [](const SRegionDetectionCircle &circle1, const SRegionDetectionCircle &circle2) {
+        return circle1.votes > circle2.votes;
+    });
+    m_circles.clear();
+    for (size_t noCircle = 0; (noCircle < circles.size()) && (m_circles.size() < static_cast<size_t>(m_nCircles)); noCircle++)
+    {
+        if (circles[noCircle].votes == 0)
+            continue;
+
+        isDuplicate = false;
+        for (size_t noKept = 0; noKept < m_circles.size(); noKept++)
+        {
+            if ((qAbs(m_circles[noKept].x - circles[noCircle].x) <= 2 * REGIONDETECTION_PEAK_RADIUS) &&
+                (qAbs(m_circles[noKept].y - circles[noCircle].y) <= 2 * REGIONDETECTION_PEAK_RADIUS) &&
+                (qAbs(m_circles[noKept].radius - circles[noCircle].radius) <= REGIONDETECTION_PEAK_RADIUS))
+                isDuplicate = true;
+        }
+        if (!isDuplicate)
+            m_circles.push_back(circles[noCircle]);
+    }
+
+    CImage2QImage(m_imageGray, m_imageTreated);
+    drawCircles();
+}
+
+
+//------------------------------------------------------------------------------
+//! Sum the votes of the centre accumulator over a square of radius
+//! REGIONDETECTION_CENTRE_RADIUS (rows then columns): the votes of a circle
+//! are spread around its centre by the error on the gradient direction.
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::smoothCentres(void)
+{
+    int              width  = m_imageOrigin->width();
+    int              height = m_imageOrigin->height();
+    std::vector<int> sums(m_accumulator.size(), 0);
+
+    CParallel::run(height, m_nThreads, [&](int y) {
+        for (int x = 0; x < width; x++)
+        {
+            for (int xNeighbor = qMax(x - REGIONDETECTION_CENTRE_RADIUS, 0); xNeighbor <= qMin(x + REGIONDETECTION_CENTRE_RADIUS, width - 1); xNeighbor++)
+                sums[y * width + x] += m_accumulator[y * width + xNeighbor];
+        }
+    });
+    CParallel::run(height, m_nThreads, [&](int y) {
+        for (int x = 0; x < width; x++)
+        {
+            m_accumulator[y * width + x] = 0;
+            for (int yNeighbor = qMax(y - REGIONDETECTION_CENTRE_RADIUS, 0); yNeighbor <= qMin(y + REGIONDETECTION_CENTRE_RADIUS, height - 1); yNeighbor++)
+                m_accumulator[y * width + x] += sums[yNeighbor * width + x];
+        }
+    });
+}
+
+
+//------------------------------------------------------------------------------
+//! Find the candidate centres: the local maxima of the centre accumulator in
+//! a window of radius REGIONDETECTION_PEAK_RADIUS (the ties broken by the
+//! position, as for the lines). The rows are searched in parallel.
+//!
+//! @param nCentres The maximal number of centres
+//! @param centresOut The centres (y * width + x), sorted by decreasing number
+//!                   of votes
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::findCentres(int nCentres, std::vector<int> &centresOut)
+{
+    int                           width  = m_imageOrigin->width();
+    int                           height = m_imageOrigin->height();
+    std::vector<std::vector<int>> centres(qMax(m_nThreads, 1));
+
+    CParallel::runWithThreadIndex(height, m_nThreads, [&](int y, int noThread) {
+        int  votes;
+        int  noNeighbor;
+        bool isMaximum;
+
+        for (int x = 0; x < width; x++)
+        {
+            votes     = m_accumulator[y * width + x];
+            isMaximum = (votes > 0);
+            for (int yNeighbor = qMax(y - REGIONDETECTION_PEAK_RADIUS, 0); isMaximum && (yNeighbor <= qMin(y + REGIONDETECTION_PEAK_RADIUS, height - 1)); yNeighbor++)
+            {
+                for (int xNeighbor = qMax(x - REGIONDETECTION_PEAK_RADIUS, 0); isMaximum && (xNeighbor <= qMin(x + REGIONDETECTION_PEAK_RADIUS, width - 1)); xNeighbor++)
+                {
+                    noNeighbor = yNeighbor * width + xNeighbor;
+                    if ((m_accumulator[noNeighbor] > votes) ||
+                        ((m_accumulator[noNeighbor] == votes) && (noNeighbor < y * width + x)))
+                        isMaximum = false;
+                }
+            }
+            if (isMaximum)
+                centres[noThread].push_back(y * width + x);
+        }
+    });
+
+    centresOut.clear();
+    for (size_t noThread = 0; noThread < centres.size(); noThread++)
+        centresOut.insert(centresOut.end(), centres[noThread].begin(), centres[noThread].end());
+
+    // Same order whatever the number of threads
+    std::sort(centresOut.begin(), centresOut.end(), [&](int centre1, int centre2) {
+        if (m_accumulator[centre1] != m_accumulator[centre2])
+            return m_accumulator[centre1] > m_accumulator[centre2];
+        return centre1 < centre2;
+    });
+    if (centresOut.size() > static_cast<size_t>(nCentres))
+        centresOut.resize(nCentres);
+}
+
+
+//------------------------------------------------------------------------------
+//! Find the circle of a candidate centre. The candidate is only close to the
+//! centre (the gradient directions are not exact), so a first radius is found
+//! with a tolerance of REGIONDETECTION_PEAK_RADIUS, the centre is fitted on
+//! the edge pixels of this radius, and the radius is found again from the
+//! fitted centre. The circle is kept if at least
+//! REGIONDETECTION_CIRCLE_MIN_COVERAGE percent of its perimeter is covered.
+//!
+//! @param edges The edge pixels (y * width + x)
+//! @param centre The candidate centre (y * width + x)
+//! @param circleOut The circle found (with no votes if there is none)
+//!
+//! @return true if a circle is found
+//! @return false otherwise
+//------------------------------------------------------------------------------
+bool CRegionDetection::computeRadius(const std::vector<int> &edges, int centre, SRegionDetectionCircle &circleOut)
+{
+    int width = m_imageOrigin->width();
+    int radius;
+    int support;
+
+    circleOut.x      = centre % width;
+    circleOut.y      = centre / width;
+    circleOut.radius = 0;
+    circleOut.votes  = 0;
+
+    radius = findRadius(edges, circleOut.x, circleOut.y, REGIONDETECTION_PEAK_RADIUS, support);
+    if (radius == 0)
+        return false;
+
+    fitCentre(edges, radius, circleOut.x, circleOut.y);
+    radius = findRadius(edges, circleOut.x, circleOut.y, 1, support);
+    if ((radius == 0) || (100 * support < REGIONDETECTION_CIRCLE_MIN_COVERAGE * 2 * M_PI * radius))
+        return false;
+
+    circleOut.radius = radius;
+    circleOut.votes  = support;
+
+    return true;
+}
+
+
+//------------------------------------------------------------------------------
+//! Find the radius of the circle of a given centre: the edge pixels pointing
+//! to the centre vote for their distance to it, and the radius kept has the
+//! most votes (over the radii radius +/- halfWidth) per unit of perimeter
+//!
+//! @param edges The edge pixels (y * width + x)
+//! @param xCentre The X coordinate of the centre
+//! @param yCentre The Y coordinate of the centre
+//! @param halfWidth The tolerance on the distances
+//! @param supportOut The number of votes of the radius
+//!
+//! @return The radius (0 if no edge pixel points to the centre)
+//------------------------------------------------------------------------------
+int CRegionDetection::findRadius(const std::vector<int> &edges, int xCentre, int yCentre, int halfWidth, int &supportOut)
+{
+    std::vector<int> histogram(m_maxRadius + halfWidth + 1, 0);
+    int              radiusMax = 0;
+    int              support;
+    qreal            distance;
+
+    supportOut = 0;
+    for (size_t noEdge = 0; noEdge < edges.size(); noEdge++)
+    {
+        if (isPointingToCentre(edges[noEdge], xCentre, yCentre, distance) &&
+            (qRound(distance) >= m_minRadius - halfWidth) && (qRound(distance) <= m_maxRadius + halfWidth))
+            histogram[qRound(distance)]++;
+    }
+
+    // Most votes per unit of perimeter (support / radius)
+    for (int radius = m_minRadius; radius <= m_maxRadius; radius++)
+    {
+        support = 0;
+        for (int r = qMax(radius - halfWidth, 0); r <= radius + halfWidth; r++)
+            support += histogram[r];
+        if (static_cast<qint64>(support) * qMax(radiusMax, 1) > static_cast<qint64>(supportOut) * radius)
+        {
+            supportOut = support;
+            radiusMax  = radius;
+        }
+    }
+
+    return radiusMax;
+}
+
+
+//------------------------------------------------------------------------------
+//! Fit the centre of a circle (least squares on x^2 + y^2 + D * x + E * y + F,
+//! Kasa) on the edge pixels pointing to the centre at the given radius (up to
+//! REGIONDETECTION_PEAK_RADIUS)
+//!
+//! @param edges The edge pixels (y * width + x)
+//! @param radius The radius
+//! @param xCentre The X coordinate of the centre (input and output)
+//! @param yCentre The Y coordinate of the centre (input and output)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::fitCentre(const std::vector<int> &edges, int radius, int &xCentre, int &yCentre)
+{
+    int                width = m_imageOrigin->width();
+    std::vector<qreal> pointsX;
+    std::vector<qreal> pointsY;
+    qreal              meanX = 0;
+    qreal              meanY = 0;
+    qreal              sXX   = 0;
+    qreal              sYY   = 0;
+    qreal              sXY   = 0;
+    qreal              sX3   = 0;
+    qreal              sY3   = 0;
+    qreal              sXYY  = 0;
+    qreal              sXXY  = 0;
+    qreal              determinant;
+    qreal              distance;
+    qreal              u;
+    qreal              v;
+
+    for (size_t noEdge = 0; noEdge < edges.size(); noEdge++)
+    {
+        if (isPointingToCentre(edges[noEdge], xCentre, yCentre, distance) &&
+            (qAbs(distance - radius) <= REGIONDETECTION_PEAK_RADIUS))
+        {
+            pointsX.push_back(edges[noEdge] % width);
+            pointsY.push_back(edges[noEdge] / width);
+            meanX += pointsX.back();
+            meanY += pointsY.back();
+        }
+    }
+    if (pointsX.size() < 3)
+        return;
+
+    // Centre relative to the mean point
+    meanX /= pointsX.size();
+    meanY /= pointsY.size();
+    for (size_t noPoint = 0; noPoint < pointsX.size(); noPoint++)
+    {
+        u = pointsX[noPoint] - meanX;
+        v = pointsY[noPoint] - meanY;
+        sXX += u * u;
+        sYY += v * v;
+        sXY += u * v;
+        sX3 += u * u * u;
+        sY3 += v * v * v;
+        sXYY += u * v * v;
+        sXXY += u * u * v;
+    }
+
+    determinant = sXX * sYY - sXY * sXY;
+    if (qAbs(determinant) < 1e-9)
+        return;
+
+    u       = ((sX3 + sXYY) * sYY - (sY3 + sXXY) * sXY) / (2 * determinant);
+    v       = ((sY3 + sXXY) * sXX - (sX3 + sXYY) * sXY) / (2 * determinant);
+    xCentre = qRound(meanX + u);
+    yCentre = qRound(meanY + v);
+}
+
+
+//------------------------------------------------------------------------------
+//! Check if the gradient of an edge pixel points to a centre (or away from
+//! it), up to REGIONDETECTION_CIRCLE_MAX_ANGLE degrees
+//!
+//! @param edge The edge pixel (y * width + x)
+//! @param xCentre The X coordinate of the centre
+//! @param yCentre The Y coordinate of the centre
+//! @param distanceOut The distance from the edge pixel to the centre
+//!
+//! @return true if the gradient points to the centre
+//! @return false otherwise
+//------------------------------------------------------------------------------
+bool CRegionDetection::isPointingToCentre(int edge, int xCentre, int yCentre, qreal &distanceOut)
+{
+    int width = m_imageOrigin->width();
+    int dX    = edge % width - xCentre;
+    int dY    = edge / width - yCentre;
+
+    distanceOut = 0;
+    if ((qAbs(dX) > m_maxRadius + REGIONDETECTION_PEAK_RADIUS) || (qAbs(dY) > m_maxRadius + REGIONDETECTION_PEAK_RADIUS))
+        return false;
+
+    distanceOut = qSqrt(dX * dX + dY * dY);
+
+    return qAbs(dX * m_gradientX[edge] + dY * m_gradientY[edge]) >=
+           qCos(REGIONDETECTION_CIRCLE_MAX_ANGLE * M_PI / 180) * distanceOut * m_gradientMagnitude[edge];
+}
+
+
+//------------------------------------------------------------------------------
+//! Draw the circles found (in red) on the treated image
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::drawCircles(void)
+{
+    int nSteps;
+    int x;
+    int y;
+
+    for (size_t noCircle = 0; noCircle < m_circles.size(); noCircle++)
+    {
+        nSteps = qMax(qCeil(4 * M_PI * m_circles[noCircle].radius), 8);
+        for (int noStep = 0; noStep < nSteps; noStep++)
+        {
+            x = m_circles[noCircle].x + qRound(m_circles[noCircle].radius * qCos(2 * M_PI * noStep / nSteps));
+            y = m_circles[noCircle].y + qRound(m_circles[noCircle].radius * qSin(2 * M_PI * noStep / nSteps));
+            if ((x >= 0) && (x < m_imageTreated->width()) && (y >= 0) && (y < m_imageTreated->height()))
+                m_imageTreated->setPixel(x, y, qRgb(CIMAGEINT_MAX, 0, 0));
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Label the connected components of the binarized image and draw them
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::computeComponent(void)
+{
+    labelComponents();
+    drawComponents();
+}
+
+
+//------------------------------------------------------------------------------
+//! Label the connected components of the binarized image (run-based
+//! union-find). The image is cut in bands of REGIONDETECTION_BAND_HEIGHT rows
+//! labeled in parallel: the runs of each band are extracted and merged with
+//! the overlapping runs of the previous row of the band. The seams between
+//! the bands are then merged, and the runs are resolved in the raster order:
+//! a root being always the first run of its component, the labels are
+//! numbered in the raster order, and the area, the bounding box and the sums
+//! of the coordinates of each run are added to its component on the way.
+//! The result does not depend on the number of threads.
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::labelComponents(void)
+{
+    int                                           width  = m_imageGray->getWidth();
+    int                                           height = m_imageGray->getHeight();
+    int                                           nBands = (height + REGIONDETECTION_BAND_HEIGHT - 1) / REGIONDETECTION_BAND_HEIGHT;
+    int                                           gap    = (m_connectedness == 8) ? 1 : 0;
+    std::vector<std::vector<SRegionDetectionRun>> bandRuns(nBands);
+    std::vector<SRegionDetectionRun>              runs;
+    std::vector<int>                              rowStarts(height + 1, 0);
+    std::vector<int>                              parents;
+    std::vector<int>                              runLabels;
+    SRegionDetectionComponent                     component;
+    int                                           root;
+    int                                           length;
+
+    // Runs of each band
+    CParallel::run(nBands, m_nThreads, [&](int noBand) {
+        SRegionDetectionRun run;
+
+        run.value = 1;
+        for (int y = noBand * REGIONDETECTION_BAND_HEIGHT; y < qMin((noBand + 1) * REGIONDETECTION_BAND_HEIGHT, height); y++)
+        {
+            run.y = y;
+            for (int x = 0; x < width; x++)
+            {
+                if (m_imageGray->get(x, y) == 0)
+                    continue;
+
+                run.x0 = x;
+                while ((x < width) && (m_imageGray->get(x, y) != 0))
+                    x++;
+                run.x1 = x;
+                bandRuns[noBand].push_back(run);
+                rowStarts[y + 1]++;
+            }
+        }
+    });
+
+    for (int y = 0; y < height; y++)
+        rowStarts[y + 1] += rowStarts[y];
+    for (int noBand = 0; noBand < nBands; noBand++)
+        runs.insert(runs.end(), bandRuns[noBand].begin(), bandRuns[noBand].end());
+    parents.resize(runs.size());
+    for (size_t noRun = 0; noRun < runs.size(); noRun++)
+        parents[noRun] = static_cast<int>(noRun);
+
+    // Merge inside the bands (each band only touches its own runs), then on
+    // the seams
+    CParallel::run(nBands, m_nThreads, [&](int noBand) {
+        for (int y = noBand * REGIONDETECTION_BAND_HEIGHT + 1; y < qMin((noBand + 1) * REGIONDETECTION_BAND_HEIGHT, height); y++)
+            mergeRows(runs, rowStarts, y, gap, parents);
+    });
+    for (int noBand = 1; noBand < nBands; noBand++)
+        mergeRows(runs, rowStarts, noBand * REGIONDETECTION_BAND_HEIGHT, gap, parents);
+
+    // Labels and statistics
+    m_components.clear();
+    runLabels.resize(runs.size());
+    for (size_t noRun = 0; noRun < runs.size(); noRun++)
+    {
+        root = findRoot(parents, static_cast<int>(noRun));
+        if (root == static_cast<int>(noRun))
+        {
+            component.area = 0;
+            component.xMin = runs[noRun].x0;
+            component.yMin = runs[noRun].y;
+            component.xMax = runs[noRun].x1 - 1;
+            component.yMax = runs[noRun].y;
+            component.sumX = 0;
+            component.sumY = 0;
+            m_components.push_back(component);
+            runLabels[noRun] = static_cast<int>(m_components.size());
+        }
+        else
+        {
+            runLabels[noRun] = runLabels[root];
+        }
+
+        SRegionDetectionComponent &componentRun = m_components[runLabels[noRun] - 1];
+
+        length = runs[noRun].x1 - runs[noRun].x0;
+        componentRun.area += length;
+        componentRun.xMin = qMin(componentRun.xMin, runs[noRun].x0);
+        componentRun.xMax = qMax(componentRun.xMax, runs[noRun].x1 - 1);
+        componentRun.yMax = runs[noRun].y;
+        componentRun.sumX += static_cast<qint64>(runs[noRun].x0 + runs[noRun].x1 - 1) * length / 2;
+        componentRun.sumY += static_cast<qint64>(runs[noRun].y) * length;
+    }
+    for (size_t noComponent = 0; noComponent < m_components.size(); noComponent++)
+    {
+        m_components[noComponent].centroidX = static_cast<qreal>(m_components[noComponent].sumX) / m_components[noComponent].area;
+        m_components[noComponent].centroidY = static_cast<qreal>(m_components[noComponent].sumY) / m_components[noComponent].area;
+    }
+
+    // Label image
+    m_labels.assign(static_cast<size_t>(width) * height, 0);
+    CParallel::run(height, m_nThreads, [&](int y) {
+        for (int noRun = rowStarts[y]; noRun < rowStarts[y + 1]; noRun++)
+        {
+            for (int x = runs[noRun].x0; x < runs[noRun].x1; x++)
+                m_labels[y * width + x] = runLabels[noRun];
+        }
+    });
+}
+
+
+//------------------------------------------------------------------------------
+//! Merge the runs of a row with the overlapping runs of the same value of the
+//! previous row (or touching by a corner, with a gap of 1). The root of two
+//! merged trees is the first of the two roots, so that a root is the first
+//! run of its component.
+//!
+//! @param runs The runs, in the raster order
+//! @param rowStarts The index of the first run of each row (and the number of
+//!                  runs at the end)
+//! @param y The row (at least 1)
+//! @param gap 1 for the 8-connectedness, 0 for the 4-connectedness
+//! @param parents The parent of each run (input and output)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::mergeRows(const std::vector<SRegionDetectionRun> &runs, const std::vector<int> &rowStarts, int y, int gap, std::vector<int> &parents)
+{
+    int noAbove = rowStarts[y - 1];
+    int noBelow = rowStarts[y];
+    int rootAbove;
+    int rootBelow;
+
+    while ((noAbove < rowStarts[y]) && (noBelow < rowStarts[y + 1]))
+    {
+        if ((runs[noAbove].x0 < runs[noBelow].x1 + gap) && (runs[noBelow].x0 < runs[noAbove].x1 + gap) && (runs[noAbove].value == runs[noBelow].value))
+        {
+            rootAbove = findRoot(parents, noAbove);
+            rootBelow = findRoot(parents, noBelow);
+            if (rootAbove < rootBelow)
+                parents[rootBelow] = rootAbove;
+            else if (rootBelow < rootAbove)
+                parents[rootAbove] = rootBelow;
+        }
+
+        // The run ending first cannot overlap the next runs of the other row
+        if (runs[noAbove].x1 < runs[noBelow].x1)
+            noAbove++;
+        else
+            noBelow++;
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Draw the label image on the treated image: a color per label, and the
+//! bounding boxes of the components in red
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::drawComponents(void)
+{
+    int width = m_imageTreated->width();
+    int label;
+
+    for (int y = 0; y < m_imageTreated->height(); y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            label = m_labels[y * width + x];
+            if (label == 0)
+                m_imageTreated->setPixel(x, y, qRgb(0, 0, 0));
+            else
+                m_imageTreated->setPixel(x, y, qRgb(64 + (label * 97) % 192, 64 + (label * 53) % 192, 64 + (label * 151) % 192));
+        }
+    }
+
+    for (size_t noComponent = 0; noComponent < m_components.size(); noComponent++)
+    {
+        const SRegionDetectionComponent &component = m_components[noComponent];
+
+        for (int x = component.xMin; x <= component.xMax; x++)
+        {
+            m_imageTreated->setPixel(x, component.yMin, qRgb(CIMAGEINT_MAX, 0, 0));
+            m_imageTreated->setPixel(x, component.yMax, qRgb(CIMAGEINT_MAX, 0, 0));
+        }
+        for (int y = component.yMin; y <= component.yMax; y++)
+        {
+            m_imageTreated->setPixel(component.xMin, y, qRgb(CIMAGEINT_MAX, 0, 0));
+            m_imageTreated->setPixel(component.xMax, y, qRgb(CIMAGEINT_MAX, 0, 0));
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Segment the image with a watershed (flooding of Meyer) of its gradient:
+//! the basins grow from markers, the regional minima of the gradient or the
+//! connected components of the binarized image, in the order of the levels
+//! of the gradient. The result is a label image without watershed lines
+//! (every pixel reached from a marker gets its label).
+//!
+//! @param isMarkerBased true to grow the connected components of the
+//!                      binarized image, false to grow the regional minima
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::computeWatershed(bool isMarkerBased)
+{
+    std::vector<uchar> relief;
+
+    computeRelief(relief);
+    if (isMarkerBased)
+        labelComponents();
+    else
+        findMinima(relief);
+    m_components.clear();
+
+    floodWatershed(relief);
+    drawComponents();
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the relief flooded by the watershed on 8 bits: the luminance of
+//! the input image if it is already a gradient image, its Sobel gradient
+//! (saturated) otherwise
+//!
+//! @param reliefOut The relief (y * width + x)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::computeRelief(std::vector<uchar> &reliefOut)
+{
+    int width  = m_imageOrigin->width();
+    int height = m_imageOrigin->height();
+
+    reliefOut.resize(static_cast<size_t>(width) * height);
+    if (m_isGradientImage)
+    {
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                reliefOut[y * width + x] = (299 * qRed(m_imageOrigin->pixel(x, y)) +
+                                            587 * qGreen(m_imageOrigin->pixel(x, y)) +
+                                            114 * qBlue(m_imageOrigin->pixel(x, y))) /
+                                           1000;
+            }
+        }
+    }
+    else
+    {
+        computeGradient();
+        for (size_t noPixel = 0; noPixel < reliefOut.size(); noPixel++)
+            reliefOut[noPixel] = qMin(m_gradientMagnitude[noPixel], REGIONDETECTION_NUMBER_LEVELS - 1);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Label the regional minima of the relief (the plateaus with no lower
+//! neighbor), in the raster order of their first pixel. The other pixels get
+//! the label 0.
+//!
+//! @param relief The relief (y * width + x)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::findMinima(const std::vector<uchar> &relief)
+{
+    int              width      = m_imageOrigin->width();
+    int              height     = m_imageOrigin->height();
+    int              nNeighbors = (m_connectedness == 4) ? 4 : 8;
+    const int        dX[8]      = {-1, 1, 0, 0, -1, 1, -1, 1};
+    const int        dY[8]      = {0, 0, -1, 1, -1, -1, 1, 1};
+    std::vector<int> plateau;
+    std::vector<int> isVisited(relief.size(), 0);
+    int              nMinima    = 0;
+    bool             isMinimum;
+    int              x;
+    int              y;
+    int              neighbor;
+
+    m_labels.assign(relief.size(), 0);
+    for (int start = 0; start < static_cast<int>(relief.size()); start++)
+    {
+        if (isVisited[start])
+            continue;
+
+        // Plateau of the pixel (breadth-first)
+        isMinimum        = true;
+        isVisited[start] = 1;
+        plateau.assign(1, start);
+        for (size_t noPixel = 0; noPixel < plateau.size(); noPixel++)
+        {
+            x = plateau[noPixel] % width;
+            y = plateau[noPixel] / width;
+            for (int noNeighbor = 0; noNeighbor < nNeighbors; noNeighbor++)
+            {
+                if ((x + dX[noNeighbor] < 0) || (x + dX[noNeighbor] >= width) || (y + dY[noNeighbor] < 0) || (y + dY[noNeighbor] >= height))
+                    continue;
+
+                neighbor = (y + dY[noNeighbor]) * width + x + dX[noNeighbor];
+                if (relief[neighbor] < relief[start])
+                {
+                    isMinimum = false;
+                }
+                else if ((relief[neighbor] == relief[start]) && !isVisited[neighbor])
+                {
+                    isVisited[neighbor] = 1;
+                    plateau.push_back(neighbor);
+                }
+            }
+        }
+
+        if (isMinimum)
+        {
+            nMinima++;
+            for (size_t noPixel = 0; noPixel < plateau.size(); noPixel++)
+                m_labels[plateau[noPixel]] = nMinima;
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Flood the relief from the labeled pixels of m_labels with hierarchical
+//! queues (a FIFO per level of the relief): a pixel popped at a level gives
+//! its label to its unlabeled neighbors, queued at their level (or at the
+//! current level if they are lower). Each pixel is queued once, so the
+//! flooding is linear in the size of the image.
+//! The basins are split between the threads (label modulo the number of
+//! threads), each thread having its own queues. The levels are flooded by
+//! synchronous rounds: the threads pop the pixels queued at the current
+//! level and propose their labels to the neighbors, then each neighbor gets
+//! the smallest label proposed. The result is thus the same whatever the
+//! number of threads. The threads are created once for the whole flooding,
+//! the two phases of the rounds being separated by a barrier.
+//!
+//! @param relief The relief (y * width + x)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::floodWatershed(const std::vector<uchar> &relief)
+{
+    int                                        width    = m_imageOrigin->width();
+    int                                        height   = m_imageOrigin->height();
+    int                                        nThreads = qMax(m_nThreads, 1);
+    std::vector<std::vector<std::vector<int>>> queues(nThreads, std::vector<std::vector<int>>(REGIONDETECTION_NUMBER_LEVELS));
+    std::vector<std::vector<size_t>>           heads(nThreads, std::vector<size_t>(REGIONDETECTION_NUMBER_LEVELS, 0));
+    std::vector<std::vector<int>>              proposals(nThreads);
+    std::vector<std::atomic<int>>              claims(relief.size());
+    std::vector<int>                           isPending(nThreads, 0);
+    CParallelBarrier                           barrier(nThreads);
+
+    for (size_t noPixel = 0; noPixel < relief.size(); noPixel++)
+    {
+        claims[noPixel] = 0;
+        if (m_labels[noPixel] != 0)
+            queues[(m_labels[noPixel] - 1) % nThreads][relief[noPixel]].push_back(static_cast<int>(noPixel));
+    }
+
+    // A single task per thread for the whole flooding
+    CParallel::run(nThreads, nThreads, [&](int noThread) {
+        const int         dX[8]      = {-1, 1, 0, 0, -1, 1, -1, 1};
+        const int         dY[8]      = {0, 0, -1, 1, -1, -1, 1, 1};
+        int               nNeighbors = (m_connectedness == 4) ? 4 : 8;
+        std::vector<int> &proposal   = proposals[noThread];
+        bool              isLevelPending;
+        int               end;
+        int               pixel;
+        int               neighbor;
+        int               claim;
+
+        for (int level = 0; level < REGIONDETECTION_NUMBER_LEVELS; level++)
+        {
+            do
+            {
+                // Proposals of the pixels popped (the labels are only read)
+                end = static_cast<int>(queues[noThread][level].size());
+                for (size_t noQueued = heads[noThread][level]; noQueued < static_cast<size_t>(end); noQueued++)
+                {
+                    pixel = queues[noThread][level][noQueued];
+                    for (int noNeighbor = 0; noNeighbor < nNeighbors; noNeighbor++)
+                    {
+                        if ((pixel % width + dX[noNeighbor] < 0) || (pixel % width + dX[noNeighbor] >= width) ||
+                            (pixel / width + dY[noNeighbor] < 0) || (pixel / width + dY[noNeighbor] >= height))
+                            continue;
+
+                        neighbor = pixel + dY[noNeighbor] * width + dX[noNeighbor];
+                        if (m_labels[neighbor] != 0)
+                            continue;
+
+                        // Smallest label proposed
+                        claim = claims[neighbor];
+                        while (((claim == 0) || (m_labels[pixel] < claim)) && !claims[neighbor].compare_exchange_weak(claim, m_labels[pixel]))
+                            ;
+                        proposal.push_back(neighbor);
+                        proposal.push_back(m_labels[pixel]);
+                    }
+                }
+                heads[noThread][level] = end;
+                barrier.wait();
+
+                // Labels given (each label belongs to a single thread)
+                for (size_t noProposal = 0; noProposal < proposal.size(); noProposal += 2)
+                {
+                    neighbor = proposal[noProposal];
+                    if ((claims[neighbor] == proposal[noProposal + 1]) && (m_labels[neighbor] == 0))
+                    {
+                        m_labels[neighbor] = proposal[noProposal + 1];
+                        queues[noThread][qMax(static_cast<int>(relief[neighbor]), level)].push_back(neighbor);
+                    }
+                }
+                proposal.clear();
+                isPending[noThread] = (heads[noThread][level] < queues[noThread][level].size());
+                barrier.wait();
+
+                // Same decision in all the threads (isPending is only written
+                // after the next barrier)
+                isLevelPending = false;
+                for (int noOther = 0; noOther < nThreads; noOther++)
+                    isLevelPending = isLevelPending || isPending[noOther];
+            } while (isLevelPending);
+
+            // Memory of the level released
+            std::vector<int>().swap(queues[noThread][level]);
+        }
+    });
+}
+
+
+//------------------------------------------------------------------------------
+//! Detect the line segments of the image in the manner of LSD (Grompone von
+//! Gioi et al.), in a time linear in the number of pixels:
+//! - the level-line angle of each pixel comes from the shared Sobel gradient
+//!   (undefined under the gradient that the quantization of the levels can
+//!   give at the angle tolerance);
+//! - the pixels are sorted by gradient magnitude with a bucket sort, and each
+//!   unused pixel grows a region of the neighbors aligned with it;
+//! - the region is approximated by a rectangle (inertia of the pixels
+//!   weighted by their gradient);
+//! - the rectangle is kept if it is meaningful a contrario: its number of
+//!   false alarms (tests * probability of so many aligned pixels in noise) is
+//!   below 1, after the refinements of its precision and of its width.
+//! The segments (the axes of the rectangles, clipped by the image) are drawn
+//! in red.
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::computeSegmentLSD(void)
+{
+    int                       width        = m_imageOrigin->width();
+    int                       height       = m_imageOrigin->height();
+    qreal                     minMagnitude = REGIONDETECTION_LSD_QUANTIZATION / qSin(REGIONDETECTION_LSD_ANGLE_TOLERANCE * M_PI / 180);
+    int                       maxMagnitude = 1;
+    std::vector<qreal>        angles(static_cast<size_t>(width) * height);
+    std::vector<uchar>        isUsed(angles.size(), 0);
+    std::vector<int>          binCounts(REGIONDETECTION_LSD_NUMBER_BINS + 1, 0);
+    std::vector<int>          order;
+    std::vector<int>          region;
+    SRegionDetectionRectangle rectangle;
+    SRegionDetectionRectangle rectangleTry;
+    SRegionDetectionSegment   segment;
+    qreal                     logNFA;
+    qreal                     logNFATry;
+    int                       bin;
+
+    computeGradient();
+
+    // Level-line angles (undefined: not aligned with anything and never a
+    // seed)
+    for (size_t noPixel = 0; noPixel < angles.size(); noPixel++)
+    {
+        maxMagnitude = qMax(maxMagnitude, m_gradientMagnitude[noPixel]);
+        if (m_gradientMagnitude[noPixel] <= minMagnitude)
+        {
+            isUsed[noPixel] = 1;
+            angles[noPixel] = std::numeric_limits<qreal>::quiet_NaN();
+        }
+        else
+        {
+            angles[noPixel] = qAtan2(m_gradientX[noPixel], -m_gradientY[noPixel]);
+        }
+    }
+
+    // Decreasing gradient magnitude (bucket sort)
+    order.resize(angles.size());
+    for (size_t noPixel = 0; noPixel < angles.size(); noPixel++)
+        binCounts[REGIONDETECTION_LSD_NUMBER_BINS - m_gradientMagnitude[noPixel] * (REGIONDETECTION_LSD_NUMBER_BINS - 1) / maxMagnitude]++;
+    for (int noBin = 1; noBin <= REGIONDETECTION_LSD_NUMBER_BINS; noBin++)
+        binCounts[noBin] += binCounts[noBin - 1];
+    for (size_t noPixel = 0; noPixel < angles.size(); noPixel++)
+    {
+        bin                     = REGIONDETECTION_LSD_NUMBER_BINS - 1 - m_gradientMagnitude[noPixel] * (REGIONDETECTION_LSD_NUMBER_BINS - 1) / maxMagnitude;
+        order[binCounts[bin]++] = static_cast<int>(noPixel);
+    }
+
+    m_segments.clear();
+    for (size_t noOrder = 0; noOrder < order.size(); noOrder++)
+    {
+        if (isUsed[order[noOrder]])
+            continue;
+
+        growRegion(order[noOrder], angles, isUsed, region);
+        if (region.size() < 2)
+            continue;
+
+        computeRectangle(region, angles, rectangle);
+        computeLogNFA(rectangle, angles, logNFA);
+
+        // Refinements: finer precisions, then thinner rectangles
+        rectangleTry = rectangle;
+        for (int noTry = 0; (noTry < REGIONDETECTION_LSD_NUMBER_REFINEMENTS) && (logNFA <= 0); noTry++)
+        {
+            rectangleTry.precision /= 2;
+            computeLogNFA(rectangleTry, angles, logNFATry);
+            if (logNFATry > logNFA)
+            {
+                logNFA    = logNFATry;
+                rectangle = rectangleTry;
+            }
+        }
+        rectangleTry = rectangle;
+        for (int noTry = 0; (noTry < REGIONDETECTION_LSD_NUMBER_REFINEMENTS) && (logNFA <= 0) && (rectangleTry.width > 1.5); noTry++)
+        {
+            rectangleTry.width -= 0.5;
+            computeLogNFA(rectangleTry, angles, logNFATry);
+            if (logNFATry > logNFA)
+            {
+                logNFA    = logNFATry;
+                rectangle = rectangleTry;
+            }
+        }
+
+        // The ends of the rectangle may be outside the image
+        if ((logNFA > 0) && clipSegment(m_imageGray->getWidth(), m_imageGray->getHeight(), rectangle.x0, rectangle.y0, rectangle.x1, rectangle.y1, segment))
+            m_segments.push_back(segment);
+    }
+
+    CImage2QImage(m_imageGray, m_imageTreated);
+    drawSegments();
+}
+
+
+//------------------------------------------------------------------------------
+//! Grow a region from a seed: the unused 8-neighbors of the region whose
+//! level-line angle is within the angle tolerance of the angle of the region
+//! (the mean of the angles of its pixels) are added, and marked as used
+//!
+//! @param seed The seed (y * width + x)
+//! @param angles The level-line angles (NaN if undefined)
+//! @param isUsed The used pixels (input and output)
+//! @param regionOut The pixels of the region (y * width + x)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::growRegion(int seed, const std::vector<qreal> &angles, std::vector<uchar> &isUsed, std::vector<int> &regionOut)
+{
+    int   width     = m_imageOrigin->width();
+    int   height    = m_imageOrigin->height();
+    qreal tolerance = REGIONDETECTION_LSD_ANGLE_TOLERANCE * M_PI / 180;
+    qreal sumCos    = qCos(angles[seed]);
+    qreal sumSin    = qSin(angles[seed]);
+    qreal angle     = angles[seed];
+    qreal difference;
+    int   x;
+    int   y;
+    int   neighbor;
+
+    regionOut.assign(1, seed);
+    isUsed[seed] = 1;
+    for (size_t noPixel = 0; noPixel < regionOut.size(); noPixel++)
+    {
+        x = regionOut[noPixel] % width;
+        y = regionOut[noPixel] / width;
+        for (int yNeighbor = qMax(y - 1, 0); yNeighbor <= qMin(y + 1, height - 1); yNeighbor++)
+        {
+            for (int xNeighbor = qMax(x - 1, 0); xNeighbor <= qMin(x + 1, width - 1); xNeighbor++)
+            {
+                neighbor = yNeighbor * width + xNeighbor;
+                if (isUsed[neighbor])
+                    continue;
+
+                difference = std::remainder(angles[neighbor] - angle, 2 * M_PI);
+                if (qAbs(difference) > tolerance)
+                    continue;
+
+                isUsed[neighbor] = 1;
+                regionOut.push_back(neighbor);
+                sumCos += qCos(angles[neighbor]);
+                sumSin += qSin(angles[neighbor]);
+                angle = qAtan2(sumSin, sumCos);
+            }
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Approximate a region by a rectangle: the centre is the centroid of the
+//! pixels weighted by their gradient magnitude, the direction is the main
+//! axis of inertia (oriented as the region), and the length and the width
+//! enclose all the pixels
+//!
+//! @param region The pixels of the region (y * width + x)
+//! @param angles The level-line angles
+//! @param rectangleOut The rectangle
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::computeRectangle(const std::vector<int> &region, const std::vector<qreal> &angles, SRegionDetectionRectangle &rectangleOut)
+{
+    int   width        = m_imageOrigin->width();
+    qreal sumWeights   = 0;
+    qreal xCentre      = 0;
+    qreal yCentre      = 0;
+    qreal inertiaXX    = 0;
+    qreal inertiaYY    = 0;
+    qreal inertiaXY    = 0;
+    qreal sumCos       = 0;
+    qreal sumSin       = 0;
+    qreal lengthMin    = 0;
+    qreal lengthMax    = 0;
+    qreal widthMin     = 0;
+    qreal widthMax     = 0;
+    qreal weight;
+    qreal dX;
+    qreal dY;
+    qreal projection;
+
+    for (size_t noPixel = 0; noPixel < region.size(); noPixel++)
+    {
+        weight = m_gradientMagnitude[region[noPixel]];
+        sumWeights += weight;
+        xCentre += weight * (region[noPixel] % width);
+        yCentre += weight * (region[noPixel] / width);
+        sumCos += qCos(angles[region[noPixel]]);
+        sumSin += qSin(angles[region[noPixel]]);
+    }
+    xCentre /= sumWeights;
+    yCentre /= sumWeights;
+
+    for (size_t noPixel = 0; noPixel < region.size(); noPixel++)
+    {
+        weight = m_gradientMagnitude[region[noPixel]];
+        dX     = region[noPixel] % width - xCentre;
+        dY     = region[noPixel] / width - yCentre;
+        inertiaXX += weight * dX * dX;
+        inertiaYY += weight * dY * dY;
+        inertiaXY += weight * dX * dY;
+    }
+
+    // Main axis, in the direction of the level lines of the region
+    rectangleOut.theta = qAtan2(2 * inertiaXY, inertiaXX - inertiaYY) / 2;
+    if (qAbs(std::remainder(rectangleOut.theta - qAtan2(sumSin, sumCos), 2 * M_PI)) > M_PI / 2)
+        rectangleOut.theta += M_PI;
+
+    for (size_t noPixel = 0; noPixel < region.size(); noPixel++)
+    {
+        dX         = region[noPixel] % width - xCentre;
+        dY         = region[noPixel] / width - yCentre;
+        projection = dX * qCos(rectangleOut.theta) + dY * qSin(rectangleOut.theta);
+        lengthMin  = qMin(lengthMin, projection);
+        lengthMax  = qMax(lengthMax, projection);
+        projection = -dX * qSin(rectangleOut.theta) + dY * qCos(rectangleOut.theta);
+        widthMin   = qMin(widthMin, projection);
+        widthMax   = qMax(widthMax, projection);
+    }
+
+    rectangleOut.x0        = xCentre + lengthMin * qCos(rectangleOut.theta);
+    rectangleOut.y0        = yCentre + lengthMin * qSin(rectangleOut.theta);
+    rectangleOut.x1        = xCentre + lengthMax * qCos(rectangleOut.theta);
+    rectangleOut.y1        = yCentre + lengthMax * qSin(rectangleOut.theta);
+    rectangleOut.width     = qMax(widthMax - widthMin, 1.0);
+    rectangleOut.precision = REGIONDETECTION_LSD_ANGLE_TOLERANCE * M_PI / 180;
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the meaningfulness of a rectangle: -log10 of its number of false
+//! alarms, the number of rectangles tested ((width * height)^(5 / 2), times
+//! the refinements) times the probability that at least as many of its
+//! pixels as observed are aligned with it (within the precision) in noise.
+//! A rectangle less dense than REGIONDETECTION_LSD_MIN_DENSITY in aligned
+//! pixels is not meaningful.
+//!
+//! @param rectangle The rectangle
+//! @param angles The level-line angles (NaN if undefined)
+//! @param logNFAOut -log10(NFA): the rectangle is meaningful if it is
+//!                  positive
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::computeLogNFA(const SRegionDetectionRectangle &rectangle, const std::vector<qreal> &angles, qreal &logNFAOut)
+{
+    int   width       = m_imageOrigin->width();
+    int   height      = m_imageOrigin->height();
+    qreal cosTheta    = qCos(rectangle.theta);
+    qreal sinTheta    = qSin(rectangle.theta);
+    qreal length      = qSqrt((rectangle.x1 - rectangle.x0) * (rectangle.x1 - rectangle.x0) + (rectangle.y1 - rectangle.y0) * (rectangle.y1 - rectangle.y0));
+    qreal xCentre     = (rectangle.x0 + rectangle.x1) / 2;
+    qreal yCentre     = (rectangle.y0 + rectangle.y1) / 2;
+    qreal extent      = (length / 2 + 0.5) * qAbs(sinTheta) + rectangle.width / 2 * qAbs(cosTheta) + 1;
+    qreal logNTests   = 2.5 * (std::log10(static_cast<qreal>(width)) + std::log10(static_cast<qreal>(height))) +
+                        std::log10(2.0 * REGIONDETECTION_LSD_NUMBER_REFINEMENTS + 1);
+    int   nPixels     = 0;
+    int   nAligned    = 0;
+    qreal xMin;
+    qreal xMax;
+    qreal dX;
+    qreal dY;
+
+    // Pixels of the rectangle (centres within half the length along its axis
+    // and half the width across), row by row: the row cuts the two slabs of
+    // the rectangle in an interval of x, so only the rectangle is walked
+    for (int y = qMax(qFloor(yCentre - extent), 0); y <= qMin(qCeil(yCentre + extent), height - 1); y++)
+    {
+        dY   = y - yCentre;
+        xMin = 0;
+        xMax = width - 1;
+        clipToSlab(cosTheta, dY * sinTheta, length / 2 + 0.5, xCentre, xMin, xMax);
+        clipToSlab(-sinTheta, dY * cosTheta, rectangle.width / 2, xCentre, xMin, xMax);
+        if (xMin > xMax)
+            continue;
+
+        for (int x = qCeil(xMin); x <= qFloor(xMax); x++)
+        {
+            dX = x - xCentre;
+            dY = y - yCentre;
+            if ((qAbs(dX * cosTheta + dY * sinTheta) > length / 2 + 0.5) ||
+                (qAbs(-dX * sinTheta + dY * cosTheta) > rectangle.width / 2))
+                continue;
+
+            nPixels++;
+            if (!std::isnan(angles[y * width + x]) &&
+                (qAbs(std::remainder(angles[y * width + x] - rectangle.theta, 2 * M_PI)) <= rectangle.precision))
+                nAligned++;
+        }
+    }
+
+    if ((nPixels == 0) || (nAligned < REGIONDETECTION_LSD_MIN_DENSITY * nPixels * rectangle.precision / (REGIONDETECTION_LSD_ANGLE_TOLERANCE * M_PI / 180)))
+        logNFAOut = -std::numeric_limits<qreal>::infinity();
+    else
+        logNFAOut = -logNTests - computeLogBinomialTail(nPixels, nAligned, rectangle.precision / M_PI);
+}
+
+
+//------------------------------------------------------------------------------
+//! Trace the borders of the binarized image in a single raster scan (border
+//! following of Suzuki and Abe): the foreground is 8-connected, the
+//! background 4-connected. An outer border starts at a foreground pixel with
+//! a background pixel on its left, a hole border at a foreground pixel with
+//! a background pixel on its right that is not already on a followed border
+//! of this side. Each border followed marks its pixels with its number, and
+//! the last border met on the row (LNBD) gives the parent of the next one:
+//! - its parent if both are outer borders or both are hole borders;
+//! - itself otherwise.
+//! Only the chain codes are kept, and the borders are drawn in red (outer)
+//! and green (hole).
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::computeContour(void)
+{
+    int                     width       = m_imageGray->getWidth();
+    int                     height      = m_imageGray->getHeight();
+    int                     paddedWidth = width + 2;
+    std::vector<int>        borders(static_cast<size_t>(paddedWidth) * (height + 2), 0);
+    SRegionDetectionContour contour;
+    int                     noBorder    = 1;
+    int                     lastBorder;
+    int                     pixel;
+    int                     direction;
+    bool                    isLastHole;
+
+    // 1 for the foreground, with a background frame
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+            borders[(y + 1) * paddedWidth + x + 1] = (m_imageGray->get(x, y) != 0);
+    }
+
+    // The border 1 is the frame (a hole), the border n > 1 is the contour
+    // n - 2
+    m_contours.clear();
+    for (int y = 1; y <= height; y++)
+    {
+        lastBorder = 1;
+        for (int x = 1; x <= width; x++)
+        {
+            pixel = y * paddedWidth + x;
+            if (borders[pixel] == 0)
+                continue;
+
+            if ((borders[pixel] == 1) && (borders[pixel - 1] == 0))
+            {
+                contour.isHole = false;
+                direction      = 4;
+            }
+            else if ((borders[pixel] >= 1) && (borders[pixel + 1] == 0))
+            {
+                contour.isHole = true;
+                direction      = 0;
+                if (borders[pixel] > 1)
+                    lastBorder = borders[pixel];
+            }
+            else
+            {
+                if (borders[pixel] != 1)
+                    lastBorder = qAbs(borders[pixel]);
+                continue;
+            }
+
+            isLastHole = (lastBorder == 1) || m_contours[lastBorder - 2].isHole;
+            if (contour.isHole == isLastHole)
+                contour.parent = (lastBorder == 1) ? -1 : m_contours[lastBorder - 2].parent;
+            else
+                contour.parent = lastBorder - 2;
+            contour.xStart = x - 1;
+            contour.yStart = y - 1;
+            noBorder++;
+            m_contours.push_back(contour);
+            followBorder(borders, pixel, direction, noBorder, m_contours.back().chainCodes);
+
+            if (borders[pixel] != 1)
+                lastBorder = qAbs(borders[pixel]);
+        }
+    }
+
+    drawContours();
+}
+
+
+//------------------------------------------------------------------------------
+//! Follow a border from its first pixel: the next pixel is the first
+//! foreground neighbor met counterclockwise after the previous pixel. The
+//! pixels of the border are marked with its number, negated for the pixels
+//! with a background pixel on their right that has been examined (the hole
+//! borders starting there have already been followed).
+//!
+//! @param borders The padded image of the borders (input and output)
+//! @param start The first pixel of the border in the padded image
+//! @param direction The chain code of the background neighbor of the first
+//!                  pixel (4 for an outer border, 0 for a hole border)
+//! @param noBorder The number of the border
+//! @param chainCodesOut The chain codes of the border (empty for an isolated
+//!                      pixel)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::followBorder(std::vector<int> &borders, int start, int direction, int noBorder, std::vector<uchar> &chainCodesOut)
+{
+    int paddedWidth = m_imageGray->getWidth() + 2;
+    int moves[8];
+    int last;
+    int current;
+    int next;
+    int directionEnd;
+
+    for (int noMove = 0; noMove < 8; noMove++)
+        moves[noMove] = freemanMoveY[noMove] * paddedWidth + freemanMoveX[noMove];
+
+    // Last pixel of the border: first foreground neighbor clockwise
+    directionEnd = direction;
+    do
+    {
+        direction = (direction + 7) % 8;
+    } while ((borders[start + moves[direction]] == 0) && (direction != directionEnd));
+
+    if (borders[start + moves[direction]] == 0)
+    {
+        borders[start] = -noBorder;
+        return;
+    }
+
+    last    = start + moves[direction];
+    current = start;
+    for (;;)
+    {
+        directionEnd = direction;
+        do
+        {
+            direction = (direction + 1) % 8;
+        } while (borders[current + moves[direction]] == 0);
+
+        // The east neighbor (code 0) has been examined if the search has
+        // gone past it
+        if ((direction != 0) && (direction <= directionEnd))
+            borders[current] = -noBorder;
+        else if (borders[current] == 1)
+            borders[current] = noBorder;
+
+        chainCodesOut.push_back(static_cast<uchar>(direction));
+        next = current + moves[direction];
+        if ((next == start) && (current == last))
+            break;
+
+        current   = next;
+        direction = (direction + 4) % 8;
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Draw the borders found on a black image: the outer borders in red, the
+//! hole borders in green
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::drawContours(void)
+{
+    int x;
+    int y;
+
+    m_imageTreated->fill(qRgb(0, 0, 0));
+    for (size_t noContour = 0; noContour < m_contours.size(); noContour++)
+    {
+        const SRegionDetectionContour &contour = m_contours[noContour];
+        QRgb                           color   = contour.isHole ? qRgb(0, CIMAGEINT_MAX, 0) : qRgb(CIMAGEINT_MAX, 0, 0);
+
+        x = contour.xStart;
+        y = contour.yStart;
+        m_imageTreated->setPixel(x, y, color);
+        for (size_t noCode = 0; noCode < contour.chainCodes.size(); noCode++)
+        {
+            x += freemanMoveX[contour.chainCodes[noCode]];
+            y += freemanMoveY[contour.chainCodes[noCode]];
+            m_imageTreated->setPixel(x, y, color);
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Segment the image in superpixels with SLIC (Achanta et al.): the centres
+//! start on a grid of step S = sqrt(number of pixels / number of
+//! superpixels), moved to the lowest color gradient of their 3x3
+//! neighborhood, then each iteration assigns the pixels to the nearest
+//! centre of their 2S x 2S window and moves the centres to the mean of their
+//! pixels, until the centres move by less than
+//! REGIONDETECTION_SLIC_MIN_DISPLACEMENT pixels on average (the residual
+//! error of SLIC; a few iterations are enough for most images) or for at
+//! most REGIONDETECTION_SLIC_ITERATIONS iterations. The colors are the
+//! integer Y, U and V of CColorModel, a cheap luminance / opponent
+//! chrominance substitute to Lab. The fragments cut
+//! from their superpixel are merged at the end, and the borders of the
+//! superpixels are drawn in red on the image.
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::computeSuperpixel(void)
+{
+    int                                     width  = m_imageOrigin->width();
+    int                                     height = m_imageOrigin->height();
+    int                                     step   = qMax(qRound(qSqrt(static_cast<qreal>(width) * height / m_nSuperpixels)), 1);
+    std::vector<uchar>                      colors(3 * static_cast<size_t>(width) * height);
+    std::vector<int>                        distances(static_cast<size_t>(width) * height);
+    std::vector<SRegionDetectionSuperpixel> centres;
+    std::vector<qint64>                     sums;
+    SRegionDetectionSuperpixel              centre;
+    int                                     gradient;
+    int                                     gradientMin;
+    int                                     differenceX;
+    int                                     differenceY;
+    qreal                                   displacement = std::numeric_limits<qreal>::max();
+
+    CParallel::run(height, m_nThreads, [&](int y) {
+        QRgb rgb;
+
+        for (int x = 0; x < width; x++)
+        {
+            rgb                             = m_imageOrigin->pixel(x, y);
+            colors[3 * (y * width + x)]     = CColorModel::computeY(rgb);
+            colors[3 * (y * width + x) + 1] = CColorModel::computeU(rgb);
+            colors[3 * (y * width + x) + 2] = CColorModel::computeV(rgb);
+        }
+    });
+
+    centre.area = 0;
+    for (int y = step / 2; y < height; y += step)
+    {
+        for (int x = step / 2; x < width; x += step)
+        {
+            centre.x    = x;
+            centre.y    = y;
+            gradientMin = std::numeric_limits<int>::max();
+            for (int yNeighbor = qMax(y - 1, 1); yNeighbor <= qMin(y + 1, height - 2); yNeighbor++)
+            {
+                for (int xNeighbor = qMax(x - 1, 1); xNeighbor <= qMin(x + 1, width - 2); xNeighbor++)
+                {
+                    gradient = 0;
+                    for (int noColor = 0; noColor < 3; noColor++)
+                    {
+                        differenceX = colors[3 * (yNeighbor * width + xNeighbor + 1) + noColor] - colors[3 * (yNeighbor * width + xNeighbor - 1) + noColor];
+                        differenceY = colors[3 * ((yNeighbor + 1) * width + xNeighbor) + noColor] - colors[3 * ((yNeighbor - 1) * width + xNeighbor) + noColor];
+                        gradient += differenceX * differenceX + differenceY * differenceY;
+                    }
+                    if (gradient < gradientMin)
+                    {
+                        gradientMin = gradient;
+                        centre.x    = xNeighbor;
+                        centre.y    = yNeighbor;
+                    }
+                }
+            }
+            centre.colorY = colors[3 * (centre.y * width + centre.x)];
+            centre.colorU = colors[3 * (centre.y * width + centre.x) + 1];
+            centre.colorV = colors[3 * (centre.y * width + centre.x) + 2];
+            centres.push_back(centre);
+        }
+    }
+
+    m_labels.assign(distances.size(), -1);
+    for (int noIteration = 0; (noIteration < REGIONDETECTION_SLIC_ITERATIONS) && (displacement >= REGIONDETECTION_SLIC_MIN_DISPLACEMENT); noIteration++)
+    {
+        assignSuperpixels(colors, step, centres, distances, sums);
+        updateSuperpixels(sums, centres, displacement);
+    }
+
+    m_components.clear();
+    enforceConnectivity(colors, step);
+    drawSuperpixels();
+}
+
+
+//------------------------------------------------------------------------------
+//! Assign each pixel to the nearest centre of its 2S x 2S window, with the
+//! SLIC distance D = dc^2 + (dx^2 + dy^2) * m^2 / S^2 (dc the distance of
+//! the colors, (dx, dy) the distance in the image, m the compactness) in
+//! fixed point: 16 * dc^2 + weights[|dx|] + weights[|dy|], the weights of the
+//! distances in the image being tabulated. The image is cut in bands of
+//! REGIONDETECTION_BAND_HEIGHT rows, each band scanning the windows that
+//! cross it in parallel, then adding its pixels to the sums of their centre
+//! while they are in the cache (each thread has its sums, added at the end).
+//! The ties go to the first centre, so the result does not depend on the
+//! number of threads.
+//!
+//! @param colors The colors of the pixels (Y, U, V)
+//! @param step The step S of the grid of the centres
+//! @param centres The centres
+//! @param distances The distance of each pixel to its centre (work buffer)
+//! @param sumsOut The area, the sums of the coordinates and of the colors of
+//!                the pixels of each centre
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::assignSuperpixels(const std::vector<uchar> &colors, int step, const std::vector<SRegionDetectionSuperpixel> &centres, std::vector<int> &distances, std::vector<qint64> &sumsOut)
+{
+    int                              width  = m_imageOrigin->width();
+    int                              height = m_imageOrigin->height();
+    int                              nBands = (height + REGIONDETECTION_BAND_HEIGHT - 1) / REGIONDETECTION_BAND_HEIGHT;
+    std::vector<int>                 weights(step + 1);
+    std::vector<std::vector<qint64>> sums(qMax(m_nThreads, 1));
+
+    for (int distance = 0; distance <= step; distance++)
+        weights[distance] = qRound(16.0 * distance * distance * m_compactness * m_compactness / (static_cast<qreal>(step) * step));
+
+    CParallel::runWithThreadIndex(nBands, m_nThreads, [&](int noBand, int noThread) {
+        int          yBegin = noBand * REGIONDETECTION_BAND_HEIGHT;
+        int          yEnd   = qMin(yBegin + REGIONDETECTION_BAND_HEIGHT, height);
+        int          xBegin;
+        int          xEnd;
+        int          weightY;
+        int          difference[3];
+        int          distance;
+        const uchar *color;
+        int *        distanceRow;
+        int *        labelRow;
+        qint64 *     sum;
+
+        std::fill(distances.begin() + static_cast<size_t>(yBegin) * width, distances.begin() + static_cast<size_t>(yEnd) * width, std::numeric_limits<int>::max());
+        for (size_t noCentre = 0; noCentre < centres.size(); noCentre++)
+        {
+            const SRegionDetectionSuperpixel &centre = centres[noCentre];
+
+            xBegin = qMax(centre.x - step, 0);
+            xEnd   = qMin(centre.x + step + 1, width);
+            for (int y = qMax(centre.y - step, yBegin); y < qMin(centre.y + step + 1, yEnd); y++)
+            {
+                weightY     = weights[qAbs(y - centre.y)];
+                color       = &colors[3 * (static_cast<size_t>(y) * width + xBegin)];
+                distanceRow = &distances[static_cast<size_t>(y) * width];
+                labelRow    = &m_labels[static_cast<size_t>(y) * width];
+                for (int x = xBegin; x < xEnd; x++, color += 3)
+                {
+                    difference[0] = color[0] - centre.colorY;
+                    difference[1] = color[1] - centre.colorU;
+                    difference[2] = color[2] - centre.colorV;
+                    distance      = 16 * (difference[0] * difference[0] + difference[1] * difference[1] + difference[2] * difference[2]) +
+                               weights[qAbs(x - centre.x)] + weightY;
+                    if (distance < distanceRow[x])
+                    {
+                        distanceRow[x] = distance;
+                        labelRow[x]    = static_cast<int>(noCentre);
+                    }
+                }
+            }
+        }
+
+        // Sums of each centre: area, x, y, Y, U, V
+        if (sums[noThread].empty())
+            sums[noThread].assign(6 * centres.size(), 0);
+        for (int y = yBegin; y < yEnd; y++)
+        {
+            color    = &colors[3 * static_cast<size_t>(y) * width];
+            labelRow = &m_labels[static_cast<size_t>(y) * width];
+            for (int x = 0; x < width; x++, color += 3)
+            {
+                if (labelRow[x] < 0)
+                    continue;
+
+                sum = &sums[noThread][6 * labelRow[x]];
+                sum[0]++;
+                sum[1] += x;
+                sum[2] += y;
+                sum[3] += color[0];
+                sum[4] += color[1];
+                sum[5] += color[2];
+            }
+        }
+    });
+
+    sumsOut.assign(6 * centres.size(), 0);
+    for (size_t noThread = 0; noThread < sums.size(); noThread++)
+    {
+        for (size_t noSum = 0; noSum < sums[noThread].size(); noSum++)
+            sumsOut[noSum] += sums[noThread][noSum];
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Move each centre to the mean position and color of its pixels. A centre
+//! without pixels stays where it is.
+//!
+//! @param sums The area, the sums of the coordinates and of the colors of the
+//!             pixels of each centre
+//! @param centres The centres (input and output)
+//! @param displacementOut The mean displacement of the centres (in pixels)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::updateSuperpixels(const std::vector<qint64> &sums, std::vector<SRegionDetectionSuperpixel> &centres, qreal &displacementOut)
+{
+    qint64 area;
+    int    x;
+    int    y;
+
+    displacementOut = 0;
+
+    for (size_t noCentre = 0; noCentre < centres.size(); noCentre++)
+    {
+        area                   = sums[6 * noCentre];
+        centres[noCentre].area = static_cast<int>(area);
+        if (area == 0)
+            continue;
+
+        x = static_cast<int>((sums[6 * noCentre + 1] + area / 2) / area);
+        y = static_cast<int>((sums[6 * noCentre + 2] + area / 2) / area);
+        displacementOut += qSqrt(static_cast<qreal>((x - centres[noCentre].x) * (x - centres[noCentre].x) + (y - centres[noCentre].y) * (y - centres[noCentre].y)));
+
+        centres[noCentre].x      = x;
+        centres[noCentre].y      = y;
+        centres[noCentre].colorY = static_cast<int>((sums[6 * noCentre + 3] + area / 2) / area);
+        centres[noCentre].colorU = static_cast<int>((sums[6 * noCentre + 4] + area / 2) / area);
+        centres[noCentre].colorV = static_cast<int>((sums[6 * noCentre + 5] + area / 2) / area);
+    }
+
+    if (!centres.empty())
+        displacementOut /= centres.size();
+}
+
+
+//------------------------------------------------------------------------------
+//! Enforce the connectivity of the superpixels: the 4-connected fragments of
+//! the assignment are labeled in the raster order, and a fragment smaller
+//! than S^2 / 4 joins the superpixel of a neighbor of its first pixel already
+//! labeled (the lower one, else the left one, else the upper one, else the
+//! right one). The labels become 1 ... n, and the area, the centroid and the
+//! mean color of each superpixel are computed.
+//! The fragments are labeled as the connected components (runs of the same
+//! superpixel merged by bands of REGIONDETECTION_BAND_HEIGHT rows in
+//! parallel, then on the seams), the roots giving the fragments in the
+//! raster order of their first pixel. Only the choice of the labels runs on
+//! the fragments in sequence, the labels and the sums of the pixels being
+//! computed by bands in parallel.
+//!
+//! @param colors The colors of the pixels (Y, U, V)
+//! @param step The step S of the grid of the centres
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::enforceConnectivity(const std::vector<uchar> &colors, int step)
+{
+    int                                           width   = m_imageOrigin->width();
+    int                                           height  = m_imageOrigin->height();
+    int                                           nBands  = (height + REGIONDETECTION_BAND_HEIGHT - 1) / REGIONDETECTION_BAND_HEIGHT;
+    qint64                                        minArea = qMax(step * step / 4, 1);
+    std::vector<std::vector<SRegionDetectionRun>> bandRuns(nBands);
+    std::vector<SRegionDetectionRun>              runs;
+    std::vector<int>                              rowStarts(height + 1, 0);
+    std::vector<int>                              parents;
+    std::vector<int>                              runFragments;
+    std::vector<int>                              fragmentRuns;
+    std::vector<qint64>                           fragmentAreas;
+    std::vector<int>                              fragmentLabels;
+    std::vector<std::vector<qint64>>              sums(qMax(m_nThreads, 1));
+    std::vector<qint64>                           sumsLabels;
+    int                                           neighbors[4];
+    qint64                                        area;
+    int                                           nLabels = 0;
+    int                                           adjacentLabel;
+    int                                           root;
+    int                                           x;
+    int                                           y;
+
+    // Runs of each band
+    CParallel::run(nBands, m_nThreads, [&](int noBand) {
+        const int *         labelRow;
+        SRegionDetectionRun run;
+
+        for (int yRun = noBand * REGIONDETECTION_BAND_HEIGHT; yRun < qMin((noBand + 1) * REGIONDETECTION_BAND_HEIGHT, height); yRun++)
+        {
+            labelRow = &m_labels[static_cast<size_t>(yRun) * width];
+            run.y    = yRun;
+            for (int xRun = 0; xRun < width;)
+            {
+                run.x0    = xRun;
+                run.value = labelRow[xRun];
+                while ((xRun < width) && (labelRow[xRun] == run.value))
+                    xRun++;
+                run.x1 = xRun;
+                bandRuns[noBand].push_back(run);
+                rowStarts[yRun + 1]++;
+            }
+        }
+    });
+
+    for (y = 0; y < height; y++)
+        rowStarts[y + 1] += rowStarts[y];
+    for (int noBand = 0; noBand < nBands; noBand++)
+        runs.insert(runs.end(), bandRuns[noBand].begin(), bandRuns[noBand].end());
+    parents.resize(runs.size());
+    for (size_t noRun = 0; noRun < runs.size(); noRun++)
+        parents[noRun] = static_cast<int>(noRun);
+
+    // 4-connected fragments, inside the bands then on the seams
+    CParallel::run(nBands, m_nThreads, [&](int noBand) {
+        for (int yRow = noBand * REGIONDETECTION_BAND_HEIGHT + 1; yRow < qMin((noBand + 1) * REGIONDETECTION_BAND_HEIGHT, height); yRow++)
+            mergeRows(runs, rowStarts, yRow, 0, parents);
+    });
+    for (int noBand = 1; noBand < nBands; noBand++)
+        mergeRows(runs, rowStarts, noBand * REGIONDETECTION_BAND_HEIGHT, 0, parents);
+
+    // Fragments in the raster order of their first run (the root)
+    runFragments.resize(runs.size());
+    for (size_t noRun = 0; noRun < runs.size(); noRun++)
+    {
+        root = findRoot(parents, static_cast<int>(noRun));
+        if (root == static_cast<int>(noRun))
+        {
+            runFragments[noRun] = static_cast<int>(fragmentRuns.size());
+            fragmentRuns.push_back(root);
+            fragmentAreas.push_back(0);
+        }
+        else
+        {
+            runFragments[noRun] = runFragments[root];
+        }
+        fragmentAreas[runFragments[noRun]] += runs[noRun].x1 - runs[noRun].x0;
+    }
+
+    // Label of each fragment: the neighbors of its first pixel already
+    // labeled belong to previous fragments (east, north, west, south: the
+    // last one found is kept)
+    fragmentLabels.resize(fragmentRuns.size());
+    for (int noFragment = 0; noFragment < static_cast<int>(fragmentRuns.size()); noFragment++)
+    {
+        x            = runs[fragmentRuns[noFragment]].x0;
+        y            = runs[fragmentRuns[noFragment]].y;
+        neighbors[0] = ((x + 1 < width) && (runs[fragmentRuns[noFragment]].x1 == x + 1)) ? fragmentRuns[noFragment] + 1 : -1;
+        neighbors[1] = (y > 0) ? findRun(runs, rowStarts, x, y - 1) : -1;
+        neighbors[2] = (x > 0) ? fragmentRuns[noFragment] - 1 : -1;
+        neighbors[3] = (y + 1 < height) ? findRun(runs, rowStarts, x, y + 1) : -1;
+
+        adjacentLabel = 0;
+        for (int noNeighbor = 0; noNeighbor < 4; noNeighbor++)
+        {
+            if ((neighbors[noNeighbor] >= 0) && (runFragments[neighbors[noNeighbor]] < noFragment))
+                adjacentLabel = fragmentLabels[runFragments[neighbors[noNeighbor]]];
+        }
+
+        if ((fragmentAreas[noFragment] < minArea) && (adjacentLabel != 0))
+            fragmentLabels[noFragment] = adjacentLabel;
+        else
+            fragmentLabels[noFragment] = ++nLabels;
+    }
+
+    // Labels and statistics (area, x, y, Y, U, V) of each band, each thread
+    // having its sums
+    CParallel::runWithThreadIndex(nBands, m_nThreads, [&](int noBand, int noThread) {
+        int          label;
+        int          length;
+        int *        labelRow;
+        const uchar *color;
+        qint64 *     sum;
+
+        if (sums[noThread].empty())
+            sums[noThread].assign(6 * static_cast<size_t>(nLabels), 0);
+        for (int noRun = rowStarts[noBand * REGIONDETECTION_BAND_HEIGHT]; noRun < rowStarts[qMin((noBand + 1) * REGIONDETECTION_BAND_HEIGHT, height)]; noRun++)
+        {
+            const SRegionDetectionRun &run = runs[noRun];
+
+            label    = fragmentLabels[runFragments[noRun]];
+            length   = run.x1 - run.x0;
+            labelRow = &m_labels[static_cast<size_t>(run.y) * width];
+            color    = &colors[3 * (static_cast<size_t>(run.y) * width + run.x0)];
+            sum      = &sums[noThread][6 * (label - 1)];
+
+            sum[0] += length;
+            sum[1] += static_cast<qint64>(run.x0 + run.x1 - 1) * length / 2;
+            sum[2] += static_cast<qint64>(run.y) * length;
+            for (int xRun = run.x0; xRun < run.x1; xRun++, color += 3)
+            {
+                labelRow[xRun] = label;
+                sum[3] += color[0];
+                sum[4] += color[1];
+                sum[5] += color[2];
+            }
+        }
+    });
+
+    sumsLabels.assign(6 * static_cast<size_t>(nLabels), 0);
+    for (size_t noThread = 0; noThread < sums.size(); noThread++)
+    {
+        for (size_t noSum = 0; noSum < sums[noThread].size(); noSum++)
+            sumsLabels[noSum] += sums[noThread][noSum];
+    }
+
+    m_superpixels.resize(nLabels);
+    for (int noLabel = 0; noLabel < nLabels; noLabel++)
+    {
+        area                          = sumsLabels[6 * noLabel];
+        m_superpixels[noLabel].area   = static_cast<int>(area);
+        m_superpixels[noLabel].x      = static_cast<int>((sumsLabels[6 * noLabel + 1] + area / 2) / area);
+        m_superpixels[noLabel].y      = static_cast<int>((sumsLabels[6 * noLabel + 2] + area / 2) / area);
+        m_superpixels[noLabel].colorY = static_cast<int>((sumsLabels[6 * noLabel + 3] + area / 2) / area);
+        m_superpixels[noLabel].colorU = static_cast<int>((sumsLabels[6 * noLabel + 4] + area / 2) / area);
+        m_superpixels[noLabel].colorV = static_cast<int>((sumsLabels[6 * noLabel + 5] + area / 2) / area);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Draw the borders of the superpixels (the pixels whose right or lower
+//! neighbor is in another superpixel) in red on the image
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRegionDetection::drawSuperpixels(void)
+{
+    int width  = m_imageOrigin->width();
+    int height = m_imageOrigin->height();
+    int label;
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            label = m_labels[y * width + x];
+            if (((x + 1 < width) && (m_labels[y * width + x + 1] != label)) ||
+                ((y + 1 < height) && (m_labels[(y + 1) * width + x] != label)))
+                m_imageTreated->setPixel(x, y, qRgb(CIMAGEINT_MAX, 0, 0));
+            else
+                m_imageTreated->setPixel(x, y, m_imageOrigin->pixel(x, y));
+        }
+    }
 }
 
 
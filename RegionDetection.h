@@ -12,8 +12,155 @@
 // Include(s) :
 
 #include <QImage>
+#include <QPoint>
+#include <QString>
+#include <vector>
 
 #include "../../Commun/Image/cimage.h"
+#include "ColorModel.h"
+#include "Parallel.h"
+
+
+//------------------------------------------------------------------------------
+// Constant(s):
+
+const int REGIONDETECTION_DEFAULT_NUMBER_ANGLES  = 180;
+const int REGIONDETECTION_DEFAULT_NUMBER_LINES   = 5;
+const int REGIONDETECTION_PEAK_RADIUS            = 4;
+const int REGIONDETECTION_TASKS_PER_THREAD       = 4;
+const int REGIONDETECTION_DEFAULT_THRESHOLD      = 50;
+const int REGIONDETECTION_DEFAULT_MIN_LENGTH     = 30;
+const int REGIONDETECTION_DEFAULT_MAX_GAP        = 5;
+const int REGIONDETECTION_DEFAULT_TIME_BUDGET    = 100;
+const int REGIONDETECTION_DEFAULT_CONNECTEDNESS  = 8;
+const int REGIONDETECTION_BAND_HEIGHT            = 64;
+const int REGIONDETECTION_PYRAMID_FACTOR         = 4;
+const int REGIONDETECTION_PYRAMID_ANGLE_FACTOR   = 1;
+const int REGIONDETECTION_PYRAMID_PEAKS_PER_LINE = 4;
+const int REGIONDETECTION_PYRAMID_PEAK_RADIUS    = 2;
+const int REGIONDETECTION_PYRAMID_MIN_WEIGHT     = 2;
+const int REGIONDETECTION_EDGE_THRESHOLD         = 32;
+const int REGIONDETECTION_DEFAULT_MIN_RADIUS     = 5;
+const int REGIONDETECTION_DEFAULT_MAX_RADIUS     = 100;
+const int REGIONDETECTION_DEFAULT_NUMBER_CIRCLES = 5;
+const int REGIONDETECTION_CIRCLE_MAX_ANGLE       = 20;
+const int REGIONDETECTION_CENTRE_RADIUS          = 2;
+const int REGIONDETECTION_CIRCLE_MIN_COVERAGE    = 50;
+const int REGIONDETECTION_NUMBER_LEVELS          = 256;
+const int REGIONDETECTION_LSD_NUMBER_BINS        = 1024;
+const int REGIONDETECTION_LSD_NUMBER_REFINEMENTS = 5;
+const int REGIONDETECTION_CONTOUR_FILE_TAG       = 0x43545231; // "CTR1"
+const int REGIONDETECTION_CONTOUR_CODE_BITS      = 3;
+const int REGIONDETECTION_DEFAULT_SUPERPIXELS    = 2000;
+const int REGIONDETECTION_DEFAULT_COMPACTNESS    = 10;
+const int REGIONDETECTION_SLIC_ITERATIONS        = 10;
+
+const qreal REGIONDETECTION_LSD_ANGLE_TOLERANCE   = 22.5;
+const qreal REGIONDETECTION_LSD_QUANTIZATION      = 2.0;
+const qreal REGIONDETECTION_LSD_MIN_DENSITY       = 0.7;
+const qreal REGIONDETECTION_SLIC_MIN_DISPLACEMENT = 0.5;
+
+
+//------------------------------------------------------------------------------
+// Structure(s):
+
+//! Line x * cos(theta) + y * sin(theta) = rho found by the Hough transform
+struct SRegionDetectionLine
+{
+    int   rho;
+    qreal theta;
+    int   votes;
+};
+
+//! Segment [(x0, y0), (x1, y1)] found by the probabilistic Hough transform
+struct SRegionDetectionSegment
+{
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+};
+
+//! Circle of centre (x, y) found by the gradient Hough transform
+struct SRegionDetectionCircle
+{
+    int x;
+    int y;
+    int radius;
+    int votes;
+};
+
+//! Foreground pixels indexed by rows and by columns: the pixels of the row y
+//! have the abscissas rowX[rowStarts[y] ... rowStarts[y + 1] - 1] (sorted),
+//! and the same for the columns
+struct SRegionDetectionPixelIndex
+{
+    std::vector<int> rowStarts;
+    std::vector<int> rowX;
+    std::vector<int> columnStarts;
+    std::vector<int> columnY;
+};
+
+//! Run [x0, x1[ of the row y of pixels of the same value (1 for the
+//! foreground of the binarized image, the superpixel for SLIC)
+struct SRegionDetectionRun
+{
+    int x0;
+    int x1;
+    int y;
+    int value;
+};
+
+//! Rectangle approximating a region of the line segment detection
+struct SRegionDetectionRectangle
+{
+    qreal x0;
+    qreal y0;
+    qreal x1;
+    qreal y1;
+    qreal width;
+    qreal theta;
+    qreal precision;
+};
+
+//! Border found by the contour tracing, from its first pixel in the raster
+//! order: Freeman chain codes (0 east, 1 north-east, ..., 7 south-east) of
+//! the moves to its next pixels, back to the first one. The parent is the
+//! index of the border surrounding it, -1 for the frame of the image.
+struct SRegionDetectionContour
+{
+    int                xStart;
+    int                yStart;
+    bool               isHole;
+    int                parent;
+    std::vector<uchar> chainCodes;
+};
+
+//! Superpixel found by SLIC: its area, its centroid and its mean color (Y, U
+//! and V as computed by CColorModel)
+struct SRegionDetectionSuperpixel
+{
+    int area;
+    int x;
+    int y;
+    int colorY;
+    int colorU;
+    int colorV;
+};
+
+//! Connected component found by the labeling, with its statistics
+struct SRegionDetectionComponent
+{
+    int    area;
+    int    xMin;
+    int    yMin;
+    int    xMax;
+    int    yMax;
+    qint64 sumX;
+    qint64 sumY;
+    qreal  centroidX;
+    qreal  centroidY;
+};
 
 
 //------------------------------------------------------------------------------
@@ -22,7 +169,15 @@
 enum DETECTION_REGION_TYPE
 {
     DETECTION_REGION_UNKNOWN,
-    DETECTION_REGION_LINE
+    DETECTION_REGION_LINE,
+    DETECTION_REGION_SEGMENT,
+    DETECTION_REGION_CIRCLE,
+    DETECTION_REGION_COMPONENT,
+    DETECTION_REGION_WATERSHED_MINIMA,
+    DETECTION_REGION_WATERSHED_MARKERS,
+    DETECTION_REGION_SEGMENT_LSD,
+    DETECTION_REGION_CONTOUR,
+    DETECTION_REGION_SUPERPIXEL
 };
 
 
@@ -36,16 +191,126 @@ public:
     ~CRegionDetection(void);
 
     QImage *getImageTreated(void);
+    int     getNumberAngles(void);
+    int     getNumberLines(void);
+    void    setHough(int nAngles, int nLines);
+    int     getNumberThreads(void);
+    void    setNumberThreads(int nThreads);
+    bool    isMultiresolution(void);
+    void    setMultiresolution(bool isMultiresolution);
+    int     getTimeBudget(void);
+    void    setTimeBudget(int timeBudget);
+    void    setSegmentParameters(int threshold, int minLength, int maxGap);
+    int     getMinRadius(void);
+    int     getMaxRadius(void);
+    int     getNumberCircles(void);
+    void    setCircleParameters(int minRadius, int maxRadius, int nCircles);
+    int     getConnectedness(void);
+    void    setConnectedness(int connectedness);
+    bool    isGradientImage(void);
+    void    setGradientImage(bool isGradientImage);
+    int     getNumberSuperpixels(void);
+    int     getCompactness(void);
+    void    setSuperpixelParameters(int nSuperpixels, int compactness);
+    void    getContourVertices(int noContour, std::vector<QPoint> &verticesOut);
+    bool    saveContours(const QString &filename);
     void    computeDetectionRegion(DETECTION_REGION_TYPE detectionRegionType);
+    void    computeLines(void);
+
+    const std::vector<SRegionDetectionLine> &      getLines(void);
+    const std::vector<SRegionDetectionSegment> &   getSegments(void);
+    const std::vector<SRegionDetectionCircle> &    getCircles(void);
+    const std::vector<int> &                       getLabels(void);
+    const std::vector<SRegionDetectionComponent> & getComponents(void);
+    const std::vector<SRegionDetectionContour> &   getContours(void);
+    const std::vector<SRegionDetectionSuperpixel> &getSuperpixels(void);
 
 private:
     QImage *   m_imageOrigin;
     QImage *   m_imageTreated;
     CImageInt *m_imageGray;
     bool       m_isValid;
+    int        m_nAngles;
+    int        m_nLines;
+    int        m_maxRho;
+    int        m_nThreads;
+    bool       m_isMultiresolution;
+    int        m_threshold;
+    int        m_minLength;
+    int        m_maxGap;
+    int        m_timeBudget;
+    int        m_minRadius;
+    int        m_maxRadius;
+    int        m_nCircles;
+    int        m_connectedness;
+    bool       m_isGradientImage;
+    int        m_nSuperpixels;
+    int        m_compactness;
+
+    std::vector<qreal>                m_cosTable;
+    std::vector<qreal>                m_sinTable;
+    SRegionDetectionPixelIndex        m_pixelIndex;
+    std::vector<int>                  m_accumulator;
+    std::vector<SRegionDetectionLine> m_lines;
+
+    std::vector<SRegionDetectionSegment> m_segments;
+    std::vector<uchar>                   m_pixelStates;
+
+    std::vector<int>                    m_gradientX;
+    std::vector<int>                    m_gradientY;
+    std::vector<int>                    m_gradientMagnitude;
+    std::vector<SRegionDetectionCircle> m_circles;
+
+    std::vector<int>                       m_labels;
+    std::vector<SRegionDetectionComponent> m_components;
+
+    std::vector<SRegionDetectionContour> m_contours;
+
+    std::vector<SRegionDetectionSuperpixel> m_superpixels;
 
     void createImageGray(QImage *imageIn, CImageInt *imageOut);
+    void initTables(void);
     void computeLine(void);
+    void indexForeground(void);
+    void computeHoughAccumulator(void);
+    void computeLineMultiresolution(void);
+    void findBandPixels(const SRegionDetectionPixelIndex &pixelIndex, qreal cosTheta, qreal sinTheta, qreal rho, qreal band, std::vector<QPoint> &pixelsOut);
+    void findPeaks(const std::vector<int> &accumulator, int nAngles, int maxRho, int radius, int nPeaks, std::vector<SRegionDetectionLine> &peaksOut);
+    bool isPeak(const std::vector<int> &accumulator, int nAngles, int maxRho, int radius, int noAngle, int rho);
+    void drawLines(void);
+    void computeSegment(void);
+    void voteSegmentPixel(int x, int y, int vote);
+    void drawSegments(void);
+    void computeGradient(void);
+    void findEdges(std::vector<int> &edgesOut);
+    void computeCircle(void);
+    void smoothCentres(void);
+    void findCentres(int nCentres, std::vector<int> &centresOut);
+    bool computeRadius(const std::vector<int> &edges, int centre, SRegionDetectionCircle &circleOut);
+    int  findRadius(const std::vector<int> &edges, int xCentre, int yCentre, int halfWidth, int &supportOut);
+    void fitCentre(const std::vector<int> &edges, int radius, int &xCentre, int &yCentre);
+    bool isPointingToCentre(int edge, int xCentre, int yCentre, qreal &distanceOut);
+    void drawCircles(void);
+    void computeComponent(void);
+    void labelComponents(void);
+    void mergeRows(const std::vector<SRegionDetectionRun> &runs, const std::vector<int> &rowStarts, int y, int gap, std::vector<int> &parents);
+    void drawComponents(void);
+    void computeWatershed(bool isMarkerBased);
+    void computeRelief(std::vector<uchar> &reliefOut);
+    void findMinima(const std::vector<uchar> &relief);
+    void floodWatershed(const std::vector<uchar> &relief);
+    void computeSegmentLSD(void);
+    void growRegion(int seed, const std::vector<qreal> &angles, std::vector<uchar> &isUsed, std::vector<int> &regionOut);
+    void computeRectangle(const std::vector<int> &region, const std::vector<qreal> &angles, SRegionDetectionRectangle &rectangleOut);
+    void computeLogNFA(const SRegionDetectionRectangle &rectangle, const std::vector<qreal> &angles, qreal &logNFAOut);
+    void computeContour(void);
+    void followBorder(std::vector<int> &borders, int start, int direction, int noBorder, std::vector<uchar> &chainCodesOut);
+    void drawContours(void);
+    void computeSuperpixel(void);
+    void assignSuperpixels(const std::vector<uchar> &colors, int step, const std::vector<SRegionDetectionSuperpixel> &centres, std::vector<int> &distances, std::vector<qint64> &sumsOut);
+    void updateSuperpixels(const std::vector<qint64> &sums, std::vector<SRegionDetectionSuperpixel> &centres, qreal &displacementOut);
+    void enforceConnectivity(const std::vector<uchar> &colors, int step);
+    void drawSuperpixels(void);
     void CImage2QImage(CImageInt *imageIn, QImage *imageOut);
 };
 
@@ -0,0 +1,518 @@
+//------------------------------------------------------------------------------
+//! @file RunLengthImage.cpp
+//! @brief Definition file of the CRunLengthImage class
+//! @author Fabrice Cochet
+//! @version 1.0
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Include(s) :
+
+#include <algorithm>
+
+#include "RunLengthImage.h"
+
+
+//------------------------------------------------------------------------------
+// Local Function(s):
+
+//------------------------------------------------------------------------------
+//! Compute the union or the intersection of two sorted lists of runs
+//!
+//! @param runs1 The first list
+//! @param nRuns1 The number of runs of the first list
+//! @param runs2 The second list
+//! @param nRuns2 The number of runs of the second list
+//! @param isUnion true for the union, false for the intersection
+//! @param runsOut The output list (must not be one of the input lists)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+static void mergeRuns(const SRunLengthRun *runs1, int nRuns1, const SRunLengthRun *runs2, int nRuns2, bool isUnion, std::vector<SRunLengthRun> &runsOut)
+{
+    SRunLengthRun run;
+    int           i = 0;
+    int           j = 0;
+
+    runsOut.clear();
+    if (isUnion)
+    {
+        while ((i < nRuns1) || (j < nRuns2))
+        {
+            if ((j == nRuns2) || ((i < nRuns1) && (runs1[i].x0 < runs2[j].x0)))
+                run = runs1[i++];
+            else
+                run = runs2[j++];
+
+            if (!runsOut.empty() && (run.x0 <= runsOut.back().x1))
+                runsOut.back().x1 = qMax(runsOut.back().x1, run.x1);
+            else
+                runsOut.push_back(run);
+        }
+    }
+    else
+    {
+        while ((i < nRuns1) && (j < nRuns2))
+        {
+            run.x0 = qMax(runs1[i].x0, runs2[j].x0);
+            run.x1 = qMin(runs1[i].x1, runs2[j].x1);
+            if (run.x0 < run.x1)
+                runsOut.push_back(run);
+
+            if (runs1[i].x1 < runs2[j].x1)
+                i++;
+            else
+                j++;
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+// Public Method(s):
+
+//------------------------------------------------------------------------------
+//! CRunLengthImage constructor for a given size (all the pixels are set to 0)
+//!
+//! @param width The image width
+//! @param height The image height
+//!
+//! @return The created object
+//------------------------------------------------------------------------------
+CRunLengthImage::CRunLengthImage(int width, int height)
+{
+    m_width  = qMax(width, 0);
+    m_height = qMax(height, 0);
+
+    m_rowStarts.assign(m_height + 1, 0);
+}
+
+
+//------------------------------------------------------------------------------
+//! CRunLengthImage constructor for a given image (a pixel is set if its value
+//! is not 0)
+//!
+//! @param imageIn The input image
+//!
+//! @return The created object
+//------------------------------------------------------------------------------
+CRunLengthImage::CRunLengthImage(CImageInt *imageIn)
+    : CRunLengthImage(imageIn ? imageIn->getWidth() : 0, imageIn ? imageIn->getHeight() : 0)
+{
+    SRunLengthRun run;
+
+    for (int y = 0; y < m_height; y++)
+    {
+        for (int x = 0; x < m_width; x++)
+        {
+            if (imageIn->get(x, y) != 0)
+            {
+                run.x0 = x;
+                while ((x < m_width) && (imageIn->get(x, y) != 0))
+                    x++;
+                run.x1 = x;
+                m_runs.push_back(run);
+            }
+        }
+        m_rowStarts[y + 1] = static_cast<int>(m_runs.size());
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Destructor
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+CRunLengthImage::~CRunLengthImage(void)
+{
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the image width
+//!
+//! @param _
+//!
+//! @return The width
+//------------------------------------------------------------------------------
+int CRunLengthImage::getWidth(void)
+{
+    return m_width;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the image height
+//!
+//! @param _
+//!
+//! @return The height
+//------------------------------------------------------------------------------
+int CRunLengthImage::getHeight(void)
+{
+    return m_height;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the number of runs of the image
+//!
+//! @param _
+//!
+//! @return The number of runs
+//------------------------------------------------------------------------------
+int CRunLengthImage::getNumberRuns(void)
+{
+    return static_cast<int>(m_runs.size());
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the number of runs of a row
+//!
+//! @param y The row
+//!
+//! @return The number of runs
+//------------------------------------------------------------------------------
+int CRunLengthImage::getNumberRuns(int y)
+{
+    return m_rowStarts[y + 1] - m_rowStarts[y];
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the runs of a row
+//!
+//! @param y The row
+//!
+//! @return The first run of the row (see getNumberRuns)
+//------------------------------------------------------------------------------
+const SRunLengthRun *CRunLengthImage::getRow(int y)
+{
+    return m_runs.data() + m_rowStarts[y];
+}
+
+
+//------------------------------------------------------------------------------
+//! Get a pixel (binary search in the runs of the row)
+//!
+//! @param x The X coordinate
+//! @param y The Y coordinate
+//!
+//! @return true if the pixel is set
+//! @return false otherwise (or outside the image)
+//------------------------------------------------------------------------------
+bool CRunLengthImage::get(int x, int y)
+{
+    const SRunLengthRun *first;
+    const SRunLengthRun *last;
+    const SRunLengthRun *run;
+
+    if ((x < 0) || (x >= m_width) || (y < 0) || (y >= m_height))
+        return false;
+
+    first = getRow(y);
+    last  = first + getNumberRuns(y);
+    run   = std::upper_bound(first, last, x, [](int value, const SRunLengthRun &run) {
+        return value < run.x0;
+    });
+
+    return (run != first) && (x < (run - 1)->x1);
+}
+
+
+//------------------------------------------------------------------------------
+//! Decode the image into a CImageInt (0 or CIMAGEINT_MAX)
+//!
+//! @param imageOut The output image
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRunLengthImage::toCImage(CImageInt *imageOut)
+{
+    const SRunLengthRun *row;
+    int                  x;
+
+    if (imageOut)
+    {
+        for (int y = 0; y < qMin(m_height, imageOut->getHeight()); y++)
+        {
+            row = getRow(y);
+            x   = 0;
+            for (int noRun = 0; noRun <= getNumberRuns(y); noRun++)
+            {
+                for (; x < qMin((noRun < getNumberRuns(y)) ? row[noRun].x0 : m_width, imageOut->getWidth()); x++)
+                    (*imageOut)(x, y) = 0;
+                if (noRun < getNumberRuns(y))
+                {
+                    for (; x < qMin(row[noRun].x1, imageOut->getWidth()); x++)
+                        (*imageOut)(x, y) = CIMAGEINT_MAX;
+                }
+            }
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Dilate the image by a rectangle (a horizontal line if radiusY = 0, a
+//! vertical line if radiusX = 0), as a horizontal then a vertical dilation
+//!
+//! @param radiusX The horizontal radius of the rectangle
+//! @param radiusY The vertical radius of the rectangle
+//! @param imageOut The output image (can be this image)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRunLengthImage::dilate(int radiusX, int radiusY, CRunLengthImage *imageOut)
+{
+    if (imageOut)
+    {
+        minMaxX(radiusX, true, imageOut);
+        imageOut->minMaxY(radiusY, true, imageOut);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Erode the image by a rectangle (a horizontal line if radiusY = 0, a
+//! vertical line if radiusX = 0), as a horizontal then a vertical erosion
+//!
+//! @param radiusX The horizontal radius of the rectangle
+//! @param radiusY The vertical radius of the rectangle
+//! @param imageOut The output image (can be this image)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRunLengthImage::erode(int radiusX, int radiusY, CRunLengthImage *imageOut)
+{
+    if (imageOut)
+    {
+        minMaxX(radiusX, false, imageOut);
+        imageOut->minMaxY(radiusY, false, imageOut);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the intersection of the image with another image of the same size
+//!
+//! @param imageIn The other image
+//! @param imageOut The output image (can be one of the input images)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRunLengthImage::intersect(CRunLengthImage *imageIn, CRunLengthImage *imageOut)
+{
+    std::vector<SRunLengthRun> runs;
+    std::vector<SRunLengthRun> rowRuns;
+    std::vector<int>           rowStarts(m_height + 1, 0);
+
+    if (imageIn && imageOut && (imageIn->m_width == m_width) && (imageIn->m_height == m_height))
+    {
+        for (int y = 0; y < m_height; y++)
+        {
+            mergeRuns(getRow(y), getNumberRuns(y), imageIn->getRow(y), imageIn->getNumberRuns(y), false, rowRuns);
+            runs.insert(runs.end(), rowRuns.begin(), rowRuns.end());
+            rowStarts[y + 1] = static_cast<int>(runs.size());
+        }
+
+        imageOut->m_width  = m_width;
+        imageOut->m_height = m_height;
+        imageOut->m_runs.swap(runs);
+        imageOut->m_rowStarts.swap(rowStarts);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Compute the complement of the image (the gaps between the runs)
+//!
+//! @param imageOut The output image (can be this image)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRunLengthImage::complement(CRunLengthImage *imageOut)
+{
+    std::vector<SRunLengthRun> runs;
+    std::vector<int>           rowStarts(m_height + 1, 0);
+    const SRunLengthRun *      row;
+    SRunLengthRun              gap;
+
+    if (imageOut)
+    {
+        for (int y = 0; y < m_height; y++)
+        {
+            row    = getRow(y);
+            gap.x0 = 0;
+            for (int noRun = 0; noRun < getNumberRuns(y); noRun++)
+            {
+                gap.x1 = row[noRun].x0;
+                if (gap.x0 < gap.x1)
+                    runs.push_back(gap);
+                gap.x0 = row[noRun].x1;
+            }
+            gap.x1 = m_width;
+            if (gap.x0 < gap.x1)
+                runs.push_back(gap);
+            rowStarts[y + 1] = static_cast<int>(runs.size());
+        }
+
+        imageOut->m_width  = m_width;
+        imageOut->m_height = m_height;
+        imageOut->m_runs.swap(runs);
+        imageOut->m_rowStarts.swap(rowStarts);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+// Private Method(s):
+
+//------------------------------------------------------------------------------
+//! Dilate or erode the image by a horizontal line: each run is extended or
+//! shrunk by the radius (the runs touching the border of the image are not
+//! shrunk on this side, the outside pixels being ignored)
+//!
+//! @param radius The radius of the line
+//! @param isDilation true for the dilation, false for the erosion
+//! @param imageOut The output image (can be this image)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRunLengthImage::minMaxX(int radius, bool isDilation, CRunLengthImage *imageOut)
+{
+    std::vector<SRunLengthRun> runs;
+    std::vector<int>           rowStarts(m_height + 1, 0);
+    const SRunLengthRun *      row;
+    SRunLengthRun              run;
+
+    runs.reserve(m_runs.size());
+    for (int y = 0; y < m_height; y++)
+    {
+        row = getRow(y);
+        for (int noRun = 0; noRun < getNumberRuns(y); noRun++)
+        {
+            if (isDilation)
+            {
+                run.x0 = qMax(row[noRun].x0 - radius, 0);
+                run.x1 = qMin(row[noRun].x1 + radius, m_width);
+                if ((runs.size() > static_cast<size_t>(rowStarts[y])) && (run.x0 <= runs.back().x1))
+                    runs.back().x1 = run.x1;
+                else
+                    runs.push_back(run);
+            }
+            else
+            {
+                run.x0 = (row[noRun].x0 == 0) ? 0 : row[noRun].x0 + radius;
+                run.x1 = (row[noRun].x1 == m_width) ? m_width : row[noRun].x1 - radius;
+                if (run.x0 < run.x1)
+                    runs.push_back(run);
+            }
+        }
+        rowStarts[y + 1] = static_cast<int>(runs.size());
+    }
+
+    imageOut->m_width  = m_width;
+    imageOut->m_height = m_height;
+    imageOut->m_runs.swap(runs);
+    imageOut->m_rowStarts.swap(rowStarts);
+}
+
+
+//------------------------------------------------------------------------------
+//! Dilate or erode the image by a vertical line: the union (intersection) of
+//! the 2 * radius + 1 rows of the window is built by doubling, the union
+//! (intersection) of p rows giving the one of 2p rows in a single merge, so
+//! that only log(radius) merges of each row are needed. The rows outside the
+//! image are neutral (empty for the dilation, full for the erosion).
+//!
+//! @param radius The radius of the line
+//! @param isDilation true for the dilation, false for the erosion
+//! @param imageOut The output image (can be this image)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CRunLengthImage::minMaxY(int radius, bool isDilation, CRunLengthImage *imageOut)
+{
+    int                                     nRows        = m_height + 2 * radius;
+    int                                     length       = 2 * radius + 1;
+    int                                     lengthPower  = 1;
+    int                                     lengthResult = 0;
+    std::vector<std::vector<SRunLengthRun>> power(nRows);
+    std::vector<std::vector<SRunLengthRun>> result;
+    std::vector<SRunLengthRun>              neutralRow;
+    std::vector<SRunLengthRun>              rowRuns;
+    std::vector<SRunLengthRun>              runs;
+    std::vector<int>                        rowStarts(m_height + 1, 0);
+
+    if (radius <= 0)
+    {
+        if (imageOut != this)
+            *imageOut = *this;
+        return;
+    }
+
+    if (!isDilation && (m_width > 0))
+        neutralRow.push_back(SRunLengthRun{0, m_width});
+
+    // Row k of the window image: row k - radius of the image
+    for (int k = 0; k < nRows; k++)
+    {
+        if ((k >= radius) && (k < radius + m_height))
+            power[k].assign(getRow(k - radius), getRow(k - radius) + getNumberRuns(k - radius));
+        else
+            power[k] = neutralRow;
+    }
+
+    // result[k] combines the rows k ... k + lengthResult - 1, power[k] the rows
+    // k ... k + lengthPower - 1
+    while (length > 0)
+    {
+        if (length & 1)
+        {
+            if (lengthResult == 0)
+            {
+                result = power;
+            }
+            else
+            {
+                for (int k = 0; k < m_height; k++)
+                {
+                    const std::vector<SRunLengthRun> &next = (k + lengthResult < nRows) ? power[k + lengthResult] : neutralRow;
+
+                    mergeRuns(result[k].data(), static_cast<int>(result[k].size()), next.data(), static_cast<int>(next.size()), isDilation, rowRuns);
+                    result[k].swap(rowRuns);
+                }
+            }
+            lengthResult += lengthPower;
+        }
+
+        length >>= 1;
+        if (length > 0)
+        {
+            for (int k = 0; k < nRows; k++)
+            {
+                const std::vector<SRunLengthRun> &next = (k + lengthPower < nRows) ? power[k + lengthPower] : neutralRow;
+
+                mergeRuns(power[k].data(), static_cast<int>(power[k].size()), next.data(), static_cast<int>(next.size()), isDilation, rowRuns);
+                power[k].swap(rowRuns);
+            }
+            lengthPower *= 2;
+        }
+    }
+
+    for (int y = 0; y < m_height; y++)
+    {
+        runs.insert(runs.end(), result[y].begin(), result[y].end());
+        rowStarts[y + 1] = static_cast<int>(runs.size());
+    }
+
+    imageOut->m_width  = m_width;
+    imageOut->m_height = m_height;
+    imageOut->m_runs.swap(runs);
+    imageOut->m_rowStarts.swap(rowStarts);
+}
@@ -0,0 +1,67 @@
+//------------------------------------------------------------------------------
+//! @file RunLengthImage.h
+//! @brief Header file of the CRunLengthImage class
+//! @author Fabrice Cochet
+//! @version 1.0
+//------------------------------------------------------------------------------
+
+#ifndef RUN_LENGTH_IMAGE_HEADER
+#define RUN_LENGTH_IMAGE_HEADER
+
+//------------------------------------------------------------------------------
+// Include(s) :
+
+#include <QtGlobal>
+#include <vector>
+
+#include "../../Commun/Image/cimage.h"
+
+
+//------------------------------------------------------------------------------
+// Structure(s):
+
+//! Run of set pixels [x0, x1[ of a row
+struct SRunLengthRun
+{
+    int x0;
+    int x1;
+};
+
+
+//------------------------------------------------------------------------------
+// Classe(s) :
+
+//! Binary image encoded as runs of set pixels: the runs of each row are sorted
+//! and disjoint (never adjacent). The memory and the cost of the operations
+//! only depend on the number of runs. As in COpMorphoMaths, the pixels outside
+//! the image are ignored by the erosion and the dilation.
+class CRunLengthImage
+{
+public:
+    CRunLengthImage(int width, int height);
+    CRunLengthImage(CImageInt *imageIn);
+    ~CRunLengthImage(void);
+
+    int                  getWidth(void);
+    int                  getHeight(void);
+    int                  getNumberRuns(void);
+    int                  getNumberRuns(int y);
+    const SRunLengthRun *getRow(int y);
+    bool                 get(int x, int y);
+    void                 toCImage(CImageInt *imageOut);
+    void                 dilate(int radiusX, int radiusY, CRunLengthImage *imageOut);
+    void                 erode(int radiusX, int radiusY, CRunLengthImage *imageOut);
+    void                 intersect(CRunLengthImage *imageIn, CRunLengthImage *imageOut);
+    void                 complement(CRunLengthImage *imageOut);
+
+private:
+    int                        m_width;
+    int                        m_height;
+    std::vector<SRunLengthRun> m_runs;
+    std::vector<int>           m_rowStarts;
+
+    void minMaxX(int radius, bool isDilation, CRunLengthImage *imageOut);
+    void minMaxY(int radius, bool isDilation, CRunLengthImage *imageOut);
+};
+
+#endif // RUN_LENGTH_IMAGE_HEADER
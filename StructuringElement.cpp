@@ -0,0 +1,237 @@
+//------------------------------------------------------------------------------
+//! @file StructuringElement.cpp
+//! @brief Definition file of the CStructuringElement class
+//! @author Fabrice Cochet
+//! @version 1.0
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Include(s) :
+
+#include <algorithm>
+
+#include "StructuringElement.h"
+
+
+//------------------------------------------------------------------------------
+// Public Method(s):
+
+//------------------------------------------------------------------------------
+//! Constructor (empty structuring element)
+//!
+//! @param _
+//!
+//! @return The created object
+//------------------------------------------------------------------------------
+CStructuringElement::CStructuringElement(void)
+{
+    m_radiusX = 0;
+    m_radiusY = 0;
+    m_mask    = 0;
+}
+
+
+//------------------------------------------------------------------------------
+//! Destructor
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+CStructuringElement::~CStructuringElement(void)
+{
+}
+
+
+//------------------------------------------------------------------------------
+//! Compile a neighborhood image into stacks of runs (a pixel is active if its
+//! value is not 0, the centre of the structuring element is the centre of the
+//! image)
+//!
+//! @param neighborhood The neighborhood image (odd width and height)
+//!
+//! @return true if OK
+//! @return false otherwise (the structuring element is then empty)
+//------------------------------------------------------------------------------
+bool CStructuringElement::compile(CImageInt *neighborhood)
+{
+    SStructuringElementRun run;
+    bool                   isStacked;
+    bool                   ret = false;
+
+    clear();
+
+    if (neighborhood && (neighborhood->getWidth() % 2 == 1) && (neighborhood->getHeight() % 2 == 1))
+    {
+        ret       = true;
+        m_radiusX = neighborhood->getWidth() / 2;
+        m_radiusY = neighborhood->getHeight() / 2;
+
+        for (int y = 0; y < neighborhood->getHeight(); y++)
+        {
+            run.length = 0;
+            for (int x = 0; x <= neighborhood->getWidth(); x++)
+            {
+                if ((x < neighborhood->getWidth()) && (neighborhood->get(x, y) != 0))
+                {
+                    if (run.length == 0)
+                    {
+                        run.y      = y - m_radiusY;
+                        run.x0     = x - m_radiusX;
+                        run.height = 1;
+                    }
+                    run.length++;
+                }
+                else if (run.length > 0)
+                {
+                    // Stack the run on the identical run of the previous row
+                    isStacked = false;
+                    for (size_t i = 0; (i < m_runs.size()) && !isStacked; i++)
+                    {
+                        if ((m_runs[i].x0 == run.x0) && (m_runs[i].length == run.length) && (m_runs[i].y + m_runs[i].height == run.y))
+                        {
+                            m_runs[i].height++;
+                            isStacked = true;
+                        }
+                    }
+                    if (!isStacked)
+                        m_runs.push_back(run);
+                    run.length = 0;
+                }
+            }
+        }
+
+        std::stable_sort(m_runs.begin(), m_runs.end(), [](const SStructuringElementRun &run1, const SStructuringElementRun &run2) {
+            return run1.length < run2.length;
+        });
+        for (size_t i = 0; i < m_runs.size(); i++)
+        {
+            if (m_runLengths.empty() || (m_runLengths.back() != m_runs[i].length))
+                m_runLengths.push_back(m_runs[i].length);
+        }
+
+        if ((m_radiusX == m_radiusY) && (m_radiusX <= STRUCTURINGELEMENT_MASK_MAX_RADIUS))
+        {
+            for (int y = 0; y < neighborhood->getHeight(); y++)
+            {
+                for (int x = 0; x < neighborhood->getWidth(); x++)
+                {
+                    if (neighborhood->get(x, y) != 0)
+                        m_mask |= 1u << (y * neighborhood->getWidth() + x);
+                }
+            }
+        }
+    }
+
+    return ret;
+}
+
+
+//------------------------------------------------------------------------------
+//! Empty the structuring element
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CStructuringElement::clear(void)
+{
+    m_radiusX = 0;
+    m_radiusY = 0;
+    m_mask    = 0;
+    m_runs.clear();
+    m_runLengths.clear();
+}
+
+
+//------------------------------------------------------------------------------
+//! Check if the structuring element has no active pixel
+//!
+//! @param _
+//!
+//! @return true if empty
+//! @return false otherwise
+//------------------------------------------------------------------------------
+bool CStructuringElement::isEmpty(void)
+{
+    return m_runs.empty();
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the half width of the structuring element
+//!
+//! @param _
+//!
+//! @return The radius along X
+//------------------------------------------------------------------------------
+int CStructuringElement::getRadiusX(void)
+{
+    return m_radiusX;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the half height of the structuring element
+//!
+//! @param _
+//!
+//! @return The radius along Y
+//------------------------------------------------------------------------------
+int CStructuringElement::getRadiusY(void)
+{
+    return m_radiusY;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the number of stacks of runs
+//!
+//! @param _
+//!
+//! @return The number of stacks
+//------------------------------------------------------------------------------
+int CStructuringElement::getNumberRuns(void)
+{
+    return static_cast<int>(m_runs.size());
+}
+
+
+//------------------------------------------------------------------------------
+//! Get a stack of runs (the stacks are sorted by increasing length)
+//!
+//! @param noRun The stack number
+//!
+//! @return The stack
+//------------------------------------------------------------------------------
+const SStructuringElementRun &CStructuringElement::getRun(int noRun)
+{
+    return m_runs[noRun];
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the distinct run lengths (sorted by increasing length)
+//!
+//! @param _
+//!
+//! @return The run lengths
+//------------------------------------------------------------------------------
+const std::vector<int> &CStructuringElement::getRunLengths(void)
+{
+    return m_runLengths;
+}
+
+
+//------------------------------------------------------------------------------
+//! Get the bitmask of the active pixels (bit y * size + x) of a square
+//! structuring element of radius STRUCTURINGELEMENT_MASK_MAX_RADIUS at most
+//!
+//! @param _
+//!
+//! @return The bitmask (0 for a larger or a non square structuring element)
+//------------------------------------------------------------------------------
+unsigned int CStructuringElement::getMask(void)
+{
+    return m_mask;
+}
@@ -0,0 +1,71 @@
+//------------------------------------------------------------------------------
+//! @file StructuringElement.h
+//! @brief Header file of the CStructuringElement class
+//! @author Fabrice Cochet
+//! @version 1.0
+//------------------------------------------------------------------------------
+
+#ifndef STRUCTURING_ELEMENT_HEADER
+#define STRUCTURING_ELEMENT_HEADER
+
+//------------------------------------------------------------------------------
+// Include(s) :
+
+#include <vector>
+
+#include "../../Commun/Image/cimage.h"
+
+
+//------------------------------------------------------------------------------
+// Constant(s) :
+
+const int STRUCTURINGELEMENT_MASK_MAX_RADIUS = 2;
+
+
+//------------------------------------------------------------------------------
+// Structure(s):
+
+//! Stack of identical horizontal runs of active pixels: offsets
+//! [x0, x0 + length[ on the rows [y, y + height[, relative to the centre of
+//! the structuring element
+struct SStructuringElementRun
+{
+    int y;
+    int x0;
+    int length;
+    int height;
+};
+
+
+//------------------------------------------------------------------------------
+// Classe(s) :
+
+//! Structuring element compiled as a list of horizontal runs, the identical
+//! runs of consecutive rows being stacked (a square is a single stack of
+//! 2d + 1 runs). The runs are sorted by length so that the running min/max of
+//! a given length is computed once and shared by all the runs of this length.
+class CStructuringElement
+{
+public:
+    CStructuringElement(void);
+    ~CStructuringElement(void);
+
+    bool                          compile(CImageInt *neighborhood);
+    void                          clear(void);
+    bool                          isEmpty(void);
+    int                           getRadiusX(void);
+    int                           getRadiusY(void);
+    int                           getNumberRuns(void);
+    const SStructuringElementRun &getRun(int noRun);
+    const std::vector<int> &      getRunLengths(void);
+    unsigned int                  getMask(void);
+
+private:
+    int                                 m_radiusX;
+    int                                 m_radiusY;
+    unsigned int                        m_mask;
+    std::vector<SStructuringElementRun> m_runs;
+    std::vector<int>                    m_runLengths;
+};
+
+#endif // STRUCTURING_ELEMENT_HEADER
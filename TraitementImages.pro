@@ -5,6 +5,7 @@
 #-------------------------------------------------
 
 QT       += core gui widgets
+CONFIG   += c++11 thread
 
 TARGET = TraitementImages
 TEMPLATE = app
@@ -19,7 +20,14 @@ SOURCES += main.cpp\
     TreatedImageWindow.cpp \
     ../../Commun/Image/cimage.tpp \
     OpMorphoMaths.cpp \
-    RegionDetection.cpp
+    RegionDetection.cpp \
+    BinaryImage.cpp \
+    HitOrMiss.cpp \
+    Parallel.cpp \
+    StructuringElement.cpp \
+    MaxTree.cpp \
+    RunLengthImage.cpp \
+    Benchmark.cpp
 
 HEADERS  += MainWindow.h \
     ColorModel.h \
@@ -30,7 +38,14 @@ HEADERS  += MainWindow.h \
     TreatedImageWindow.h \
     ../../Commun/Image/cimage.h \
     OpMorphoMaths.h \
-    RegionDetection.h
+    RegionDetection.h \
+    BinaryImage.h \
+    HitOrMiss.h \
+    Parallel.h \
+    StructuringElement.h \
+    MaxTree.h \
+    RunLengthImage.h \
+    Benchmark.h
 
 LIBS += -L../../Commun/Maths/build/
 LIBS += -lqrealfourier
@@ -8,6 +8,7 @@
 //------------------------------------------------------------------------------
 // Include(s) :
 
+#include <QFileDialog>
 #include <QMessageBox>
 
 #include "TreatedImageWindow.h"
@@ -83,10 +84,31 @@ CTreatedImageWindow::CTreatedImageWindow(int type, QImage *imageIn, QWidget *par
                 case PROCESSING_OP_MORPHO_MATHS_HIT_OR_MISS:
                 case PROCESSING_OP_MORPHO_MATHS_THINNING:
                 case PROCESSING_OP_MORPHO_MATHS_SKELETONIZING:
+                case PROCESSING_OP_MORPHO_MATHS_OPENING_BY_RECONSTRUCTION:
+                case PROCESSING_OP_MORPHO_MATHS_HOLE_FILLING:
+                case PROCESSING_OP_MORPHO_MATHS_REGIONAL_MAXIMA:
+                case PROCESSING_OP_MORPHO_MATHS_AREA_OPENING:
+                case PROCESSING_OP_MORPHO_MATHS_AREA_CLOSING:
+                case PROCESSING_OP_MORPHO_MATHS_ATTRIBUTE_OPENING:
+                case PROCESSING_OP_MORPHO_MATHS_ATTRIBUTE_CLOSING:
+                case PROCESSING_OP_MORPHO_MATHS_GRANULOMETRY:
+                case PROCESSING_OP_MORPHO_MATHS_TOP_HAT:
+                case PROCESSING_OP_MORPHO_MATHS_BOTTOM_HAT:
+                case PROCESSING_OP_MORPHO_MATHS_LINE_OPENING:
+                case PROCESSING_OP_MORPHO_MATHS_LINE_OPENING_BANK:
+                case PROCESSING_OP_MORPHO_MATHS_RANK_FILTER:
                     ret = initOpMorphoMaths();
                     break;
 
                 case PROCESSING_REGION_DETECTION_LINE:
+                case PROCESSING_REGION_DETECTION_SEGMENT:
+                case PROCESSING_REGION_DETECTION_CIRCLE:
+                case PROCESSING_REGION_DETECTION_COMPONENT:
+                case PROCESSING_REGION_DETECTION_WATERSHED_MINIMA:
+                case PROCESSING_REGION_DETECTION_WATERSHED_MARKERS:
+                case PROCESSING_REGION_DETECTION_SEGMENT_LSD:
+                case PROCESSING_REGION_DETECTION_CONTOUR:
+                case PROCESSING_REGION_DETECTION_SUPERPIXEL:
                     ret = initRegionDetection();
                     break;
 
@@ -236,10 +258,94 @@ void CTreatedImageWindow::display(void)
             displayOpMorphoMathsSkeletonizing();
             break;
 
+        case PROCESSING_OP_MORPHO_MATHS_OPENING_BY_RECONSTRUCTION:
+            displayOpMorphoMathsOpeningByReconstruction();
+            break;
+
+        case PROCESSING_OP_MORPHO_MATHS_HOLE_FILLING:
+            displayOpMorphoMathsHoleFilling();
+            break;
+
+        case PROCESSING_OP_MORPHO_MATHS_REGIONAL_MAXIMA:
+            displayOpMorphoMathsRegionalMaxima();
+            break;
+
+        case PROCESSING_OP_MORPHO_MATHS_AREA_OPENING:
+            displayOpMorphoMathsAreaOpening();
+            break;
+
+        case PROCESSING_OP_MORPHO_MATHS_AREA_CLOSING:
+            displayOpMorphoMathsAreaClosing();
+            break;
+
+        case PROCESSING_OP_MORPHO_MATHS_ATTRIBUTE_OPENING:
+            displayOpMorphoMathsAttributeOpening();
+            break;
+
+        case PROCESSING_OP_MORPHO_MATHS_ATTRIBUTE_CLOSING:
+            displayOpMorphoMathsAttributeClosing();
+            break;
+
+        case PROCESSING_OP_MORPHO_MATHS_GRANULOMETRY:
+            displayOpMorphoMathsGranulometry();
+            break;
+
+        case PROCESSING_OP_MORPHO_MATHS_TOP_HAT:
+            displayOpMorphoMathsTopHat();
+            break;
+
+        case PROCESSING_OP_MORPHO_MATHS_BOTTOM_HAT:
+            displayOpMorphoMathsBottomHat();
+            break;
+
+        case PROCESSING_OP_MORPHO_MATHS_LINE_OPENING:
+            displayOpMorphoMathsLineOpening();
+            break;
+
+        case PROCESSING_OP_MORPHO_MATHS_LINE_OPENING_BANK:
+            displayOpMorphoMathsLineOpeningBank();
+            break;
+
+        case PROCESSING_OP_MORPHO_MATHS_RANK_FILTER:
+            displayOpMorphoMathsRankFilter();
+            break;
+
         case PROCESSING_REGION_DETECTION_LINE:
             displayRegionDetectionLine();
             break;
 
+        case PROCESSING_REGION_DETECTION_SEGMENT:
+            displayRegionDetectionSegment();
+            break;
+
+        case PROCESSING_REGION_DETECTION_CIRCLE:
+            displayRegionDetectionCircle();
+            break;
+
+        case PROCESSING_REGION_DETECTION_COMPONENT:
+            displayRegionDetectionComponent();
+            break;
+
+        case PROCESSING_REGION_DETECTION_WATERSHED_MINIMA:
+            displayRegionDetectionWatershedMinima();
+            break;
+
+        case PROCESSING_REGION_DETECTION_WATERSHED_MARKERS:
+            displayRegionDetectionWatershedMarkers();
+            break;
+
+        case PROCESSING_REGION_DETECTION_SEGMENT_LSD:
+            displayRegionDetectionSegmentLSD();
+            break;
+
+        case PROCESSING_REGION_DETECTION_CONTOUR:
+            displayRegionDetectionContour();
+            break;
+
+        case PROCESSING_REGION_DETECTION_SUPERPIXEL:
+            displayRegionDetectionSuperpixel();
+            break;
+
         default:
             break;
     }
@@ -820,231 +926,647 @@ void CTreatedImageWindow::displayOpMorphoMathsSkeletonizing(void)
 
 
 //------------------------------------------------------------------------------
-//! Display the image after a line detection inside
+//! Display the image after an opening by reconstruction
 //!
 //! @param _
 //!
 //! @return _
 //------------------------------------------------------------------------------
-void CTreatedImageWindow::displayRegionDetectionLine(void)
+void CTreatedImageWindow::displayOpMorphoMathsOpeningByReconstruction(void)
 {
-    if (m_processingType == PROCESSING_REGION_DETECTION_LINE)
+    if (m_processingType == PROCESSING_OP_MORPHO_MATHS_OPENING_BY_RECONSTRUCTION)
     {
-        m_regionDetection->computeDetectionRegion(DETECTION_REGION_LINE);
+        m_opMorphoMaths->computeOpMorphoMaths(OPMORPHOMATHS_OPENING_BY_RECONSTRUCTION, m_opMorphoMathsDimension);
 
-        m_labelImage->setPixmap(QPixmap::fromImage(*m_regionDetection->getImageTreated()));
-        setWindowTitle(tr("Line detection"));
+        m_labelImage->setPixmap(QPixmap::fromImage(*m_opMorphoMaths->getImageTreated()));
+        setWindowTitle(tr("Opening by reconstruction"));
     }
 }
 
-//------------------------------------------------------------------------------
-// Private Method(s):
 
 //------------------------------------------------------------------------------
-//! Initialization of the "Color Model" treatment
+//! Display the image after a hole filling
 //!
 //! @param _
 //!
 //! @return _
 //------------------------------------------------------------------------------
-bool CTreatedImageWindow::initColorModel(void)
+void CTreatedImageWindow::displayOpMorphoMathsHoleFilling(void)
 {
-    bool ret = false;
-
-    m_vboxLayout = new QVBoxLayout;
-    m_labelImage = new QLabel(this);
-    m_colorModel = new CColorModel(m_imageOrigin);
-
-    if (m_vboxLayout && m_labelImage && m_colorModel)
+    if (m_processingType == PROCESSING_OP_MORPHO_MATHS_HOLE_FILLING)
     {
-        ret = true;
+        m_opMorphoMaths->computeOpMorphoMaths(OPMORPHOMATHS_HOLE_FILLING, m_opMorphoMathsDimension);
 
-        m_vboxLayout->addWidget(m_labelImage);
-        setLayout(m_vboxLayout);
-        show();
+        m_labelImage->setPixmap(QPixmap::fromImage(*m_opMorphoMaths->getImageTreated()));
+        setWindowTitle(tr("Hole filling"));
     }
-
-    return ret;
 }
 
 
 //------------------------------------------------------------------------------
-//! Initialization of the "Quantisation" treatment
+//! Display the regional maxima of the image
 //!
 //! @param _
 //!
 //! @return _
 //------------------------------------------------------------------------------
-bool CTreatedImageWindow::initQuantisation(void)
+void CTreatedImageWindow::displayOpMorphoMathsRegionalMaxima(void)
 {
-    bool ret = false;
-
-    m_vboxLayout        = new QVBoxLayout;
-    m_hboxLayout        = new QHBoxLayout;
-    m_labelImage        = new QLabel(this);
-    m_levelText         = new QLineEdit(tr("Quantisation level:"));
-    m_levelChoice       = new QSpinBox();
-    m_quantisation      = new CQuantisation(m_imageOrigin);
-    m_quantisationLevel = 1;
-
-    if (m_vboxLayout && m_hboxLayout && m_labelImage && m_levelText && m_levelChoice && m_quantisation)
+    if (m_processingType == PROCESSING_OP_MORPHO_MATHS_REGIONAL_MAXIMA)
     {
-        ret = true;
+        m_opMorphoMaths->computeOpMorphoMaths(OPMORPHOMATHS_REGIONAL_MAXIMA, m_opMorphoMathsDimension);
 
-        m_levelText->setReadOnly(true);
-        m_levelChoice->setRange(1, 8);
-        m_levelChoice->setValue(m_quantisationLevel);
+        m_labelImage->setPixmap(QPixmap::fromImage(*m_opMorphoMaths->getImageTreated()));
+        setWindowTitle(tr("Regional maxima"));
+    }
+}
 
-        connect(m_levelChoice, SIGNAL(valueChanged(int)), this, SLOT(updateQuantisationLevel(int)));
 
-        m_hboxLayout->addWidget(m_levelText);
-        m_hboxLayout->addWidget(m_levelChoice);
-        m_vboxLayout->addLayout(m_hboxLayout);
-        m_vboxLayout->addWidget(m_labelImage);
-        setLayout(m_vboxLayout);
-        show();
-    }
+//------------------------------------------------------------------------------
+//! Display the area opening of the image
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::displayOpMorphoMathsAreaOpening(void)
+{
+    if (m_processingType == PROCESSING_OP_MORPHO_MATHS_AREA_OPENING)
+    {
+        m_opMorphoMaths->setArea(m_opMorphoMathsArea);
+        m_opMorphoMaths->computeOpMorphoMaths(OPMORPHOMATHS_AREA_OPENING, m_opMorphoMathsDimension);
 
-    return ret;
+        m_labelImage->setPixmap(QPixmap::fromImage(*m_opMorphoMaths->getImageTreated()));
+        setWindowTitle(tr("Area opening"));
+    }
 }
 
 
 //------------------------------------------------------------------------------
-//! Initialization of the "Sampling" treatment
+//! Display the area closing of the image
 //!
 //! @param _
 //!
 //! @return _
 //------------------------------------------------------------------------------
-bool CTreatedImageWindow::initSampling(void)
+void CTreatedImageWindow::displayOpMorphoMathsAreaClosing(void)
 {
-    bool ret = false;
+    if (m_processingType == PROCESSING_OP_MORPHO_MATHS_AREA_CLOSING)
+    {
+        m_opMorphoMaths->setArea(m_opMorphoMathsArea);
+        m_opMorphoMaths->computeOpMorphoMaths(OPMORPHOMATHS_AREA_CLOSING, m_opMorphoMathsDimension);
 
-    m_vboxLayout = new QVBoxLayout;
-    m_labelImage = new QLabel(this);
-    m_sampling   = new CSampling(m_imageOrigin);
+        m_labelImage->setPixmap(QPixmap::fromImage(*m_opMorphoMaths->getImageTreated()));
+        setWindowTitle(tr("Area closing"));
+    }
+}
 
-    if (m_vboxLayout && m_labelImage && m_sampling)
+
+//------------------------------------------------------------------------------
+//! Display the attribute opening of the image
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::displayOpMorphoMathsAttributeOpening(void)
+{
+    if (m_processingType == PROCESSING_OP_MORPHO_MATHS_ATTRIBUTE_OPENING)
     {
-        ret = true;
+        m_opMorphoMaths->setAttribute(m_opMorphoMathsAttribute, m_opMorphoMathsAttributeThreshold);
+        m_opMorphoMaths->computeOpMorphoMaths(OPMORPHOMATHS_ATTRIBUTE_OPENING, m_opMorphoMathsDimension);
 
-        m_vboxLayout->addWidget(m_labelImage);
-        setLayout(m_vboxLayout);
-        show();
+        m_labelImage->setPixmap(QPixmap::fromImage(*m_opMorphoMaths->getImageTreated()));
+        setWindowTitle(tr("Attribute opening"));
     }
-
-    return ret;
 }
 
 
 //------------------------------------------------------------------------------
-//! Initialization of the "Geometric Transformation" treatment
+//! Display the attribute closing of the image
 //!
 //! @param _
 //!
 //! @return _
 //------------------------------------------------------------------------------
-bool CTreatedImageWindow::initGeometricTransformation(void)
+void CTreatedImageWindow::displayOpMorphoMathsAttributeClosing(void)
 {
-    bool ret = false;
+    if (m_processingType == PROCESSING_OP_MORPHO_MATHS_ATTRIBUTE_CLOSING)
+    {
+        m_opMorphoMaths->setAttribute(m_opMorphoMathsAttribute, m_opMorphoMathsAttributeThreshold);
+        m_opMorphoMaths->computeOpMorphoMaths(OPMORPHOMATHS_ATTRIBUTE_CLOSING, m_opMorphoMathsDimension);
 
-    m_hboxLayout              = new QHBoxLayout;
-    m_vboxLayout              = new QVBoxLayout;
-    m_gridLayout              = new QGridLayout;
-    m_labelImage              = new QLabel(this);
-    m_parameterLabel1         = new QLabel(this);
-    m_parameterLabel2         = new QLabel(this);
-    m_parameterValue1         = new QSpinBox();
-    m_parameterValue2         = new QSpinBox();
-    m_geometricTransformation = new CGeometricTransformation(m_imageOrigin);
+        m_labelImage->setPixmap(QPixmap::fromImage(*m_opMorphoMaths->getImageTreated()));
+        setWindowTitle(tr("Attribute closing"));
+    }
+}
 
-    if (m_hboxLayout &&
-        m_vboxLayout &&
-        m_gridLayout &&
-        m_labelImage &&
-        m_parameterLabel1 &&
-        m_parameterLabel2 &&
-        m_parameterValue1 &&
-        m_parameterValue2 &&
-        m_geometricTransformation)
-    {
-        ret = true;
 
-        switch (m_processingType)
-        {
-            case PROCESSING_GEOMETRIC_TRANSFORMATION_ROTATION:
-                m_nParameters   = 1;
-                m_rotationAngle = 0;
+//------------------------------------------------------------------------------
+//! Display the pattern spectrum of the image
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::displayOpMorphoMathsGranulometry(void)
+{
+    if (m_processingType == PROCESSING_OP_MORPHO_MATHS_GRANULOMETRY)
+    {
+        m_opMorphoMaths->computeOpMorphoMaths(OPMORPHOMATHS_GRANULOMETRY, m_opMorphoMathsDimension);
 
-                m_parameterLabel1->setText(tr("Rotation angle:"));
-                m_parameterValue1->setRange(0, 360);
-                m_parameterValue1->setValue(m_rotationAngle);
+        m_labelImage->setPixmap(QPixmap::fromImage(*m_opMorphoMaths->getImageTreated()));
+        setWindowTitle(tr("Granulometry"));
+    }
+}
 
-                connect(m_parameterValue1, SIGNAL(valueChanged(int)), this, SLOT(updateAngleRotation(int)));
-                break;
 
-            case PROCESSING_GEOMETRIC_TRANSFORMATION_SCALE:
-                m_nParameters = 1;
-                m_scaleFactor = 100;
-                m_parameterLabel1->setText(tr("Scale factor:"));
-                m_parameterValue1->setRange(1, 200);
-                m_parameterValue1->setValue(m_scaleFactor);
+//------------------------------------------------------------------------------
+//! Display the white top-hat of the image
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::displayOpMorphoMathsTopHat(void)
+{
+    if (m_processingType == PROCESSING_OP_MORPHO_MATHS_TOP_HAT)
+    {
+        m_opMorphoMaths->computeOpMorphoMaths(OPMORPHOMATHS_TOP_HAT, m_opMorphoMathsDimension);
 
-                connect(m_parameterValue1, SIGNAL(valueChanged(int)), this, SLOT(updateScaleFactor(int)));
-                break;
+        m_labelImage->setPixmap(QPixmap::fromImage(*m_opMorphoMaths->getImageTreated()));
+        setWindowTitle(tr("Top-hat"));
+    }
+}
 
-            case PROCESSING_GEOMETRIC_TRANSFORMATION_SHEAR:
-                m_nParameters  = 2;
-                m_shearFactorX = 0;
-                m_shearFactorY = 0;
 
-                m_parameterLabel1->setText(tr("Shearing factor by X:"));
-                m_parameterLabel2->setText(tr("Shearing factor by Y:"));
-                m_parameterValue1->setRange(0, 100);
-                m_parameterValue2->setRange(0, 100);
-                m_parameterValue1->setValue(m_shearFactorX);
-                m_parameterValue2->setValue(m_shearFactorY);
+//------------------------------------------------------------------------------
+//! Display the black top-hat of the image
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::displayOpMorphoMathsBottomHat(void)
+{
+    if (m_processingType == PROCESSING_OP_MORPHO_MATHS_BOTTOM_HAT)
+    {
+        m_opMorphoMaths->computeOpMorphoMaths(OPMORPHOMATHS_BOTTOM_HAT, m_opMorphoMathsDimension);
 
-                connect(m_parameterValue1, SIGNAL(valueChanged(int)), this, SLOT(updateShearFactorX(int)));
-                connect(m_parameterValue2, SIGNAL(valueChanged(int)), this, SLOT(updateShearFactorY(int)));
-                break;
+        m_labelImage->setPixmap(QPixmap::fromImage(*m_opMorphoMaths->getImageTreated()));
+        setWindowTitle(tr("Bottom-hat"));
+    }
+}
 
-            default:
-                m_nParameters = 0;
-                break;
-        }
 
-        if (m_nParameters >= 1)
-        {
-            m_hboxLayout->addWidget(m_parameterLabel1);
-            m_hboxLayout->addWidget(m_parameterValue1);
-        }
-        if (m_nParameters >= 2)
-        {
-            m_hboxLayout->addWidget(m_parameterLabel2);
-            m_hboxLayout->addWidget(m_parameterValue2);
-        }
-        m_vboxLayout->addLayout(m_hboxLayout);
-        m_vboxLayout->addWidget(m_labelImage);
-        this->setLayout(m_vboxLayout);
+//------------------------------------------------------------------------------
+//! Display the opening of the image by an oriented line
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::displayOpMorphoMathsLineOpening(void)
+{
+    if (m_processingType == PROCESSING_OP_MORPHO_MATHS_LINE_OPENING)
+    {
+        m_opMorphoMaths->setLine(m_opMorphoMathsLineAngle, m_opMorphoMathsNumberOrientations);
+        m_opMorphoMaths->computeOpMorphoMaths(OPMORPHOMATHS_LINE_OPENING, m_opMorphoMathsDimension);
 
-        show();
+        m_labelImage->setPixmap(QPixmap::fromImage(*m_opMorphoMaths->getImageTreated()));
+        setWindowTitle(tr("Line opening"));
     }
-
-    return ret;
 }
 
 
 //------------------------------------------------------------------------------
-//! Initialization of the "Edge Detection" treatment
+//! Display the supremum of the openings of the image by lines of several
+//! orientations
 //!
 //! @param _
 //!
 //! @return _
 //------------------------------------------------------------------------------
-bool CTreatedImageWindow::initEdgeDetection(void)
+void CTreatedImageWindow::displayOpMorphoMathsLineOpeningBank(void)
 {
-    bool ret = false;
+    if (m_processingType == PROCESSING_OP_MORPHO_MATHS_LINE_OPENING_BANK)
+    {
+        m_opMorphoMaths->setLine(m_opMorphoMathsLineAngle, m_opMorphoMathsNumberOrientations);
+        m_opMorphoMaths->computeOpMorphoMaths(OPMORPHOMATHS_LINE_OPENING_BANK, m_opMorphoMathsDimension);
+
+        m_labelImage->setPixmap(QPixmap::fromImage(*m_opMorphoMaths->getImageTreated()));
+        setWindowTitle(tr("Line openings (all orientations)"));
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the image after a rank filter (median by default)
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::displayOpMorphoMathsRankFilter(void)
+{
+    if (m_processingType == PROCESSING_OP_MORPHO_MATHS_RANK_FILTER)
+    {
+        m_opMorphoMaths->setPercentile(m_opMorphoMathsPercentile);
+        m_opMorphoMaths->computeOpMorphoMaths(OPMORPHOMATHS_RANK_FILTER, m_opMorphoMathsDimension);
+
+        m_labelImage->setPixmap(QPixmap::fromImage(*m_opMorphoMaths->getImageTreated()));
+        setWindowTitle(tr("Rank filter"));
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the image after a line detection inside
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::displayRegionDetectionLine(void)
+{
+    if (m_processingType == PROCESSING_REGION_DETECTION_LINE)
+    {
+        m_regionDetection->setHough(m_regionDetection->getNumberAngles(), m_regionDetectionNumberLines);
+        m_regionDetection->computeDetectionRegion(DETECTION_REGION_LINE);
+
+        m_labelImage->setPixmap(QPixmap::fromImage(*m_regionDetection->getImageTreated()));
+        setWindowTitle(tr("Line detection"));
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the image after a segment detection (probabilistic Hough transform)
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::displayRegionDetectionSegment(void)
+{
+    if (m_processingType == PROCESSING_REGION_DETECTION_SEGMENT)
+    {
+        m_regionDetection->setHough(m_regionDetection->getNumberAngles(), m_regionDetectionNumberLines);
+        m_regionDetection->setTimeBudget(m_regionDetectionTimeBudget);
+        m_regionDetection->computeDetectionRegion(DETECTION_REGION_SEGMENT);
+
+        m_labelImage->setPixmap(QPixmap::fromImage(*m_regionDetection->getImageTreated()));
+        setWindowTitle(tr("Segment detection"));
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the image after a circle detection (gradient Hough transform)
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::displayRegionDetectionCircle(void)
+{
+    if (m_processingType == PROCESSING_REGION_DETECTION_CIRCLE)
+    {
+        m_regionDetection->setCircleParameters(m_regionDetection->getMinRadius(), m_regionDetectionMaxRadius, m_regionDetectionNumberCircles);
+        m_regionDetection->computeDetectionRegion(DETECTION_REGION_CIRCLE);
+
+        m_labelImage->setPixmap(QPixmap::fromImage(*m_regionDetection->getImageTreated()));
+        setWindowTitle(tr("Circle detection"));
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the image after a connected component labeling
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::displayRegionDetectionComponent(void)
+{
+    if (m_processingType == PROCESSING_REGION_DETECTION_COMPONENT)
+    {
+        m_regionDetection->setConnectedness(m_regionDetectionConnectedness);
+        m_regionDetection->computeDetectionRegion(DETECTION_REGION_COMPONENT);
+
+        m_labelImage->setPixmap(QPixmap::fromImage(*m_regionDetection->getImageTreated()));
+        setWindowTitle(tr("Connected components"));
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the image after a watershed from the regional minima of the gradient
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::displayRegionDetectionWatershedMinima(void)
+{
+    if (m_processingType == PROCESSING_REGION_DETECTION_WATERSHED_MINIMA)
+    {
+        m_regionDetection->setConnectedness(m_regionDetectionConnectedness);
+        m_regionDetection->computeDetectionRegion(DETECTION_REGION_WATERSHED_MINIMA);
+
+        m_labelImage->setPixmap(QPixmap::fromImage(*m_regionDetection->getImageTreated()));
+        setWindowTitle(tr("Watershed (minima)"));
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the image after a watershed from the connected components of the
+//! binarized image
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::displayRegionDetectionWatershedMarkers(void)
+{
+    if (m_processingType == PROCESSING_REGION_DETECTION_WATERSHED_MARKERS)
+    {
+        m_regionDetection->setConnectedness(m_regionDetectionConnectedness);
+        m_regionDetection->computeDetectionRegion(DETECTION_REGION_WATERSHED_MARKERS);
+
+        m_labelImage->setPixmap(QPixmap::fromImage(*m_regionDetection->getImageTreated()));
+        setWindowTitle(tr("Watershed (markers)"));
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the image after a line segment detection (LSD)
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::displayRegionDetectionSegmentLSD(void)
+{
+    if (m_processingType == PROCESSING_REGION_DETECTION_SEGMENT_LSD)
+    {
+        m_regionDetection->computeDetectionRegion(DETECTION_REGION_SEGMENT_LSD);
+
+        m_labelImage->setPixmap(QPixmap::fromImage(*m_regionDetection->getImageTreated()));
+        setWindowTitle(tr("Segment detection (LSD)"));
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the image after a contour tracing
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::displayRegionDetectionContour(void)
+{
+    if (m_processingType == PROCESSING_REGION_DETECTION_CONTOUR)
+    {
+        m_regionDetection->computeDetectionRegion(DETECTION_REGION_CONTOUR);
+
+        m_labelImage->setPixmap(QPixmap::fromImage(*m_regionDetection->getImageTreated()));
+        setWindowTitle(tr("Contour tracing"));
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//! Display the superpixels of the image (SLIC)
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::displayRegionDetectionSuperpixel(void)
+{
+    if (m_processingType == PROCESSING_REGION_DETECTION_SUPERPIXEL)
+    {
+        m_regionDetection->setSuperpixelParameters(m_regionDetectionNumberSuperpixels, m_regionDetectionCompactness);
+        m_regionDetection->computeDetectionRegion(DETECTION_REGION_SUPERPIXEL);
+
+        m_labelImage->setPixmap(QPixmap::fromImage(*m_regionDetection->getImageTreated()));
+        setWindowTitle(tr("Superpixels (SLIC)"));
+    }
+}
+
+//------------------------------------------------------------------------------
+// Private Method(s):
+
+//------------------------------------------------------------------------------
+//! Initialization of the "Color Model" treatment
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+bool CTreatedImageWindow::initColorModel(void)
+{
+    bool ret = false;
+
+    m_vboxLayout = new QVBoxLayout;
+    m_labelImage = new QLabel(this);
+    m_colorModel = new CColorModel(m_imageOrigin);
+
+    if (m_vboxLayout && m_labelImage && m_colorModel)
+    {
+        ret = true;
+
+        m_vboxLayout->addWidget(m_labelImage);
+        setLayout(m_vboxLayout);
+        show();
+    }
+
+    return ret;
+}
+
+
+//------------------------------------------------------------------------------
+//! Initialization of the "Quantisation" treatment
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+bool CTreatedImageWindow::initQuantisation(void)
+{
+    bool ret = false;
+
+    m_vboxLayout        = new QVBoxLayout;
+    m_hboxLayout        = new QHBoxLayout;
+    m_labelImage        = new QLabel(this);
+    m_levelText         = new QLineEdit(tr("Quantisation level:"));
+    m_levelChoice       = new QSpinBox();
+    m_quantisation      = new CQuantisation(m_imageOrigin);
+    m_quantisationLevel = 1;
+
+    if (m_vboxLayout && m_hboxLayout && m_labelImage && m_levelText && m_levelChoice && m_quantisation)
+    {
+        ret = true;
+
+        m_levelText->setReadOnly(true);
+        m_levelChoice->setRange(1, 8);
+        m_levelChoice->setValue(m_quantisationLevel);
+
+        connect(m_levelChoice, SIGNAL(valueChanged(int)), this, SLOT(updateQuantisationLevel(int)));
+
+        m_hboxLayout->addWidget(m_levelText);
+        m_hboxLayout->addWidget(m_levelChoice);
+        m_vboxLayout->addLayout(m_hboxLayout);
+        m_vboxLayout->addWidget(m_labelImage);
+        setLayout(m_vboxLayout);
+        show();
+    }
+
+    return ret;
+}
+
+
+//------------------------------------------------------------------------------
+//! Initialization of the "Sampling" treatment
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+bool CTreatedImageWindow::initSampling(void)
+{
+    bool ret = false;
+
+    m_vboxLayout = new QVBoxLayout;
+    m_labelImage = new QLabel(this);
+    m_sampling   = new CSampling(m_imageOrigin);
+
+    if (m_vboxLayout && m_labelImage && m_sampling)
+    {
+        ret = true;
+
+        m_vboxLayout->addWidget(m_labelImage);
+        setLayout(m_vboxLayout);
+        show();
+    }
+
+    return ret;
+}
+
+
+//------------------------------------------------------------------------------
+//! Initialization of the "Geometric Transformation" treatment
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+bool CTreatedImageWindow::initGeometricTransformation(void)
+{
+    bool ret = false;
+
+    m_hboxLayout              = new QHBoxLayout;
+    m_vboxLayout              = new QVBoxLayout;
+    m_gridLayout              = new QGridLayout;
+    m_labelImage              = new QLabel(this);
+    m_parameterLabel1         = new QLabel(this);
+    m_parameterLabel2         = new QLabel(this);
+    m_parameterValue1         = new QSpinBox();
+    m_parameterValue2         = new QSpinBox();
+    m_geometricTransformation = new CGeometricTransformation(m_imageOrigin);
+
+    if (m_hboxLayout &&
+        m_vboxLayout &&
+        m_gridLayout &&
+        m_labelImage &&
+        m_parameterLabel1 &&
+        m_parameterLabel2 &&
+        m_parameterValue1 &&
+        m_parameterValue2 &&
+        m_geometricTransformation)
+    {
+        ret = true;
+
+        switch (m_processingType)
+        {
+            case PROCESSING_GEOMETRIC_TRANSFORMATION_ROTATION:
+                m_nParameters   = 1;
+                m_rotationAngle = 0;
+
+                m_parameterLabel1->setText(tr("Rotation angle:"));
+                m_parameterValue1->setRange(0, 360);
+                m_parameterValue1->setValue(m_rotationAngle);
+
+                connect(m_parameterValue1, SIGNAL(valueChanged(int)), this, SLOT(updateAngleRotation(int)));
+                break;
+
+            case PROCESSING_GEOMETRIC_TRANSFORMATION_SCALE:
+                m_nParameters = 1;
+                m_scaleFactor = 100;
+                m_parameterLabel1->setText(tr("Scale factor:"));
+                m_parameterValue1->setRange(1, 200);
+                m_parameterValue1->setValue(m_scaleFactor);
+
+                connect(m_parameterValue1, SIGNAL(valueChanged(int)), this, SLOT(updateScaleFactor(int)));
+                break;
+
+            case PROCESSING_GEOMETRIC_TRANSFORMATION_SHEAR:
+                m_nParameters  = 2;
+                m_shearFactorX = 0;
+                m_shearFactorY = 0;
+
+                m_parameterLabel1->setText(tr("Shearing factor by X:"));
+                m_parameterLabel2->setText(tr("Shearing factor by Y:"));
+                m_parameterValue1->setRange(0, 100);
+                m_parameterValue2->setRange(0, 100);
+                m_parameterValue1->setValue(m_shearFactorX);
+                m_parameterValue2->setValue(m_shearFactorY);
+
+                connect(m_parameterValue1, SIGNAL(valueChanged(int)), this, SLOT(updateShearFactorX(int)));
+                connect(m_parameterValue2, SIGNAL(valueChanged(int)), this, SLOT(updateShearFactorY(int)));
+                break;
+
+            default:
+                m_nParameters = 0;
+                break;
+        }
+
+        if (m_nParameters >= 1)
+        {
+            m_hboxLayout->addWidget(m_parameterLabel1);
+            m_hboxLayout->addWidget(m_parameterValue1);
+        }
+        if (m_nParameters >= 2)
+        {
+            m_hboxLayout->addWidget(m_parameterLabel2);
+            m_hboxLayout->addWidget(m_parameterValue2);
+        }
+        m_vboxLayout->addLayout(m_hboxLayout);
+        m_vboxLayout->addWidget(m_labelImage);
+        this->setLayout(m_vboxLayout);
+
+        show();
+    }
+
+    return ret;
+}
+
+
+//------------------------------------------------------------------------------
+//! Initialization of the "Edge Detection" treatment
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+bool CTreatedImageWindow::initEdgeDetection(void)
+{
+    bool ret = false;
 
     m_hboxLayout           = new QHBoxLayout;
     m_vboxLayout           = new QVBoxLayout;
@@ -1161,6 +1683,8 @@ bool CTreatedImageWindow::initOpMorphoMaths(void)
     m_labelImage      = new QLabel(this);
     m_parameterLabel1 = new QLabel(tr("Dimension:"));
     m_parameterValue1 = new QSpinBox();
+    m_checkbox1       = new QCheckBox();
+    m_labelCheckbox1  = new QLabel(tr("Grayscale"));
     m_opMorphoMaths   = new COpMorphoMaths(m_imageOrigin);
 
     if (m_hboxLayout &&
@@ -1169,18 +1693,111 @@ bool CTreatedImageWindow::initOpMorphoMaths(void)
         m_labelImage &&
         m_parameterLabel1 &&
         m_parameterValue1 &&
+        m_checkbox1 &&
+        m_labelCheckbox1 &&
         m_opMorphoMaths)
     {
         ret = true;
 
         m_opMorphoMathsDimension = m_opMorphoMaths->getDimension();
+        m_opMorphoMathsArea      = m_opMorphoMaths->getArea();
+
+        m_opMorphoMathsAttribute          = m_opMorphoMaths->getAttribute();
+        m_opMorphoMathsAttributeThreshold = m_opMorphoMaths->getAttributeThreshold();
+
+        m_opMorphoMathsLineAngle          = m_opMorphoMaths->getLineAngle();
+        m_opMorphoMathsNumberOrientations = m_opMorphoMaths->getNumberOrientations();
+        m_opMorphoMathsPercentile         = m_opMorphoMaths->getPercentile();
 
         m_parameterValue1->setRange(0, 100);
         m_parameterValue1->setValue(m_opMorphoMathsDimension);
         connect(m_parameterValue1, SIGNAL(valueChanged(int)), this, SLOT(updateOpMorphoMathsDimension(int)));
 
-        m_hboxLayout->addWidget(m_parameterLabel1);
-        m_hboxLayout->addWidget(m_parameterValue1);
+        m_checkbox1->setChecked(m_opMorphoMaths->isGrayscale());
+        connect(m_checkbox1, SIGNAL(stateChanged(int)), this, SLOT(updateOpMorphoMathsIsGrayscale(int)));
+
+        m_hboxLayout->addWidget(m_parameterLabel1);
+        m_hboxLayout->addWidget(m_parameterValue1);
+        m_hboxLayout->addWidget(m_labelCheckbox1);
+        m_hboxLayout->addWidget(m_checkbox1);
+
+        switch (m_processingType)
+        {
+            case PROCESSING_OP_MORPHO_MATHS_DILATION:
+            case PROCESSING_OP_MORPHO_MATHS_EROSION:
+            case PROCESSING_OP_MORPHO_MATHS_OPENING:
+            case PROCESSING_OP_MORPHO_MATHS_CLOSING:
+                m_checkbox2      = new QCheckBox();
+                m_labelCheckbox2 = new QLabel(tr("Run-length"));
+                m_checkbox2->setChecked(m_opMorphoMaths->isRunLength());
+                connect(m_checkbox2, SIGNAL(stateChanged(int)), this, SLOT(updateOpMorphoMathsIsRunLength(int)));
+                m_hboxLayout->addWidget(m_labelCheckbox2);
+                m_hboxLayout->addWidget(m_checkbox2);
+                break;
+
+            case PROCESSING_OP_MORPHO_MATHS_AREA_OPENING:
+            case PROCESSING_OP_MORPHO_MATHS_AREA_CLOSING:
+                m_parameterLabel2 = new QLabel(tr("Area:"));
+                m_parameterValue2 = new QSpinBox();
+                m_parameterValue2->setRange(1, 100000);
+                m_parameterValue2->setValue(m_opMorphoMathsArea);
+                connect(m_parameterValue2, SIGNAL(valueChanged(int)), this, SLOT(updateOpMorphoMathsArea(int)));
+                m_hboxLayout->addWidget(m_parameterLabel2);
+                m_hboxLayout->addWidget(m_parameterValue2);
+                break;
+
+            case PROCESSING_OP_MORPHO_MATHS_ATTRIBUTE_OPENING:
+            case PROCESSING_OP_MORPHO_MATHS_ATTRIBUTE_CLOSING:
+                m_attributeChoice = new QComboBox();
+                m_attributeChoice->addItem(tr("Area"), MAXTREE_ATTRIBUTE_AREA);
+                m_attributeChoice->addItem(tr("Contrast"), MAXTREE_ATTRIBUTE_CONTRAST);
+                m_attributeChoice->addItem(tr("Box size"), MAXTREE_ATTRIBUTE_BOX_SIZE);
+                m_attributeChoice->addItem(tr("Elongation (%)"), MAXTREE_ATTRIBUTE_ELONGATION);
+                m_attributeChoice->setCurrentIndex(m_attributeChoice->findData(m_opMorphoMathsAttribute));
+                connect(m_attributeChoice, SIGNAL(currentIndexChanged(int)), this, SLOT(updateOpMorphoMathsAttribute(int)));
+                m_parameterLabel2 = new QLabel(tr("Threshold:"));
+                m_parameterValue2 = new QSpinBox();
+                m_parameterValue2->setRange(0, 100000);
+                m_parameterValue2->setValue(m_opMorphoMathsAttributeThreshold);
+                connect(m_parameterValue2, SIGNAL(valueChanged(int)), this, SLOT(updateOpMorphoMathsAttributeThreshold(int)));
+                m_hboxLayout->addWidget(m_attributeChoice);
+                m_hboxLayout->addWidget(m_parameterLabel2);
+                m_hboxLayout->addWidget(m_parameterValue2);
+                break;
+
+            case PROCESSING_OP_MORPHO_MATHS_LINE_OPENING:
+                m_parameterLabel2 = new QLabel(tr("Angle:"));
+                m_parameterValue2 = new QSpinBox();
+                m_parameterValue2->setRange(0, 179);
+                m_parameterValue2->setValue(m_opMorphoMathsLineAngle);
+                connect(m_parameterValue2, SIGNAL(valueChanged(int)), this, SLOT(updateOpMorphoMathsLineAngle(int)));
+                m_hboxLayout->addWidget(m_parameterLabel2);
+                m_hboxLayout->addWidget(m_parameterValue2);
+                break;
+
+            case PROCESSING_OP_MORPHO_MATHS_LINE_OPENING_BANK:
+                m_parameterLabel2 = new QLabel(tr("Orientations:"));
+                m_parameterValue2 = new QSpinBox();
+                m_parameterValue2->setRange(1, 180);
+                m_parameterValue2->setValue(m_opMorphoMathsNumberOrientations);
+                connect(m_parameterValue2, SIGNAL(valueChanged(int)), this, SLOT(updateOpMorphoMathsNumberOrientations(int)));
+                m_hboxLayout->addWidget(m_parameterLabel2);
+                m_hboxLayout->addWidget(m_parameterValue2);
+                break;
+
+            case PROCESSING_OP_MORPHO_MATHS_RANK_FILTER:
+                m_parameterLabel2 = new QLabel(tr("Percentile:"));
+                m_parameterValue2 = new QSpinBox();
+                m_parameterValue2->setRange(0, 100);
+                m_parameterValue2->setValue(m_opMorphoMathsPercentile);
+                connect(m_parameterValue2, SIGNAL(valueChanged(int)), this, SLOT(updateOpMorphoMathsPercentile(int)));
+                m_hboxLayout->addWidget(m_parameterLabel2);
+                m_hboxLayout->addWidget(m_parameterValue2);
+                break;
+
+            default:
+                break;
+        }
 
         m_vboxLayout->addLayout(m_hboxLayout);
         m_vboxLayout->addWidget(m_labelImage);
@@ -1204,14 +1821,129 @@ bool CTreatedImageWindow::initRegionDetection(void)
 {
     bool ret = false;
 
+    m_hboxLayout      = new QHBoxLayout;
     m_vboxLayout      = new QVBoxLayout;
     m_labelImage      = new QLabel(this);
+    m_parameterLabel1 = new QLabel(tr("Lines:"));
+    m_parameterValue1 = new QSpinBox();
     m_regionDetection = new CRegionDetection(m_imageOrigin);
 
-    if (m_vboxLayout && m_labelImage && m_regionDetection)
+    if (m_hboxLayout &&
+        m_vboxLayout &&
+        m_labelImage &&
+        m_parameterLabel1 &&
+        m_parameterValue1 &&
+        m_regionDetection)
     {
         ret = true;
 
+        m_regionDetectionNumberLines       = m_regionDetection->getNumberLines();
+        m_regionDetectionTimeBudget        = m_regionDetection->getTimeBudget();
+        m_regionDetectionNumberCircles     = m_regionDetection->getNumberCircles();
+        m_regionDetectionMaxRadius         = m_regionDetection->getMaxRadius();
+        m_regionDetectionConnectedness     = m_regionDetection->getConnectedness();
+        m_regionDetectionNumberSuperpixels = m_regionDetection->getNumberSuperpixels();
+        m_regionDetectionCompactness       = m_regionDetection->getCompactness();
+
+        m_parameterValue1->setRange(1, 100);
+        if (m_processingType == PROCESSING_REGION_DETECTION_CIRCLE)
+        {
+            m_parameterLabel1->setText(tr("Circles:"));
+            m_parameterValue1->setValue(m_regionDetectionNumberCircles);
+            connect(m_parameterValue1, SIGNAL(valueChanged(int)), this, SLOT(updateRegionDetectionNumberCircles(int)));
+        }
+        else if ((m_processingType == PROCESSING_REGION_DETECTION_COMPONENT) ||
+                 (m_processingType == PROCESSING_REGION_DETECTION_WATERSHED_MINIMA) ||
+                 (m_processingType == PROCESSING_REGION_DETECTION_WATERSHED_MARKERS))
+        {
+            m_parameterLabel1->setText(tr("Connectedness:"));
+            m_parameterValue1->setRange(4, 8);
+            m_parameterValue1->setSingleStep(4);
+            m_parameterValue1->setValue(m_regionDetectionConnectedness);
+            connect(m_parameterValue1, SIGNAL(valueChanged(int)), this, SLOT(updateRegionDetectionConnectedness(int)));
+        }
+        else if (m_processingType == PROCESSING_REGION_DETECTION_SUPERPIXEL)
+        {
+            m_parameterLabel1->setText(tr("Superpixels:"));
+            m_parameterValue1->setRange(1, 100000);
+            m_parameterValue1->setValue(m_regionDetectionNumberSuperpixels);
+            connect(m_parameterValue1, SIGNAL(valueChanged(int)), this, SLOT(updateRegionDetectionNumberSuperpixels(int)));
+        }
+        else
+        {
+            m_parameterValue1->setValue(m_regionDetectionNumberLines);
+            connect(m_parameterValue1, SIGNAL(valueChanged(int)), this, SLOT(updateRegionDetectionNumberLines(int)));
+        }
+
+        if ((m_processingType != PROCESSING_REGION_DETECTION_SEGMENT_LSD) &&
+            (m_processingType != PROCESSING_REGION_DETECTION_CONTOUR))
+        {
+            m_hboxLayout->addWidget(m_parameterLabel1);
+            m_hboxLayout->addWidget(m_parameterValue1);
+        }
+
+        if ((m_processingType == PROCESSING_REGION_DETECTION_WATERSHED_MINIMA) ||
+            (m_processingType == PROCESSING_REGION_DETECTION_WATERSHED_MARKERS))
+        {
+            m_checkbox1      = new QCheckBox();
+            m_labelCheckbox1 = new QLabel(tr("Gradient image"));
+            m_checkbox1->setChecked(m_regionDetection->isGradientImage());
+            connect(m_checkbox1, SIGNAL(stateChanged(int)), this, SLOT(updateRegionDetectionIsGradientImage(int)));
+            m_hboxLayout->addWidget(m_labelCheckbox1);
+            m_hboxLayout->addWidget(m_checkbox1);
+        }
+
+        if (m_processingType == PROCESSING_REGION_DETECTION_LINE)
+        {
+            m_checkbox1      = new QCheckBox();
+            m_labelCheckbox1 = new QLabel(tr("Multiresolution"));
+            m_checkbox1->setChecked(m_regionDetection->isMultiresolution());
+            connect(m_checkbox1, SIGNAL(stateChanged(int)), this, SLOT(updateRegionDetectionIsMultiresolution(int)));
+            m_hboxLayout->addWidget(m_labelCheckbox1);
+            m_hboxLayout->addWidget(m_checkbox1);
+        }
+
+        if (m_processingType == PROCESSING_REGION_DETECTION_SEGMENT)
+        {
+            m_parameterLabel2 = new QLabel(tr("Time budget (ms):"));
+            m_parameterValue2 = new QSpinBox();
+            m_parameterValue2->setRange(1, 10000);
+            m_parameterValue2->setValue(m_regionDetectionTimeBudget);
+            connect(m_parameterValue2, SIGNAL(valueChanged(int)), this, SLOT(updateRegionDetectionTimeBudget(int)));
+            m_hboxLayout->addWidget(m_parameterLabel2);
+            m_hboxLayout->addWidget(m_parameterValue2);
+        }
+
+        if (m_processingType == PROCESSING_REGION_DETECTION_CIRCLE)
+        {
+            m_parameterLabel2 = new QLabel(tr("Max radius:"));
+            m_parameterValue2 = new QSpinBox();
+            m_parameterValue2->setRange(m_regionDetection->getMinRadius(), 1000);
+            m_parameterValue2->setValue(m_regionDetectionMaxRadius);
+            connect(m_parameterValue2, SIGNAL(valueChanged(int)), this, SLOT(updateRegionDetectionMaxRadius(int)));
+            m_hboxLayout->addWidget(m_parameterLabel2);
+            m_hboxLayout->addWidget(m_parameterValue2);
+        }
+
+        if (m_processingType == PROCESSING_REGION_DETECTION_SUPERPIXEL)
+        {
+            m_parameterLabel2 = new QLabel(tr("Compactness:"));
+            m_parameterValue2 = new QSpinBox();
+            m_parameterValue2->setRange(1, 100);
+            m_parameterValue2->setValue(m_regionDetectionCompactness);
+            connect(m_parameterValue2, SIGNAL(valueChanged(int)), this, SLOT(updateRegionDetectionCompactness(int)));
+            m_hboxLayout->addWidget(m_parameterLabel2);
+            m_hboxLayout->addWidget(m_parameterValue2);
+        }
+
+        if (m_processingType == PROCESSING_REGION_DETECTION_CONTOUR)
+        {
+            m_saveButton = new QPushButton(tr("Save..."));
+            connect(m_saveButton, SIGNAL(clicked()), this, SLOT(saveRegionDetectionContours()));
+            m_hboxLayout->addWidget(m_saveButton);
+        }
+
+        m_vboxLayout->addLayout(m_hboxLayout);
         m_vboxLayout->addWidget(m_labelImage);
         setLayout(m_vboxLayout);
         show();
@@ -1390,3 +2122,282 @@ void CTreatedImageWindow::updateOpMorphoMathsDimension(int dimension)
 
     display();
 }
+
+
+//------------------------------------------------------------------------------
+//! Update the grayscale flag ("Morpho Mathematics" treatment)
+//!
+//! @param isGrayscale The grayscale flag
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::updateOpMorphoMathsIsGrayscale(int isGrayscale)
+{
+    if (m_opMorphoMaths)
+        m_opMorphoMaths->setGrayscale(isGrayscale != 0);
+
+    display();
+}
+
+
+//------------------------------------------------------------------------------
+//! Update the run-length flag ("Morpho Mathematics" treatment)
+//!
+//! @param isRunLength The run-length flag
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::updateOpMorphoMathsIsRunLength(int isRunLength)
+{
+    if (m_opMorphoMaths)
+        m_opMorphoMaths->setRunLength(isRunLength != 0);
+
+    display();
+}
+
+
+//------------------------------------------------------------------------------
+//! Update the area threshold ("Morpho Mathematics" treatment)
+//!
+//! @param area The area (in pixels)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::updateOpMorphoMathsArea(int area)
+{
+    m_opMorphoMathsArea = area;
+
+    display();
+}
+
+
+//------------------------------------------------------------------------------
+//! Update the attribute ("Morpho Mathematics" treatment)
+//!
+//! @param index The index of the attribute in the list
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::updateOpMorphoMathsAttribute(int index)
+{
+    m_opMorphoMathsAttribute = m_attributeChoice->itemData(index).toInt();
+
+    display();
+}
+
+
+//------------------------------------------------------------------------------
+//! Update the attribute threshold ("Morpho Mathematics" treatment)
+//!
+//! @param threshold The threshold
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::updateOpMorphoMathsAttributeThreshold(int threshold)
+{
+    m_opMorphoMathsAttributeThreshold = threshold;
+
+    display();
+}
+
+
+//------------------------------------------------------------------------------
+//! Update the angle of the line ("Morpho Mathematics" treatment)
+//!
+//! @param angle The angle (in degrees)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::updateOpMorphoMathsLineAngle(int angle)
+{
+    m_opMorphoMathsLineAngle = angle;
+
+    display();
+}
+
+
+//------------------------------------------------------------------------------
+//! Update the number of orientations of the lines ("Morpho Mathematics"
+//! treatment)
+//!
+//! @param nOrientations The number of orientations
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::updateOpMorphoMathsNumberOrientations(int nOrientations)
+{
+    m_opMorphoMathsNumberOrientations = nOrientations;
+
+    display();
+}
+
+
+//------------------------------------------------------------------------------
+//! Update the percentile of the rank filter ("Morpho Mathematics" treatment)
+//!
+//! @param percentile The percentile
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::updateOpMorphoMathsPercentile(int percentile)
+{
+    m_opMorphoMathsPercentile = percentile;
+
+    display();
+}
+
+
+//------------------------------------------------------------------------------
+//! Update the number of lines to find ("Region Detection" treatment)
+//!
+//! @param nLines The number of lines
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::updateRegionDetectionNumberLines(int nLines)
+{
+    m_regionDetectionNumberLines = nLines;
+
+    display();
+}
+
+
+//------------------------------------------------------------------------------
+//! Update the time budget of the segment detection ("Region Detection"
+//! treatment)
+//!
+//! @param timeBudget The time budget (in milliseconds)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::updateRegionDetectionTimeBudget(int timeBudget)
+{
+    m_regionDetectionTimeBudget = timeBudget;
+
+    display();
+}
+
+
+//------------------------------------------------------------------------------
+//! Update the multiresolution flag of the line detection ("Region Detection"
+//! treatment)
+//!
+//! @param isMultiresolution The multiresolution flag
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::updateRegionDetectionIsMultiresolution(int isMultiresolution)
+{
+    if (m_regionDetection)
+        m_regionDetection->setMultiresolution(isMultiresolution != 0);
+
+    display();
+}
+
+
+//------------------------------------------------------------------------------
+//! Update the number of circles to find ("Region Detection" treatment)
+//!
+//! @param nCircles The number of circles
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::updateRegionDetectionNumberCircles(int nCircles)
+{
+    m_regionDetectionNumberCircles = nCircles;
+
+    display();
+}
+
+
+//------------------------------------------------------------------------------
+//! Update the maximal radius of the circles ("Region Detection" treatment)
+//!
+//! @param radius The maximal radius (in pixels)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::updateRegionDetectionMaxRadius(int radius)
+{
+    m_regionDetectionMaxRadius = radius;
+
+    display();
+}
+
+
+//------------------------------------------------------------------------------
+//! Update the connectedness of the labeling ("Region Detection" treatment)
+//!
+//! @param connectedness The connectedness (4 or 8)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::updateRegionDetectionConnectedness(int connectedness)
+{
+    m_regionDetectionConnectedness = connectedness;
+
+    display();
+}
+
+
+//------------------------------------------------------------------------------
+//! Update the number of superpixels wanted ("Region Detection" treatment)
+//!
+//! @param nSuperpixels The number of superpixels
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::updateRegionDetectionNumberSuperpixels(int nSuperpixels)
+{
+    m_regionDetectionNumberSuperpixels = nSuperpixels;
+
+    display();
+}
+
+
+//------------------------------------------------------------------------------
+//! Update the compactness of the superpixels ("Region Detection" treatment)
+//!
+//! @param compactness The compactness (weight of the distance in the image)
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::updateRegionDetectionCompactness(int compactness)
+{
+    m_regionDetectionCompactness = compactness;
+
+    display();
+}
+
+
+//------------------------------------------------------------------------------
+//! Update the gradient image flag of the watershed ("Region Detection"
+//! treatment)
+//!
+//! @param isGradientImage The gradient image flag
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::updateRegionDetectionIsGradientImage(int isGradientImage)
+{
+    if (m_regionDetection)
+        m_regionDetection->setGradientImage(isGradientImage != 0);
+
+    display();
+}
+
+
+//------------------------------------------------------------------------------
+//! Save the contours in a compact binary file ("Region Detection" treatment)
+//!
+//! @param _
+//!
+//! @return _
+//------------------------------------------------------------------------------
+void CTreatedImageWindow::saveRegionDetectionContours(void)
+{
+    QString filename = QFileDialog::getSaveFileName(this, tr("Save the contours"), QString(), tr("Contours (*.ctr)"));
+
+    if (!filename.isEmpty() && m_regionDetection && !m_regionDetection->saveContours(filename))
+        QMessageBox::critical(this, tr(""), tr("Unable to save the contours"));
+}
@@ -12,11 +12,13 @@
 // Include(s) :
 
 #include <QCheckBox>
+#include <QComboBox>
 #include <QGridLayout>
 #include <QHBoxLayout>
 #include <QImage>
 #include <QLabel>
 #include <QLineEdit>
+#include <QPushButton>
 #include <QSlider>
 #include <QSpinBox>
 #include <QVBoxLayout>
@@ -67,7 +69,28 @@ enum
     PROCESSING_OP_MORPHO_MATHS_HIT_OR_MISS,
     PROCESSING_OP_MORPHO_MATHS_THINNING,
     PROCESSING_OP_MORPHO_MATHS_SKELETONIZING,
-    PROCESSING_REGION_DETECTION_LINE
+    PROCESSING_OP_MORPHO_MATHS_OPENING_BY_RECONSTRUCTION,
+    PROCESSING_OP_MORPHO_MATHS_HOLE_FILLING,
+    PROCESSING_OP_MORPHO_MATHS_REGIONAL_MAXIMA,
+    PROCESSING_OP_MORPHO_MATHS_AREA_OPENING,
+    PROCESSING_OP_MORPHO_MATHS_AREA_CLOSING,
+    PROCESSING_OP_MORPHO_MATHS_ATTRIBUTE_OPENING,
+    PROCESSING_OP_MORPHO_MATHS_ATTRIBUTE_CLOSING,
+    PROCESSING_OP_MORPHO_MATHS_GRANULOMETRY,
+    PROCESSING_OP_MORPHO_MATHS_TOP_HAT,
+    PROCESSING_OP_MORPHO_MATHS_BOTTOM_HAT,
+    PROCESSING_OP_MORPHO_MATHS_LINE_OPENING,
+    PROCESSING_OP_MORPHO_MATHS_LINE_OPENING_BANK,
+    PROCESSING_OP_MORPHO_MATHS_RANK_FILTER,
+    PROCESSING_REGION_DETECTION_LINE,
+    PROCESSING_REGION_DETECTION_SEGMENT,
+    PROCESSING_REGION_DETECTION_CIRCLE,
+    PROCESSING_REGION_DETECTION_COMPONENT,
+    PROCESSING_REGION_DETECTION_WATERSHED_MINIMA,
+    PROCESSING_REGION_DETECTION_WATERSHED_MARKERS,
+    PROCESSING_REGION_DETECTION_SEGMENT_LSD,
+    PROCESSING_REGION_DETECTION_CONTOUR,
+    PROCESSING_REGION_DETECTION_SUPERPIXEL
 };
 
 
@@ -111,7 +134,28 @@ public:
     void displayOpMorphoMathsHitOrMiss(void);
     void displayOpMorphoMathsThinning(void);
     void displayOpMorphoMathsSkeletonizing(void);
+    void displayOpMorphoMathsOpeningByReconstruction(void);
+    void displayOpMorphoMathsHoleFilling(void);
+    void displayOpMorphoMathsRegionalMaxima(void);
+    void displayOpMorphoMathsAreaOpening(void);
+    void displayOpMorphoMathsAreaClosing(void);
+    void displayOpMorphoMathsAttributeOpening(void);
+    void displayOpMorphoMathsAttributeClosing(void);
+    void displayOpMorphoMathsGranulometry(void);
+    void displayOpMorphoMathsTopHat(void);
+    void displayOpMorphoMathsBottomHat(void);
+    void displayOpMorphoMathsLineOpening(void);
+    void displayOpMorphoMathsLineOpeningBank(void);
+    void displayOpMorphoMathsRankFilter(void);
     void displayRegionDetectionLine(void);
+    void displayRegionDetectionSegment(void);
+    void displayRegionDetectionCircle(void);
+    void displayRegionDetectionComponent(void);
+    void displayRegionDetectionWatershedMinima(void);
+    void displayRegionDetectionWatershedMarkers(void);
+    void displayRegionDetectionSegmentLSD(void);
+    void displayRegionDetectionContour(void);
+    void displayRegionDetectionSuperpixel(void);
 
 private:
     int m_processingType;
@@ -133,7 +177,9 @@ private:
     QCheckBox *  m_checkbox1;
     QLabel *     m_labelCheckbox1;
     QCheckBox *  m_checkbox2;
+    QComboBox *  m_attributeChoice;
     QLabel *     m_labelCheckbox2;
+    QPushButton *m_saveButton;
     QLabel *     m_labelImage;
     QImage *     m_imageOrigin;
     QImage *     m_imageTreated;
@@ -156,6 +202,19 @@ private:
     int  m_thresholdMax;
     int  m_alphaDeriche;
     int  m_opMorphoMathsDimension;
+    int  m_opMorphoMathsArea;
+    int  m_opMorphoMathsAttribute;
+    int  m_opMorphoMathsAttributeThreshold;
+    int  m_opMorphoMathsLineAngle;
+    int  m_opMorphoMathsNumberOrientations;
+    int  m_opMorphoMathsPercentile;
+    int  m_regionDetectionNumberLines;
+    int  m_regionDetectionTimeBudget;
+    int  m_regionDetectionNumberCircles;
+    int  m_regionDetectionMaxRadius;
+    int  m_regionDetectionConnectedness;
+    int  m_regionDetectionNumberSuperpixels;
+    int  m_regionDetectionCompactness;
 
     bool initColorModel(void);
     bool initQuantisation(void);
@@ -178,6 +237,24 @@ public slots:
     void updateThresholdMax(int threshold);
     void updateAlphaDeriche(int alpha);
     void updateOpMorphoMathsDimension(int dimension);
+    void updateOpMorphoMathsIsGrayscale(int isGrayscale);
+    void updateOpMorphoMathsIsRunLength(int isRunLength);
+    void updateOpMorphoMathsArea(int area);
+    void updateOpMorphoMathsAttribute(int index);
+    void updateOpMorphoMathsAttributeThreshold(int threshold);
+    void updateOpMorphoMathsLineAngle(int angle);
+    void updateOpMorphoMathsNumberOrientations(int nOrientations);
+    void updateOpMorphoMathsPercentile(int percentile);
+    void updateRegionDetectionNumberLines(int nLines);
+    void updateRegionDetectionTimeBudget(int timeBudget);
+    void updateRegionDetectionIsMultiresolution(int isMultiresolution);
+    void updateRegionDetectionNumberCircles(int nCircles);
+    void updateRegionDetectionMaxRadius(int radius);
+    void updateRegionDetectionConnectedness(int connectedness);
+    void updateRegionDetectionNumberSuperpixels(int nSuperpixels);
+    void updateRegionDetectionCompactness(int compactness);
+    void updateRegionDetectionIsGradientImage(int isGradientImage);
+    void saveRegionDetectionContours(void);
 };
 
 #endif // TREATED_IMAGE_WINDOW_HEADER
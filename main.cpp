@@ -9,12 +9,15 @@
 // Include(s) :
 
 #include <QApplication>
+#include <QCoreApplication>
 
+#include "Benchmark.h"
 #include "MainWindow.h"
 
 
 //------------------------------------------------------------------------------
-//! Application start point
+//! Application start point ("--benchmark [image]" runs the benchmark of the
+//! parallel treatments instead of the interface)
 //!
 //! @param argc The argument number
 //! @param argv The argument list
@@ -24,6 +27,13 @@
 //------------------------------------------------------------------------------
 int main(int argc, char *argv[])
 {
+    if ((argc >= 2) && (QString(argv[1]) == "--benchmark"))
+    {
+        QCoreApplication application(argc, argv);
+
+        return CBenchmark::run((argc >= 3) ? QString(argv[2]) : QString());
+    }
+
     QApplication application(argc, argv);
     MainWindow   mainWindow;
 